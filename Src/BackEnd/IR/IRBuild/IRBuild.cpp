@@ -1,4 +1,5 @@
 #include <assert.h>
+#include <math.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -7,8 +8,14 @@
 #include "IRBuild.h"
 #include "Tree/NameTable/NameTable.h"
 #include "Tree/Tree.h"
-#include "LabelTable/LabelTable.h"
 #include "Common/Log.h"
+#include "Common/Colors.h"
+
+/// @brief Expressions are evaluated on the register stack XMM0 (bottom) - XMM15
+static const size_t RegStackCapacity = 16;
+
+/// @brief First arguments are passed in XMM0 - XMM7, the rest on the stack. Result is in XMM0
+static const size_t RegParamsCount   = 8;
 
 struct CompilerInfoState
 {
@@ -22,72 +29,116 @@ struct CompilerInfoState
     int        memShift;
     IRRegister regShift;
 
-    size_t numberOfFuncParams;
+    size_t numberOfStackParams;     ///< removed from the stack by RET
+
+    size_t regStackSize;    ///< values of expressions being evaluated, XMM0 is the bottom
 
-    LabelTableType* labelTable;
+    InternId    funcNameId;         ///< function being built
+    IRLabelId   tailCallLabel;      ///< self tail calls jump here, IR_NO_LABEL - no such calls
+
+    bool        hasAccumulator;     ///< returns are accumulated in [RBP + accMemShift]
+    IROperation accOperation;       ///< F_ADD / F_MUL
+    int         accMemShift;
+
+    IRErrors    err;
 };
 
 static inline CompilerInfoState CompilerInfoStateCtor();
 static inline void              CompilerInfoStateDtor(CompilerInfoState* info);
 
 static void     Build               (const TreeNode* node, CompilerInfoState* info);
+static void     BuildStatement      (const TreeNode* node, CompilerInfoState* info);
+static void     BuildExpr           (const TreeNode* node, CompilerInfoState* info);
 static void     BuildNum            (const TreeNode* node, CompilerInfoState* info);
 static void     BuildVar            (const TreeNode* node, CompilerInfoState* info);
+static void     BuildFuncCall       (const TreeNode* node, CompilerInfoState* info);
+static void     BuildRead           (CompilerInfoState* info);
+static void     BuildPow            (const TreeNode* node, CompilerInfoState* info);
 static void     PushFuncCallArgs    (const TreeNode* node, CompilerInfoState* info);
 
 static void     BuildALUOp          (IROperation aluOp, size_t numberOfChildren,
                                      const TreeNode* node, CompilerInfoState* info);
-static void     BuildComparison     (IROperation jccOp,
-                                     const TreeNode* node, CompilerInfoState* info);
-
-static size_t   InitFuncParams      (const TreeNode* node, CompilerInfoState* info);
+static void     BuildComparison     (const TreeNode* node, CompilerInfoState* info);
+static void     BuildCompareOperands(const TreeNode* node, CompilerInfoState* info);
+static void     BuildCondJump       (const TreeNode* node, bool jumpIfTrue, IRLabelId target,
+                                     CompilerInfoState* info);
+
+static void     InitFuncParams      (const TreeNode* node, size_t paramsCount, size_t* paramPos,
+                                     CompilerInfoState* info);
+static void     StoreRegParams      (size_t regParamsCount, CompilerInfoState* info);
+static size_t   CountCommaList      (const TreeNode* node);
 static int      InitFuncLocalVars   (const TreeNode* node, CompilerInfoState* info);
 
+static int      InitTailCalls       (const TreeNode* funcNameNode, CompilerInfoState* info);
+static void     BuildTailCallEntry  (size_t regParamsCount, CompilerInfoState* info);
+static void     BuildReturn         (const TreeNode* node, CompilerInfoState* info);
+static void     BuildTailCall       (const TreeNode* node, CompilerInfoState* info);
+static void     BuildAccumulatorOp  (CompilerInfoState* info);
+static size_t   CountSelfTailCalls  (const TreeNode* node, const CompilerInfoState* info);
+static size_t   CountAccumulatedReturns(const TreeNode* node, TreeOperationId operation,
+                                        const CompilerInfoState* info);
+static bool     IsAccumulatedReturn (const TreeNode* node, TreeOperationId operation,
+                                     const CompilerInfoState* info,
+                                     const TreeNode** selfCall, const TreeNode** accumulated);
+static inline bool IsSelfCall       (const TreeNode* node, const CompilerInfoState* info);
+
 static inline void BuildFuncQuit    (CompilerInfoState* info);
 
-static void PatchJumps(IR* ir, const LabelTableType* labelTable);
+static size_t   RegistersNeed       (const TreeNode* node);
+static bool     OperandsLeftFirst   (const TreeNode* node);
+
+static inline IRRegister RegStackGetReg (size_t pos);
+static inline IRRegister RegStackPush   (CompilerInfoState* info);
+static inline IRRegister RegStackPop    (CompilerInfoState* info);
+static inline IRRegister RegStackTop    (const CompilerInfoState* info);
+
+static size_t   RegStackSave        (CompilerInfoState* info);
+static void     RegStackRestore     (CompilerInfoState* info, size_t savedSize);
+
+static inline bool IsCommutative    (IROperation operation);
+
+static IROperation ComparisonJump   (const TreeNode* node);
+static IROperation InverseJump      (IROperation jccOp);
+static bool        IsBoolExpr       (const TreeNode* node);
+static bool        HasCalls         (const TreeNode* node);
+
+static void PatchJumps(IR* ir);
 
 #define IR_REG(REG_NAME)   IRRegister::REG_NAME  
 #define OP(OP_NAME)        IROperation::OP_NAME
 #define IR_PUSH(NODE)      IRPushBack(info->ir, NODE)
 
-#define LABEL_PUSH(NAME)                                        \
-do                                                              \
-{                                                               \
-    LabelTableValue tmpLabelVal = {};                           \
-    LabelTableValueCtor(&tmpLabelVal, NAME, info->ir->end);     \
-    LabelTablePush(info->labelTable, tmpLabelVal);              \
-} while (0)
-
-#define IR_PUSH_LABEL(NAME)                                     \
+#define IR_PUSH_LABEL(LABEL_ID)                                 \
 do                                                              \
 {                                                               \
-    IRPushBack(info->ir, IRNodeCreate(NAME));                   \
-    LABEL_PUSH(NAME);                                           \
+    IRPushBack(info->ir, IRNodeCreate(LABEL_ID));               \
+    IRLabelBind(info->ir, LABEL_ID, info->ir->end);             \
 } while (0)
 
 
-IR* IRBuild(const Tree* tree)
+IR* IRBuild(const Tree* tree, IRErrors* outErr)
 {
     assert(tree);
+    assert(outErr);
 
     IR* ir = IRCtor();
     
     CompilerInfoState info = CompilerInfoStateCtor();
     info.allNamesTable = tree->allNamesTable;
     info.ir = ir;
-
-    info.labelTable = nullptr;
-    
-    LabelTableCtor(&info.labelTable);
         
-    IRPushBack(ir, IRNodeCreate("_start"));
-    IRPushBack(ir, IRNodeCreate(OP(CALL), IROperandLabelCreate("main"), true));
+    IRLabelId startLabel = IRGetFuncLabel(ir, "_start");
+    IRPushBack(ir, IRNodeCreate(startLabel));
+    IRLabelBind(ir, startLabel, ir->end);
+
+    IRPushBack(ir, IRNodeCreate(OP(CALL), IROperandLabelCreate(IRGetFuncLabel(ir, "main")), true));
     IRPushBack(ir, IRNodeCreate(OP(HLT)));
 
     Build(tree->root, &info);
 
-    PatchJumps(ir, info.labelTable);
+    PatchJumps(ir);
+
+    *outErr = info.err;
 
     CompilerInfoStateDtor(&info);
 
@@ -131,6 +182,39 @@ static void Build(const TreeNode* node, CompilerInfoState* info)
     }
 }
 
+// Both statements and expressions are built by Build(), expression leaves its value on
+// the register stack. Statement's value (if it has one) is dropped.
+static void BuildStatement(const TreeNode* node, CompilerInfoState* info)
+{
+    assert(info);
+
+    size_t regStackSize = info->regStackSize;
+
+    Build(node, info);
+
+    info->regStackSize = regStackSize;
+}
+
+// Pushes value of the expression on the register stack. If expression needs more
+// registers than are free, registers in use wait on the machine stack.
+static void BuildExpr(const TreeNode* node, CompilerInfoState* info)
+{
+    assert(node);
+    assert(info);
+
+    if (info->regStackSize == 0 || info->regStackSize + RegistersNeed(node) <= RegStackCapacity)
+    {
+        Build(node, info);
+        return;
+    }
+
+    size_t savedSize = RegStackSave(info);
+
+    Build(node, info);
+
+    RegStackRestore(info, savedSize);
+}
+
 static void BuildALUOp(IROperation aluOp, size_t numberOfChildren, 
                               const TreeNode* node, CompilerInfoState* info)
 {
@@ -140,54 +224,64 @@ static void BuildALUOp(IROperation aluOp, size_t numberOfChildren,
     assert(info->allNamesTable);
     assert(info->ir);
 
-    IROperand operand1 = IROperandRegCreate(IR_REG(XMM0));
-
     assert(numberOfChildren > 0);
-    Build(node->left, info);
-    
-    if (numberOfChildren == 2)
-    {
-        IROperand operand2 = IROperandRegCreate(IR_REG(XMM1));
 
-        Build(node->right, info);
-        IR_PUSH(IRNodeCreate(OP(F_POP), operand2));
+    if (numberOfChildren == 1)
+    {
+        BuildExpr(node->left, info);
 
-        IR_PUSH(IRNodeCreate(OP(F_POP), operand1));
-        IR_PUSH(IRNodeCreate(aluOp, operand1, operand2));
+        IR_PUSH(IRNodeCreate(aluOp, IROperandRegCreate(RegStackTop(info))));
+        return;
     }
-    else 
+
+    bool leftFirst = OperandsLeftFirst(node);
+
+    BuildExpr(leftFirst ? node->left  : node->right, info);
+    BuildExpr(leftFirst ? node->right : node->left,  info);
+
+    IROperand second = IROperandRegCreate(RegStackPop(info));
+    IROperand first  = IROperandRegCreate(RegStackTop(info));
+
+    if (leftFirst || IsCommutative(aluOp))
     {
-        IR_PUSH(IRNodeCreate(OP(F_POP), operand1));
-        IR_PUSH(IRNodeCreate(aluOp, operand1));    
+        IR_PUSH(IRNodeCreate(aluOp, first, second));
+        return;
     }
 
-    IR_PUSH(IRNodeCreate(OP(F_PUSH), operand1));   
+    // second holds left operand
+    IR_PUSH(IRNodeCreate(aluOp,      second, first));
+    IR_PUSH(IRNodeCreate(OP(F_MOV),  first,  second));
 }
 
-// Pascal decl
-static size_t InitFuncParams(const TreeNode* node, CompilerInfoState* info)
+// Pascal decl for params that don't fit in registers
+static void InitFuncParams(const TreeNode* node, size_t paramsCount, size_t* paramPos,
+                           CompilerInfoState* info)
 {
     assert(info);
     assert(info->localTable);
     assert(info->allNamesTable);
+    assert(paramPos);
 
     if (node == nullptr)
-        return 0;
+        return;
 
     if (node->valueType == TreeNodeValueType::NAME)
     {
+        size_t pos = (*paramPos)++;
+
+        // Register params get frame slots, stack params are pushed left to right
+        int memShift = pos < RegParamsCount ? 
+                       -(int)((pos + 1) * XMM_REG_BYTE_SIZE) :
+                       2 * (int)RXX_REG_BYTE_SIZE + (int)((paramsCount - 1 - pos) * XMM_REG_BYTE_SIZE);
+
         Name pushName = {};
 
         NameCtor(&pushName, NameTableGetName(info->allNamesTable, node->value.nameId), nullptr, 
-                 info->memShift, info->regShift);
-        // TODO: Name ctors strdups name. 
-        // It's kind of useless when I am creating local table - 
-        // I'm not going to delete local tables strings without deleting global table
-        // Just using extra mem + time. 
+                 memShift, info->regShift);
 
         NameTablePush(info->localTable, pushName);
 
-        return 1;
+        return;
     }
 
     assert(node->valueType == TreeNodeValueType::OPERATION);
@@ -196,15 +290,18 @@ static size_t InitFuncParams(const TreeNode* node, CompilerInfoState* info)
     {
         case TreeOperationId::COMMA:
         {
-            size_t cntRight = InitFuncParams(node->right, info);
-
-            info->memShift += (int)XMM_REG_BYTE_SIZE;
-        
-            return cntRight + InitFuncParams(node->left, info);
+            InitFuncParams(node->left,  paramsCount, paramPos, info);
+            InitFuncParams(node->right, paramsCount, paramPos, info);
+            
+            return;
         }
 
         case TreeOperationId::TYPE:
-            return InitFuncParams(node->right, info);
+        {
+            InitFuncParams(node->right, paramsCount, paramPos, info);
+
+            return;
+        }
 
         default: // Unreachable
         {
@@ -212,11 +309,32 @@ static size_t InitFuncParams(const TreeNode* node, CompilerInfoState* info)
             break;
         }
     }   
+}
+
+// Moves register params to their slots, called right after the frame is allocated
+static void StoreRegParams(size_t regParamsCount, CompilerInfoState* info)
+{
+    assert(info);
+    assert(regParamsCount <= RegParamsCount);
 
-    // Unreachable
+    for (size_t pos = 0; pos < regParamsCount; ++pos)
+        IR_PUSH(IRNodeCreate(OP(F_MOV), 
+                             IROperandMemCreate(-(long long)((pos + 1) * XMM_REG_BYTE_SIZE), 
+                                                IR_REG(RBP)),
+                             IROperandRegCreate(RegStackGetReg(pos))));
+}
+
+// Number of params / args in the comma separated list
+static size_t CountCommaList(const TreeNode* node)
+{
+    if (node == nullptr)
+        return 0;
 
-    assert(false);
-    return 0;
+    if (node->valueType == TreeNodeValueType::OPERATION && 
+        node->value.operation == TreeOperationId::COMMA)
+        return CountCommaList(node->left) + CountCommaList(node->right);
+
+    return 1;
 }
 
 static int InitFuncLocalVars(const TreeNode* node, CompilerInfoState* info)
@@ -263,75 +381,428 @@ static void PushFuncCallArgs(const TreeNode* node, CompilerInfoState* info)
     if (node->valueType == TreeNodeValueType::OPERATION && 
         node->value.operation == TreeOperationId::COMMA)
     {
-        PushFuncCallArgs(node->left, info);
-        Build(node->right, info);
-    }    
-    else
-        Build(node, info);
+        PushFuncCallArgs(node->left,  info);
+        PushFuncCallArgs(node->right, info);
+
+        return;
+    }
+
+    // Register stack is empty before the first arg, so first args are left in XMM0 - XMM7
+    BuildExpr(node, info);
+
+    if (info->regStackSize > RegParamsCount)
+        IR_PUSH(IRNodeCreate(OP(F_PUSH), IROperandRegCreate(RegStackPop(info))));
 }
 
-static inline void BuildFuncQuit(CompilerInfoState* info)
+//-----------------------------------------------------------------------------
+
+// Self calls in RETURN become jumps to the function entry. Return of f(...) + e / f(...) * e
+// with e without calls becomes acc = acc + e and a jump, other returns give acc + value.
+// Works only if all params are in registers, stack params would have to be moved.
+/// @return additional frame size
+static int InitTailCalls(const TreeNode* funcNameNode, CompilerInfoState* info)
+{
+    assert(funcNameNode);
+    assert(info);
+
+    info->funcNameId     = NameTableGetNameId(info->allNamesTable, funcNameNode->value.nameId);
+    info->tailCallLabel  = IR_NO_LABEL;
+    info->hasAccumulator = false;
+
+    if (info->numberOfStackParams != 0)
+        return 0;
+
+    const TreeNode* body = funcNameNode->right;
+
+    size_t addReturns = CountAccumulatedReturns(body, TreeOperationId::ADD, info);
+    size_t mulReturns = CountAccumulatedReturns(body, TreeOperationId::MUL, info);
+
+    // Accumulator keeps one operation
+    info->hasAccumulator = (addReturns == 0) != (mulReturns == 0);
+    info->accOperation   = addReturns != 0 ? OP(F_ADD) : OP(F_MUL);
+
+    if (!info->hasAccumulator && CountSelfTailCalls(body, info) == 0)
+        return 0;
+
+    size_t id = info->labelId;
+    info->labelId += 1;
+    info->tailCallLabel = IRLabelCreate(info->ir, IRLabelType::TAIL_CALL, id);
+
+    if (!info->hasAccumulator)
+        return 0;
+
+    info->memShift   -= (int)XMM_REG_BYTE_SIZE;
+    info->accMemShift = info->memShift;
+
+    return -(int)XMM_REG_BYTE_SIZE;
+}
+
+// Called after the frame is allocated, params are still in registers
+static void BuildTailCallEntry(size_t regParamsCount, CompilerInfoState* info)
+{
+    assert(info);
+
+    if (info->tailCallLabel == IR_NO_LABEL)
+        return;
+
+    if (info->hasAccumulator)
+    {
+        IROperand accInit = IROperandRegCreate(RegStackGetReg(regParamsCount));
+        
+        IR_PUSH(IRNodeCreate(OP(F_MOV), accInit, 
+                             IROperandImmCreate(info->accOperation == OP(F_ADD) ? 0 : 1)));
+        IR_PUSH(IRNodeCreate(OP(F_MOV), IROperandMemCreate(info->accMemShift, info->regShift),
+                             accInit));
+    }
+
+    IR_PUSH_LABEL(info->tailCallLabel);
+}
+
+static void BuildReturn(const TreeNode* node, CompilerInfoState* info)
+{
+    assert(node);
+    assert(info);
+
+    if (info->tailCallLabel != IR_NO_LABEL)
+    {
+        const TreeNode* selfCall    = nullptr;
+        const TreeNode* accumulated = nullptr;
+
+        if (IsSelfCall(node, info))
+        {
+            BuildTailCall(node, info);
+            return;
+        }
+
+        if (info->hasAccumulator && 
+            IsAccumulatedReturn(node, info->accOperation == OP(F_ADD) ? TreeOperationId::ADD : 
+                                                                        TreeOperationId::MUL,
+                                info, &selfCall, &accumulated))
+        {
+            BuildExpr(accumulated, info);
+            BuildAccumulatorOp(info);
+
+            IR_PUSH(IRNodeCreate(OP(F_MOV), IROperandMemCreate(info->accMemShift, info->regShift),
+                                            IROperandRegCreate(RegStackPop(info))));
+
+            BuildTailCall(selfCall, info);
+            return;
+        }
+    }
+
+    BuildExpr(node, info);
+
+    if (info->hasAccumulator)
+        BuildAccumulatorOp(info);
+
+    IRRegister retValue = RegStackPop(info);
+    if (retValue != IR_REG(XMM0))
+        IR_PUSH(IRNodeCreate(OP(F_MOV), IROperandRegCreate(IR_REG(XMM0)), 
+                                        IROperandRegCreate(retValue)));
+    
+    BuildFuncQuit(info);
+}
+
+// Args are built like for the call, the entry stores them to param slots
+static void BuildTailCall(const TreeNode* node, CompilerInfoState* info)
+{
+    assert(node);
+    assert(info);
+    assert(info->regStackSize == 0);
+
+    PushFuncCallArgs(node->left->left, info);
+    assert(info->regStackSize <= RegParamsCount);
+
+    info->regStackSize = 0;
+
+    IR_PUSH(IRNodeCreate(OP(JMP), IROperandLabelCreate(info->tailCallLabel), true));
+}
+
+// Top of the register stack = acc op top
+static void BuildAccumulatorOp(CompilerInfoState* info)
+{
+    assert(info);
+    assert(info->hasAccumulator);
+
+    IROperand accValue = IROperandRegCreate(RegStackPush(info));
+    IR_PUSH(IRNodeCreate(OP(F_MOV), accValue, 
+                                    IROperandMemCreate(info->accMemShift, info->regShift)));
+
+    RegStackPop(info);
+    IR_PUSH(IRNodeCreate(info->accOperation, IROperandRegCreate(RegStackTop(info)), accValue));
+}
+
+static size_t CountSelfTailCalls(const TreeNode* node, const CompilerInfoState* info)
+{
+    assert(info);
+
+    if (node == nullptr || node->valueType != TreeNodeValueType::OPERATION)
+        return 0;
+
+    if (node->value.operation == TreeOperationId::RETURN)
+        return IsSelfCall(node->left, info) ? 1 : 0;
+
+    return CountSelfTailCalls(node->left, info) + CountSelfTailCalls(node->right, info);
+}
+
+static size_t CountAccumulatedReturns(const TreeNode* node, TreeOperationId operation,
+                                      const CompilerInfoState* info)
+{
+    assert(info);
+
+    if (node == nullptr || node->valueType != TreeNodeValueType::OPERATION)
+        return 0;
+
+    if (node->value.operation == TreeOperationId::RETURN)
+    {
+        const TreeNode* selfCall    = nullptr;
+        const TreeNode* accumulated = nullptr;
+
+        return IsAccumulatedReturn(node->left, operation, info, &selfCall, &accumulated) ? 1 : 0;
+    }
+
+    return CountAccumulatedReturns(node->left,  operation, info) + 
+           CountAccumulatedReturns(node->right, operation, info);
+}
+
+// f(...) op e or e op f(...), e has no calls so it can be evaluated before the jump
+static bool IsAccumulatedReturn(const TreeNode* node, TreeOperationId operation,
+                                const CompilerInfoState* info,
+                                const TreeNode** selfCall, const TreeNode** accumulated)
+{
+    assert(node);
+    assert(info);
+    assert(selfCall);
+    assert(accumulated);
+
+    if (node->valueType != TreeNodeValueType::OPERATION || node->value.operation != operation)
+        return false;
+
+    if (IsSelfCall(node->left, info) && !HasCalls(node->right))
+    {
+        *selfCall    = node->left;
+        *accumulated = node->right;
+        return true;
+    }
+
+    if (IsSelfCall(node->right, info) && !HasCalls(node->left))
+    {
+        *selfCall    = node->right;
+        *accumulated = node->left;
+        return true;
+    }
+
+    return false;
+}
+
+static inline bool IsSelfCall(const TreeNode* node, const CompilerInfoState* info)
+{
+    assert(node);
+    assert(info);
+
+    return node->valueType == TreeNodeValueType::OPERATION && 
+           node->value.operation == TreeOperationId::FUNC_CALL &&
+           NameTableGetNameId(info->allNamesTable, node->left->value.nameId) == info->funcNameId;
+}
+
+//-----------------------------------------------------------------------------
+
+// Expression registers are not saved by callee, live values wait on the machine stack
+static void BuildFuncCall(const TreeNode* node, CompilerInfoState* info)
+{
+    assert(node);
+    assert(info);
+    assert(node->left->valueType == TreeNodeValueType::NAME);
+
+    size_t savedSize = RegStackSave(info);
+
+    PushFuncCallArgs(node->left->left, info);
+
+    const char* funcName  = NameTableGetName(info->allNamesTable, node->left->value.nameId);
+    IRLabelId   funcLabel = IRGetFuncLabel(info->ir, funcName);
+
+    IR_PUSH(IRNodeCreate(OP(CALL), IROperandLabelCreate(funcLabel), true));
+
+    // return value is in XMM0
+    info->regStackSize = 0;
+    RegStackPush(info);
+
+    RegStackRestore(info, savedSize);
+}
+
+// StdIn spoils XMM registers too
+static void BuildRead(CompilerInfoState* info)
 {
-    IR_PUSH(IRNodeCreate(OP(F_POP), IROperandRegCreate(IR_REG(XMM0))));
+    assert(info);
+
+    size_t savedSize = RegStackSave(info);
+
+    IR_PUSH(IRNodeCreate(OP(F_IN)));
+    RegStackPush(info);
+
+    RegStackRestore(info, savedSize);
+}
 
+// Return value is already in XMM0
+static inline void BuildFuncQuit(CompilerInfoState* info)
+{
     IR_PUSH(IRNodeCreate(OP(MOV), IROperandRegCreate(IR_REG(RSP)), 
                                   IROperandRegCreate(IR_REG(RBP))));
 
     IR_PUSH(IRNodeCreate(OP(POP), IROperandRegCreate(IR_REG(RBP))));
 
     IR_PUSH(IRNodeCreate(OP(RET), IROperandImmCreate(
-            (long long)info->numberOfFuncParams * XMM_REG_BYTE_SIZE)));    
+            (long long)info->numberOfStackParams * XMM_REG_BYTE_SIZE)));    
 }
 
-static void BuildComparison(IROperation jccOp, const TreeNode* node, CompilerInfoState* info)
+static void BuildComparison(const TreeNode* node, CompilerInfoState* info)
 {
     assert(node);
-    assert(info->allNamesTable);
-
-    Build(node->left,  info);
-    Build(node->right, info);
+    assert(info);
 
-    IR_PUSH(IRNodeCreate(OP(F_POP), IROperandRegCreate(IR_REG(XMM1))));
-    IR_PUSH(IRNodeCreate(OP(F_POP), IROperandRegCreate(IR_REG(XMM0))));
+    BuildCompareOperands(node, info);
 
-    IR_PUSH(IRNodeCreate(OP(F_CMP), IROperandRegCreate(IR_REG(XMM0)),
-                                    IROperandRegCreate(IR_REG(XMM1))));
+    IROperand result = IROperandRegCreate(RegStackTop(info));
 
-    static const size_t  maxLabelLen  = 64;
-    char comparePushTrue[maxLabelLen] = "";
-    char compareEnd     [maxLabelLen] = "";
     size_t id = info->labelId;
     info->labelId += 1;
-    snprintf(comparePushTrue, maxLabelLen, "COMPARE_PUSH_1_%zu", id);
-    snprintf(compareEnd,      maxLabelLen, "COMPARE_END_%zu",    id);
+    IRLabelId comparePushTrue = IRLabelCreate(info->ir, IRLabelType::COMPARE_PUSH_1, id);
+    IRLabelId compareEnd      = IRLabelCreate(info->ir, IRLabelType::COMPARE_END,    id);
 
-    IR_PUSH(IRNodeCreate(jccOp, IROperandLabelCreate(comparePushTrue), true));
+    IR_PUSH(IRNodeCreate(ComparisonJump(node), IROperandLabelCreate(comparePushTrue), true));
 
-    IR_PUSH(IRNodeCreate(OP(F_XOR),  IROperandRegCreate(IR_REG(XMM0)),
-                                     IROperandRegCreate(IR_REG(XMM0))));
-    IR_PUSH(IRNodeCreate(OP(F_PUSH), IROperandRegCreate(IR_REG(XMM0))));
+    IR_PUSH(IRNodeCreate(OP(F_XOR), result, result));
 
     IR_PUSH(IRNodeCreate(OP(JMP), IROperandLabelCreate(compareEnd), true));
 
     IR_PUSH_LABEL(comparePushTrue);
 
-    IR_PUSH(IRNodeCreate(OP(F_MOV), IROperandRegCreate(IR_REG(XMM0)), 
-                                    IROperandImmCreate(1)));
-
-    IR_PUSH(IRNodeCreate(OP(F_PUSH), IROperandRegCreate(IR_REG(XMM0))));
+    IR_PUSH(IRNodeCreate(OP(F_MOV), result, IROperandImmCreate(1)));
 
     IR_PUSH_LABEL(compareEnd);
 }
 
+// Evaluates both operands and compares them. Register of the first operand stays on the 
+// register stack - place for the comparison result.
+static void BuildCompareOperands(const TreeNode* node, CompilerInfoState* info)
+{
+    assert(node);
+    assert(info);
+
+    bool leftFirst = OperandsLeftFirst(node);
+
+    BuildExpr(leftFirst ? node->left  : node->right, info);
+    BuildExpr(leftFirst ? node->right : node->left,  info);
+
+    IROperand second = IROperandRegCreate(RegStackPop(info));
+    IROperand first  = IROperandRegCreate(RegStackTop(info));
+
+    IR_PUSH(IRNodeCreate(OP(F_CMP), leftFirst ? first  : second, 
+                                    leftFirst ? second : first));
+}
+
+// Condition in branch context: jumps to target if condition == jumpIfTrue, 
+// falls through otherwise. 0 / 1 is never materialized for comparisons.
+static void BuildCondJump(const TreeNode* node, bool jumpIfTrue, IRLabelId target,
+                          CompilerInfoState* info)
+{
+    assert(node);
+    assert(info);
+
+    IROperation jccOp = ComparisonJump(node);
+    if (jccOp != OP(NOP))
+    {
+        BuildCompareOperands(node, info);
+        RegStackPop(info);
+
+        if (!jumpIfTrue)
+            jccOp = InverseJump(jccOp);
+
+        IR_PUSH(IRNodeCreate(jccOp, IROperandLabelCreate(target), true));
+        return;
+    }
+
+    // and / or are bitwise, short circuit gives the same result only for 0 / 1 operands 
+    // and if calls on the right are not skipped
+    bool isAnd = node->valueType == TreeNodeValueType::OPERATION && 
+                 node->value.operation == TreeOperationId::AND;
+    bool isOr  = node->valueType == TreeNodeValueType::OPERATION && 
+                 node->value.operation == TreeOperationId::OR;
+
+    if ((isAnd || isOr) && IsBoolExpr(node) && !HasCalls(node->right))
+    {
+        // and - jump if false on the first false operand, or - jump if true on the first true
+        if (isOr == jumpIfTrue)
+        {
+            BuildCondJump(node->left,  jumpIfTrue, target, info);
+            BuildCondJump(node->right, jumpIfTrue, target, info);
+            return;
+        }
+
+        size_t id = info->labelId;
+        info->labelId += 1;
+        IRLabelId skipLabel = IRLabelCreate(info->ir, IRLabelType::COND_SKIP, id);
+
+        BuildCondJump(node->left,  !jumpIfTrue, skipLabel, info);
+        BuildCondJump(node->right,  jumpIfTrue, target,    info);
+
+        IR_PUSH_LABEL(skipLabel);
+        return;
+    }
+
+    BuildExpr(node, info);
+
+    IROperand condition = IROperandRegCreate(RegStackPop(info));
+    IROperand zero      = IROperandRegCreate(RegStackGetReg(info->regStackSize + 1));
+    
+    IR_PUSH(IRNodeCreate(OP(F_XOR), zero, zero));
+    IR_PUSH(IRNodeCreate(OP(F_CMP), condition, zero));
+
+    IR_PUSH(IRNodeCreate(jumpIfTrue ? OP(JNE) : OP(JE), IROperandLabelCreate(target), true));
+}
+
 static void BuildNum(const TreeNode* node, CompilerInfoState* info)
 {
     assert(node);
     assert(info);
 
-    IR_PUSH(IRNodeCreate(OP(F_MOV), IROperandRegCreate(IR_REG(XMM0)),
+    IR_PUSH(IRNodeCreate(OP(F_MOV), IROperandRegCreate(RegStackPush(info)),
                                     IROperandImmCreate(node->value.num)));
+}
+
+// There is no pow instruction, so only constant powers with integer result are built -
+// they are loaded as immediates. Middle-end doesn't fold them if result is out of int range.
+static void BuildPow(const TreeNode* node, CompilerInfoState* info)
+{
+    assert(node);
+    assert(info);
+
+    // integers up to 2^53 are exact in double
+    static const double maxExactInteger = 9007199254740992.0;
+
+    const TreeNode* base  = node->left;
+    const TreeNode* power = node->right;
+
+    if (base  && base->valueType  == TreeNodeValueType::NUM &&
+        power && power->valueType == TreeNodeValueType::NUM && power->value.num >= 0)
+    {
+        double val = pow(base->value.num, power->value.num);
 
-    IR_PUSH(IRNodeCreate(OP(F_PUSH), IROperandRegCreate(IR_REG(XMM0))));
+        if (fabs(val) <= maxExactInteger)
+        {
+            IR_PUSH(IRNodeCreate(OP(F_MOV), IROperandRegCreate(RegStackPush(info)),
+                                            IROperandImmCreate((long long)val)));
+            return;
+        }
+    }
+
+    printf(RED_TEXT("Unsupported operation - '^' is allowed only for constant integer "
+                    "powers with integer result\n"));
+    info->err = IRErrors::UNSUPPORTED_OPERATION;
+
+    // expression still leaves its value on the register stack
+    IR_PUSH(IRNodeCreate(OP(F_MOV), IROperandRegCreate(RegStackPush(info)),
+                                    IROperandImmCreate(0)));
 }
 
 static void BuildVar(const TreeNode* node, CompilerInfoState* info)
@@ -345,18 +816,196 @@ static void BuildVar(const TreeNode* node, CompilerInfoState* info)
     assert(charname);
     printf("FOUND CHARNAME - %s, id was - %d\n", charname, node->value.nameId);
     NameTableFind(info->localTable, 
-                  NameTableGetName(info->allNamesTable, node->value.nameId), &name);
+                  NameTableGetNameId(info->allNamesTable, node->value.nameId), &name);
     assert(name);
 
-    IR_PUSH(IRNodeCreate(OP(F_MOV), IROperandRegCreate(IR_REG(XMM0)),
+    IR_PUSH(IRNodeCreate(OP(F_MOV), IROperandRegCreate(RegStackPush(info)),
                                     IROperandMemCreate(name->memShift, name->reg)));
+}
 
-    IR_PUSH(IRNodeCreate(OP(F_PUSH), IROperandRegCreate(IR_REG(XMM0))));
+//-----------------------------------------------------------------------------
+
+// Sethi-Ullman number: registers needed to evaluate expression without spilling
+// Recounted on every level, expression trees are shallow.
+static size_t RegistersNeed(const TreeNode* node)
+{
+    if (node == nullptr)
+        return 0;
+
+    if (node->valueType != TreeNodeValueType::OPERATION)
+        return 1;
+
+    // Calls save all registers in use and start from the empty register stack
+    if (node->value.operation == TreeOperationId::FUNC_CALL ||
+        node->value.operation == TreeOperationId::READ)
+        return 1;
+
+    size_t needLeft  = RegistersNeed(node->left);
+    size_t needRight = RegistersNeed(node->right);
+
+    if (needLeft == needRight)
+        return needLeft + 1;
+
+    return needLeft > needRight ? needLeft : needRight;
+}
+
+// Sethi-Ullman: child that needs more registers goes first. Calls and reads are 
+// never reordered - they print and consume input, so left operand is always first then
+// and BuildExpr spills registers if they are not enough.
+static bool OperandsLeftFirst(const TreeNode* node)
+{
+    assert(node);
+
+    if (HasCalls(node->left) || HasCalls(node->right))
+        return true;
+
+    return RegistersNeed(node->left) >= RegistersNeed(node->right);
+}
+
+static inline IRRegister RegStackGetReg(size_t pos)
+{
+    assert(pos < RegStackCapacity);
+
+    return (IRRegister)((size_t)IR_REG(XMM0) + pos);
+}
+
+static inline IRRegister RegStackPush(CompilerInfoState* info)
+{
+    assert(info);
+
+    return RegStackGetReg(info->regStackSize++);
+}
+
+static inline IRRegister RegStackPop(CompilerInfoState* info)
+{
+    assert(info);
+    assert(info->regStackSize > 0);
+
+    return RegStackGetReg(--info->regStackSize);
+}
+
+static inline IRRegister RegStackTop(const CompilerInfoState* info)
+{
+    assert(info);
+    assert(info->regStackSize > 0);
+
+    return RegStackGetReg(info->regStackSize - 1);
+}
+
+/// @brief Pushes registers in use on the machine stack, register stack becomes empty.
+/// @return size to give to RegStackRestore
+static size_t RegStackSave(CompilerInfoState* info)
+{
+    assert(info);
+
+    size_t savedSize = info->regStackSize;
+
+    for (size_t pos = 0; pos < savedSize; ++pos)
+        IR_PUSH(IRNodeCreate(OP(F_PUSH), IROperandRegCreate(RegStackGetReg(pos))));
+
+    info->regStackSize = 0;
+
+    return savedSize;
+}
+
+/// @brief Register stack has the only value - result of the expression evaluated after 
+///        RegStackSave. It's placed on top of saved registers.
+static void RegStackRestore(CompilerInfoState* info, size_t savedSize)
+{
+    assert(info);
+    assert(info->regStackSize == 1);
+
+    info->regStackSize = savedSize + 1;
+
+    if (savedSize == 0)
+        return;
+
+    IR_PUSH(IRNodeCreate(OP(F_MOV), IROperandRegCreate(RegStackTop(info)),
+                                    IROperandRegCreate(RegStackGetReg(0))));
+
+    for (size_t pos = savedSize; pos > 0; --pos)
+        IR_PUSH(IRNodeCreate(OP(F_POP), IROperandRegCreate(RegStackGetReg(pos - 1))));
+}
+
+static inline bool IsCommutative(IROperation operation)
+{
+    return operation == OP(F_ADD) || operation == OP(F_MUL) ||
+           operation == OP(F_AND) || operation == OP(F_OR);
 }
 
 //-----------------------------------------------------------------------------
 
-static void PatchJumps(IR* ir, const LabelTableType* labelTable)
+// Jump taken if comparison is true, NOP if node is not a comparison
+static IROperation ComparisonJump(const TreeNode* node)
+{
+    assert(node);
+
+    if (node->valueType != TreeNodeValueType::OPERATION)
+        return OP(NOP);
+
+    switch (node->value.operation)
+    {
+        case TreeOperationId::LESS:         return OP(JB);
+        case TreeOperationId::GREATER:      return OP(JA);
+        case TreeOperationId::LESS_EQ:      return OP(JBE);
+        case TreeOperationId::GREATER_EQ:   return OP(JAE);
+        case TreeOperationId::EQ:           return OP(JE);
+        case TreeOperationId::NOT_EQ:       return OP(JNE);
+
+        default:
+            return OP(NOP);
+    }
+}
+
+static IROperation InverseJump(IROperation jccOp)
+{
+    switch (jccOp)
+    {
+        case OP(JB):    return OP(JAE);
+        case OP(JAE):   return OP(JB);
+        case OP(JA):    return OP(JBE);
+        case OP(JBE):   return OP(JA);
+        case OP(JE):    return OP(JNE);
+        case OP(JNE):   return OP(JE);
+
+        default: // Unreachable
+            assert(false);
+            return OP(NOP);
+    }
+}
+
+// Value is always 0 or 1
+static bool IsBoolExpr(const TreeNode* node)
+{
+    assert(node);
+
+    if (ComparisonJump(node) != OP(NOP))
+        return true;
+
+    if (node->valueType != TreeNodeValueType::OPERATION ||
+        (node->value.operation != TreeOperationId::AND && 
+         node->value.operation != TreeOperationId::OR))
+        return false;
+
+    return IsBoolExpr(node->left) && IsBoolExpr(node->right);
+}
+
+static bool HasCalls(const TreeNode* node)
+{
+    if (node == nullptr)
+        return false;
+
+    if (node->valueType == TreeNodeValueType::OPERATION &&
+        (node->value.operation == TreeOperationId::FUNC_CALL ||
+         node->value.operation == TreeOperationId::READ))
+        return true;
+
+    return HasCalls(node->left) || HasCalls(node->right);
+}
+
+//-----------------------------------------------------------------------------
+
+static void PatchJumps(IR* ir)
 {
     assert(ir);
     assert(ir->end);
@@ -370,14 +1019,11 @@ static void PatchJumps(IR* ir, const LabelTableType* labelTable)
         {
             assert(node->operand1.type == IROperandType::LABEL);
 
-            LabelTableValue* outLabel = nullptr;
-            LabelTableFind(labelTable, node->operand1.value.string, &outLabel);
-
-            assert(outLabel);
-            assert(outLabel->connectedNode);
-            assert(outLabel->connectedNode->nextNode);
+            IRNode* labelNode = IRLabelGetNode(ir, node->operand1.value.label);
+            assert(labelNode);
 
-            node->jumpTarget = outLabel->connectedNode->nextNode;
+            // Label node is never removed by optimizations, instructions after it can be
+            node->jumpTarget = labelNode;
         }
 
         node = node->nextNode;
@@ -392,12 +1038,19 @@ static inline CompilerInfoState CompilerInfoStateCtor()
     info.allNamesTable      = nullptr;
     info.localTable         = nullptr;
     info.ir                 = nullptr;
-    info.labelTable         = nullptr;
 
     info.labelId            = 0;
     info.memShift           = 0;
-    info.numberOfFuncParams = 0;
+    info.numberOfStackParams = 0;
     info.regShift           = IR_REG(NO_REG);
+    info.regStackSize       = 0;
+
+    info.funcNameId         = NO_INTERN_ID;
+    info.tailCallLabel      = IR_NO_LABEL;
+    info.hasAccumulator     = false;
+    info.accOperation       = OP(NOP);
+    info.accMemShift        = 0;
+    info.err                = IRErrors::NO_ERR;
     
     return info;
 }
@@ -408,13 +1061,17 @@ static inline void              CompilerInfoStateDtor(CompilerInfoState* info)
     info->localTable         = nullptr;
     info->ir                 = nullptr;
 
-    LabelTableDtor(info->labelTable);
-    info->labelTable         = nullptr;
-
     info->labelId            = 0;
     info->memShift           = 0;
-    info->numberOfFuncParams = 0;
+    info->numberOfStackParams = 0;
     info->regShift           = IR_REG(NO_REG);
+    info->regStackSize       = 0;
+
+    info->funcNameId         = NO_INTERN_ID;
+    info->tailCallLabel      = IR_NO_LABEL;
+    info->hasAccumulator     = false;
+    info->accOperation       = OP(NOP);
+    info->accMemShift        = 0;
 }
 
 //---------------------------------------------------------------------------------------
@@ -7,7 +7,7 @@
 #include "BackEnd/IR/IRRegisters.h"
 #include "BackEnd/IR/IRList/IR.h"
 
-IR* IRBuild(const Tree* tree);
+IR* IRBuild(const Tree* tree, IRErrors* outErr);
 
 //-----------------------------------------------
 
@@ -0,0 +1,588 @@
+#include <assert.h>
+#include <stdlib.h>
+
+#include "IRFrame.h"
+
+// Prologue is PUSH RBP; MOV RBP, RSP; ADD RSP, -frameSize right after the FUNC label,
+// every quit is MOV RSP, RBP; POP RBP; RET. Param [RBP + shift] is [entry RSP - SavedRbpSize + shift].
+static const size_t    PushRbpPos        = 1;
+static const size_t    MovRbpPos         = 2;
+static const size_t    FrameNodePos      = 3;
+
+static const long long SavedRbpSize      = 8;
+
+// System V: signal handlers don't touch 128 bytes below RSP, leaf function can keep locals there
+static const long long RedZoneSize       = 128;
+
+static const size_t    STANDARD_CAPACITY = 64;
+static const long long NO_DEPTH          = -1;
+
+struct FrameState
+{
+    IRNode**   nodes;           ///< nodes of the current function by position
+    size_t     nodesCount;
+    size_t     nodesCapacity;
+
+    long long* depths;          ///< bytes below entry RSP before node, NO_DEPTH - unreachable
+    size_t     depthsCapacity;
+
+    long long* slots;           ///< distinct [RBP - x] slots of the current function
+    size_t     slotsCount;
+    size_t     slotsCapacity;
+
+    size_t*    labelPos;        ///< labelId -> position in the function it was met in
+    long long* labelDepths;     ///< labelId -> depth at the label
+    long long* funcPops;        ///< FUNC labelId -> bytes of stack params its RET removes
+};
+
+static FrameState FrameStateCtor(const IR* ir);
+static void       FrameStateDtor(FrameState* state);
+
+static void    CollectFuncPops      (FrameState* state, const IR* ir);
+static IRNode* CollectFuncNodes     (FrameState* state, const IR* ir, IRNode* funcBegin);
+static bool    HasFramePrologue     (const FrameState* state);
+static void    CompactFrame         (FrameState* state);
+static bool    IsLeafFunc           (const FrameState* state);
+static bool    CountDepths          (FrameState* state, bool useRedZone);
+static bool    ChangeDepth          (const FrameState* state, size_t pos, long long* depth);
+static void    OmitFramePointer     (FrameState* state, IR* ir, bool useRedZone);
+
+static long long* GetSlot           (FrameState* state, long long memShift);
+static int     SlotsCmp             (const void* lhs, const void* rhs);
+
+static inline bool IsFuncBegin      (const IR* ir, const IRNode* node);
+static inline bool IsFrameSlot      (const IROperand operand);
+static inline bool IsRegOperand     (const IROperand operand, IRRegister reg);
+static inline bool IsFrameQuit      (const IRNode* node);
+
+static void*   ArrayReserve         (void* data, size_t* capacity, size_t size, size_t elemSize);
+
+#define OP(OP_NAME)   IROperation::OP_NAME
+
+//-----------------------------------------------------------------------------
+
+void IRFrameOptimize(IR* ir, bool keepFramePointer)
+{
+    assert(ir);
+
+    FrameState state = FrameStateCtor(ir);
+
+    CollectFuncPops(&state, ir);
+
+    IRNode* head = IRHead(ir);
+    IRNode* node = head->nextNode;
+
+    while (node != head && !IsFuncBegin(ir, node))
+        node = node->nextNode;
+
+    while (node != head)
+    {
+        IRNode* nextFunc = CollectFuncNodes(&state, ir, node);
+
+        if (HasFramePrologue(&state))
+        {
+            CompactFrame(&state);
+
+            long long frameSize  = -state.nodes[FrameNodePos]->operand2.value.imm;
+            bool      useRedZone = IsLeafFunc(&state) && frameSize <= RedZoneSize;
+
+            if (!keepFramePointer && CountDepths(&state, useRedZone))
+                OmitFramePointer(&state, ir, useRedZone);
+        }
+
+        node = nextFunc;
+    }
+
+    FrameStateDtor(&state);
+}
+
+//-----------------------------------------------------------------------------
+
+static void CollectFuncPops(FrameState* state, const IR* ir)
+{
+    assert(state);
+    assert(ir);
+
+    IRNode*   head     = IRHead(ir);
+    IRLabelId funcName = IR_NO_LABEL;
+
+    for (IRNode* node = head->nextNode; node != head; node = node->nextNode)
+    {
+        if (IsFuncBegin(ir, node))
+            funcName = node->labelId;
+
+        if (node->operation == OP(RET) && funcName != IR_NO_LABEL)
+            state->funcPops[funcName] = node->operand1.value.imm;
+    }
+}
+
+static IRNode* CollectFuncNodes(FrameState* state, const IR* ir, IRNode* funcBegin)
+{
+    assert(state);
+    assert(ir);
+    assert(funcBegin);
+
+    IRNode* head = IRHead(ir);
+    IRNode* node = funcBegin;
+
+    state->nodesCount = 0;
+
+    do
+    {
+        state->nodes = (IRNode**)ArrayReserve(state->nodes, &state->nodesCapacity,
+                                              state->nodesCount, sizeof(*state->nodes));
+
+        if (node->labelId != IR_NO_LABEL)
+        {
+            state->labelPos   [node->labelId] = state->nodesCount;
+            state->labelDepths[node->labelId] = NO_DEPTH;
+        }
+
+        state->nodes[state->nodesCount++] = node;
+        node = node->nextNode;
+    } while (node != head && !IsFuncBegin(ir, node));
+
+    state->depths = (long long*)ArrayReserve(state->depths, &state->depthsCapacity,
+                                             state->nodesCount, sizeof(*state->depths));
+
+    return node;
+}
+
+static bool HasFramePrologue(const FrameState* state)
+{
+    assert(state);
+
+    if (state->nodesCount <= FrameNodePos)
+        return false;
+
+    const IRNode* pushNode  = state->nodes[PushRbpPos];
+    const IRNode* movNode   = state->nodes[MovRbpPos];
+    const IRNode* frameNode = state->nodes[FrameNodePos];
+
+    return pushNode->operation  == OP(PUSH) && IsRegOperand(pushNode->operand1, IRRegister::RBP) &&
+           movNode->operation   == OP(MOV)  && IsRegOperand(movNode->operand1,  IRRegister::RBP) &&
+                                               IsRegOperand(movNode->operand2,  IRRegister::RSP) &&
+           frameNode->operation == OP(ADD)  && IsRegOperand(frameNode->operand1, IRRegister::RSP) &&
+           frameNode->operand2.type == IROperandType::IMM;
+}
+
+// Slots of variables that live in registers are not referenced anymore,
+// the rest are renumbered to go one after another below saved RBP
+static void CompactFrame(FrameState* state)
+{
+    assert(state);
+
+    state->slotsCount = 0;
+
+    for (size_t pos = 0; pos < state->nodesCount; ++pos)
+    {
+        const IRNode* node = state->nodes[pos];
+
+        const IROperand* operands[] = { &node->operand1, &node->operand2 };
+
+        for (size_t i = 0; i < node->numberOfOperands; ++i)
+        {
+            if (IsFrameSlot(*operands[i]))
+                GetSlot(state, operands[i]->value.imm);
+        }
+    }
+
+    qsort(state->slots, state->slotsCount, sizeof(*state->slots), SlotsCmp);
+
+    for (size_t pos = 0; pos < state->nodesCount; ++pos)
+    {
+        IRNode* node = state->nodes[pos];
+
+        IROperand* operands[] = { &node->operand1, &node->operand2 };
+
+        for (size_t i = 0; i < node->numberOfOperands; ++i)
+        {
+            if (!IsFrameSlot(*operands[i]))
+                continue;
+
+            size_t slotPos = (size_t)(GetSlot(state, operands[i]->value.imm) - state->slots);
+            operands[i]->value.imm = -(long long)((slotPos + 1) * XMM_REG_BYTE_SIZE);
+        }
+    }
+
+    for (size_t slotPos = 0; slotPos < state->slotsCount; ++slotPos)
+        state->slots[slotPos] = -(long long)((slotPos + 1) * XMM_REG_BYTE_SIZE);
+
+    state->nodes[FrameNodePos]->operand2.value.imm =
+                                -(long long)(state->slotsCount * XMM_REG_BYTE_SIZE);
+}
+
+// Leaf function calls nothing (std lib included) and moves RSP only in prologue / quits
+static bool IsLeafFunc(const FrameState* state)
+{
+    assert(state);
+
+    for (size_t pos = FrameNodePos + 1; pos < state->nodesCount; ++pos)
+    {
+        const IRNode* node = state->nodes[pos];
+
+        switch (node->operation)
+        {
+            case OP(CALL):
+            case OP(F_IN):
+            case OP(F_OUT):
+            case OP(STR_OUT):
+            case OP(HLT):
+            case OP(PUSH):
+            case OP(F_PUSH):
+            case OP(F_POP):
+                return false;
+
+            case OP(POP):
+                if (!IsFrameQuit(state->nodes[pos - 1]))
+                    return false;
+                break;
+
+            case OP(ADD):
+            case OP(SUB):
+                if (IsRegOperand(node->operand1, IRRegister::RSP))
+                    return false;
+                break;
+
+            default:
+                break;
+        }
+    }
+
+    return true;
+}
+
+// Simulates RSP through the function. Fails if a label is reached with different depths
+// or RSP is changed in an unknown way - such function keeps RBP.
+// Prologue PUSH RBP / MOV RBP, RSP don't count, they are going to be removed.
+static bool CountDepths(FrameState* state, bool useRedZone)
+{
+    assert(state);
+
+    long long depth = 0;
+
+    for (size_t pos = 0; pos < state->nodesCount; ++pos)
+    {
+        const IRNode* node = state->nodes[pos];
+
+        if (node->labelId != IR_NO_LABEL)
+        {
+            long long labelDepth = state->labelDepths[node->labelId];
+
+            if (labelDepth != NO_DEPTH && depth != NO_DEPTH && labelDepth != depth)
+                return false;
+
+            if (labelDepth != NO_DEPTH)
+                depth = labelDepth;
+
+            state->labelDepths[node->labelId] = depth;
+        }
+
+        state->depths[pos] = depth;
+
+        if (depth == NO_DEPTH || pos == PushRbpPos || pos == MovRbpPos)
+            continue;
+
+        if (pos == FrameNodePos)
+        {
+            if (!useRedZone)
+                depth -= node->operand2.value.imm;
+
+            continue;
+        }
+
+        if (!ChangeDepth(state, pos, &depth))
+            return false;
+
+        if (node->jumpTarget && node->operation != OP(CALL))
+        {
+            IRLabelId targetLabel = node->jumpTarget->labelId;
+            assert(targetLabel != IR_NO_LABEL);
+
+            long long targetDepth = state->labelDepths[targetLabel];
+
+            if (state->labelPos[targetLabel] <= pos && targetDepth != depth)
+                return false;
+
+            if (targetDepth != NO_DEPTH && targetDepth != depth)
+                return false;
+
+            state->labelDepths[targetLabel] = depth;
+        }
+
+        if (node->operation == OP(JMP) || node->operation == OP(RET))
+            depth = NO_DEPTH;
+    }
+
+    return true;
+}
+
+static bool ChangeDepth(const FrameState* state, size_t pos, long long* depth)
+{
+    assert(state);
+    assert(depth);
+
+    const IRNode* node = state->nodes[pos];
+
+    bool writesRsp = node->numberOfOperands > 0 && IsRegOperand(node->operand1, IRRegister::RSP);
+    bool usesRbp   = (node->numberOfOperands > 0 && IsRegOperand(node->operand1, IRRegister::RBP)) ||
+                     (node->numberOfOperands > 1 && IsRegOperand(node->operand2, IRRegister::RBP));
+
+    switch (node->operation)
+    {
+        case OP(PUSH):
+            *depth += (long long)sizeof(uint64_t);
+            return !usesRbp;
+
+        case OP(POP):
+            if (usesRbp)
+                return IsFrameQuit(state->nodes[pos - 1]);
+
+            *depth -= (long long)sizeof(uint64_t);
+            break;
+
+        case OP(F_PUSH):
+            *depth += (long long)XMM_REG_BYTE_SIZE;
+            break;
+
+        case OP(F_POP):
+            *depth -= (long long)XMM_REG_BYTE_SIZE;
+            break;
+
+        case OP(ADD):
+        case OP(SUB):
+            if (!writesRsp)
+                return !usesRbp;
+
+            if (node->operand2.type != IROperandType::IMM)
+                return false;
+
+            *depth += node->operation == OP(ADD) ? -node->operand2.value.imm :
+                                                    node->operand2.value.imm;
+            break;
+
+        case OP(MOV):
+            if (!IsFrameQuit(node))
+                return !writesRsp && !usesRbp;
+
+            if (pos + 1 >= state->nodesCount || state->nodes[pos + 1]->operation != OP(POP))
+                return false;
+
+            *depth = 0;
+            break;
+
+        case OP(CALL):
+        {
+            long long pops = state->funcPops[node->jumpTarget->labelId];
+            if (pops == NO_DEPTH)
+                return false;
+
+            *depth -= pops;
+            break;
+        }
+
+        default:
+            return !usesRbp;
+    }
+
+    return *depth >= 0;
+}
+
+static void OmitFramePointer(FrameState* state, IR* ir, bool useRedZone)
+{
+    assert(state);
+    assert(ir);
+
+    for (size_t pos = 0; pos < state->nodesCount; ++pos)
+    {
+        IRNode*   node  = state->nodes[pos];
+        long long depth = state->depths[pos];
+
+        // Unreachable tail after RET / JMP, usually the default function quit
+        if (depth == NO_DEPTH)
+        {
+            if (node->labelId == IR_NO_LABEL)
+                IRRemove(ir, node);
+
+            continue;
+        }
+
+        if (pos == PushRbpPos || pos == MovRbpPos ||
+            (node->operation == OP(POP) && IsRegOperand(node->operand1, IRRegister::RBP)))
+        {
+            IRRemove(ir, node);
+            continue;
+        }
+
+        if (pos == FrameNodePos)
+        {
+            if (useRedZone || node->operand2.value.imm == 0)
+                IRRemove(ir, node);
+
+            continue;
+        }
+
+        if (IsFrameQuit(node))
+        {
+            if (depth == 0)
+            {
+                IRRemove(ir, node);
+                continue;
+            }
+
+            node->operation = OP(ADD);
+            node->operand2  = IROperandImmCreate(depth);
+            continue;
+        }
+
+        IROperand* operands[] = { &node->operand1, &node->operand2 };
+
+        for (size_t i = 0; i < node->numberOfOperands; ++i)
+        {
+            if (operands[i]->type != IROperandType::MEM ||
+                operands[i]->value.reg != IRRegister::RBP)
+                continue;
+
+            // Locals move up to the place of saved RBP, params are right above return address
+            long long memShift = operands[i]->value.imm;
+            if (!IsFrameSlot(*operands[i]))
+                memShift -= SavedRbpSize;
+
+            *operands[i] = IROperandMemCreate(depth + memShift, IRRegister::RSP);
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+static long long* GetSlot(FrameState* state, long long memShift)
+{
+    assert(state);
+
+    // Functions have few variables
+    for (size_t i = 0; i < state->slotsCount; ++i)
+    {
+        if (state->slots[i] == memShift)
+            return &state->slots[i];
+    }
+
+    state->slots = (long long*)ArrayReserve(state->slots, &state->slotsCapacity,
+                                            state->slotsCount, sizeof(*state->slots));
+
+    state->slots[state->slotsCount] = memShift;
+
+    return &state->slots[state->slotsCount++];
+}
+
+// Closest to RBP first
+static int SlotsCmp(const void* lhs, const void* rhs)
+{
+    assert(lhs);
+    assert(rhs);
+
+    long long lhsSlot = *(const long long*)lhs;
+    long long rhsSlot = *(const long long*)rhs;
+
+    if (lhsSlot == rhsSlot)
+        return 0;
+
+    return lhsSlot > rhsSlot ? -1 : 1;
+}
+
+//-----------------------------------------------------------------------------
+
+static inline bool IsFuncBegin(const IR* ir, const IRNode* node)
+{
+    assert(ir);
+    assert(node);
+
+    return node->labelId != IR_NO_LABEL && ir->labels[node->labelId].type == IRLabelType::FUNC;
+}
+
+/// @brief [RBP - x] - local variable or saved register, params are above RBP
+static inline bool IsFrameSlot(const IROperand operand)
+{
+    return operand.type == IROperandType::MEM && operand.value.reg == IRRegister::RBP &&
+           operand.value.imm < 0;
+}
+
+static inline bool IsRegOperand(const IROperand operand, IRRegister reg)
+{
+    return operand.type == IROperandType::REG && operand.value.reg == reg;
+}
+
+/// @brief MOV RSP, RBP - start of every function quit
+static inline bool IsFrameQuit(const IRNode* node)
+{
+    assert(node);
+
+    return node->operation == OP(MOV) && IsRegOperand(node->operand1, IRRegister::RSP) &&
+                                         IsRegOperand(node->operand2, IRRegister::RBP);
+}
+
+//-----------------------------------------------------------------------------
+
+static FrameState FrameStateCtor(const IR* ir)
+{
+    assert(ir);
+
+    FrameState state = {};
+
+    state.nodes          = nullptr;
+    state.nodesCount     = 0;
+    state.nodesCapacity  = 0;
+
+    state.depths         = nullptr;
+    state.depthsCapacity = 0;
+
+    state.slots          = nullptr;
+    state.slotsCount     = 0;
+    state.slotsCapacity  = 0;
+
+    state.labelPos = (size_t*)calloc(ir->labelsCount + 1, sizeof(*state.labelPos));
+    assert(state.labelPos);
+
+    state.labelDepths = (long long*)calloc(ir->labelsCount + 1, sizeof(*state.labelDepths));
+    assert(state.labelDepths);
+
+    state.funcPops    = (long long*)calloc(ir->labelsCount + 1, sizeof(*state.funcPops));
+    assert(state.funcPops);
+
+    for (size_t labelId = 0; labelId <= ir->labelsCount; ++labelId)
+        state.funcPops[labelId] = NO_DEPTH;
+
+    return state;
+}
+
+static void FrameStateDtor(FrameState* state)
+{
+    assert(state);
+
+    free(state->nodes);
+    free(state->depths);
+    free(state->slots);
+    free(state->labelPos);
+    free(state->labelDepths);
+    free(state->funcPops);
+
+    *state = {};
+}
+
+static void* ArrayReserve(void* data, size_t* capacity, size_t size, size_t elemSize)
+{
+    assert(capacity);
+
+    if (size < *capacity)
+        return data;
+
+    *capacity = *capacity ? 2 * *capacity : STANDARD_CAPACITY;
+    while (*capacity <= size)
+        *capacity *= 2;
+
+    data = realloc(data, *capacity * elemSize);
+    assert(data);
+
+    return data;
+}
+
+#undef OP
@@ -0,0 +1,14 @@
+#ifndef IR_FRAME_H
+#define IR_FRAME_H
+
+#include "BackEnd/IR/IRList/IR.h"
+
+/// @brief Shrinks stack frames after register allocation: slots of variables that
+///        got registers are dropped, the rest are packed right below the return address.
+///        Unless keepFramePointer is set (perf call graphs need RBP chain), functions
+///        with known RSP at every instruction address the frame through RSP and lose
+///        PUSH RBP / MOV RBP, RSP / POP RBP. Leaf functions with small frames keep
+///        locals in the red zone and have no prologue and epilogue at all.
+void IRFrameOptimize(IR* ir, bool keepFramePointer);
+
+#endif
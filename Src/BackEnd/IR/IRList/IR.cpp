@@ -1,8 +1,10 @@
 #include <assert.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "Common/Log.h"
+#include "Common/StringIntern.h"
 #include "IR.h"
 
 #define TYPE(IR_TYPE)      IROperandType::IR_TYPE
@@ -11,18 +13,19 @@
 #define EMPTY_OPERAND      IROperandCtor()
 #define CREATE_VALUE(...)  IROperandValueCreate(__VA_ARGS__)
 
+static const size_t STANDARD_LABELS_CAPACITY = 16;
+
+static inline void IRLabelsRealloc    (IR* ir);
+static inline void IRFuncLabelsRealloc(IR* ir, size_t minCapacity);
+
+static const char* IRLabelTypeGetPrefix(IRLabelType type);
+
 void IRPushBack  (IR* ir, IRNode* node)
 {
     assert(ir);
     assert(node);
 
-    node->nextNode    = ir->end->nextNode;
-    node->prevNode    = ir->end;
-    ir->end->nextNode = node;
-    
-    ir->end = node;
-
-    ir->size++;
+    IRInsertAfter(ir, ir->end, node);
 }
 
 IRNode* IRHead    (const IR* ir)
@@ -33,15 +36,50 @@ IRNode* IRHead    (const IR* ir)
     return ir->end->nextNode;
 }
 
-IRNode* IRNodeCreate(IROperation operation, const char* labelName, 
+void IRRemove(IR* ir, IRNode* node)
+{
+    assert(ir);
+    assert(node);
+    assert(node != IRHead(ir));
+    assert(node->labelId == IR_NO_LABEL);
+
+    if (ir->end == node)
+        ir->end = node->prevNode;
+
+    node->prevNode->nextNode = node->nextNode;
+    node->nextNode->prevNode = node->prevNode;
+
+    IRNodeDtor(node);
+
+    ir->size--;
+}
+
+void IRInsertAfter(IR* ir, IRNode* prevNode, IRNode* node)
+{
+    assert(ir);
+    assert(prevNode);
+    assert(node);
+
+    node->nextNode = prevNode->nextNode;
+    node->prevNode = prevNode;
+
+    prevNode->nextNode->prevNode = node;
+    prevNode->nextNode           = node;
+
+    if (ir->end == prevNode)
+        ir->end = node;
+
+    ir->size++;
+}
+
+IRNode* IRNodeCreate(IROperation operation, IRLabelId labelId, 
                      size_t numberOfOperands, IROperand operand1, IROperand operand2,
                      bool needPatch)
 {
     IRNode* node = IRNodeCtor();
 
     node->operation = operation;
-    
-    node->labelName = labelName ? strdup(labelName) : nullptr;
+    node->labelId   = labelId;
 
     node->numberOfOperands = numberOfOperands;
     
@@ -55,22 +93,22 @@ IRNode* IRNodeCreate(IROperation operation, const char* labelName,
 
 IRNode* IRNodeCreate(IROperation operation, IROperand operand1, bool needPatch)
 {
-    return IRNodeCreate(operation, nullptr, 1, operand1, EMPTY_OPERAND, needPatch);
+    return IRNodeCreate(operation, IR_NO_LABEL, 1, operand1, EMPTY_OPERAND, needPatch);
 }
 
 IRNode* IRNodeCreate(IROperation operation, IROperand operand1, IROperand operand2, bool needPatch)
 {
-    return IRNodeCreate(operation, nullptr, 2, operand1, operand2, needPatch);
+    return IRNodeCreate(operation, IR_NO_LABEL, 2, operand1, operand2, needPatch);
 }
 
 IRNode* IRNodeCreate(IROperation operation)
 {
-    return IRNodeCreate(operation, nullptr, 0, EMPTY_OPERAND, EMPTY_OPERAND, false);
+    return IRNodeCreate(operation, IR_NO_LABEL, 0, EMPTY_OPERAND, EMPTY_OPERAND, false);
 }
 
-IRNode* IRNodeCreate(const char* labelName)
+IRNode* IRNodeCreate(IRLabelId labelId)
 {
-    return IRNodeCreate(OP(NOP), labelName, 0, EMPTY_OPERAND, EMPTY_OPERAND, false);
+    return IRNodeCreate(OP(NOP), labelId, 0, EMPTY_OPERAND, EMPTY_OPERAND, false);
 }
 
 IROperand IROperandRegCreate(IRRegister reg)
@@ -88,9 +126,12 @@ IROperand IROperandStrCreate(const char* str)
     return IROperandCreate(CREATE_VALUE(0, IR_REG(NO_REG), str), TYPE(STR));
 }
 
-IROperand IROperandLabelCreate  (const char* label)
+IROperand IROperandLabelCreate  (IRLabelId label)
 {
-    return IROperandCreate(CREATE_VALUE(0, IR_REG(NO_REG), label), TYPE(LABEL));
+    IROperandValue value = CREATE_VALUE();
+    value.label = label;
+
+    return IROperandCreate(value, TYPE(LABEL));
 }
 
 IROperand IROperandMemCreate(const long long imm, IRRegister reg)
@@ -102,17 +143,17 @@ IROperandValue IROperandValueCreate(long long imm, IRRegister reg, const char* s
                                     IRErrors* error)
 {
     IROperandValue val = {};
-    val.imm  = imm;
-    val.reg  = reg;
+    val.imm   = imm;
+    val.reg   = reg;
+    val.label = IR_NO_LABEL;
     
     if (string)
     {
-        val.string = strdup(string);
-
-        if (error && !val.string) *error = IRErrors::MEM_ALLOC_ERR;
-        else if (!error) assert(val.string);
+        val.string = StringInternPtr(string);
     }
 
+    if (error) *error = IRErrors::NO_ERR;
+
     return val;
 }
 
@@ -148,6 +189,7 @@ IRNode* IRNodeCtor()
     IRNode* node = (IRNode*)calloc(1, sizeof(*node));
 
     node->operation = IROperation::NOP;
+    node->labelId   = IR_NO_LABEL;
 
     node->asmCmdBeginAddress = 0;
     node->asmCmdEndAddress   = 0;
@@ -167,9 +209,6 @@ IRNode* IRNodeCtor()
 
 void IRNodeDtor(IRNode* node)
 {
-    if (node->labelName)
-        free(node->labelName);
-    
     IROperandDtor(&node->operand1);
     IROperandDtor(&node->operand2);
     free(node);
@@ -185,6 +224,13 @@ IR* IRCtor()
     ir->end->nextNode = ir->end;
     ir->end->prevNode = ir->end;
 
+    ir->labels         = nullptr;
+    ir->labelsCount    = 0;
+    ir->labelsCapacity = 0;
+
+    ir->funcLabels         = nullptr;
+    ir->funcLabelsCapacity = 0;
+
     return ir;
 }
 
@@ -201,6 +247,8 @@ void IRDtor(IR* ir)
         node = nextNode;
     } while (node != beginNode);
     
+    free(ir->labels);
+    free(ir->funcLabels);
     free(ir);
 }
 
@@ -212,11 +260,134 @@ void IROperandValueDtor(IROperandValue* value)
     value->imm = 0;
     value->reg = IRRegister::NO_REG;
 
-    if (!value->string)
-        return;
-
-    free(value->string);
     value->string = nullptr;
+    value->label  = IR_NO_LABEL;
+}
+
+//-----------------------------------------------
+
+IRLabelId IRLabelCreate(IR* ir, IRLabelType type, size_t number)
+{
+    assert(ir);
+
+    if (ir->labelsCount == ir->labelsCapacity)
+        IRLabelsRealloc(ir);
+
+    IRLabelId labelId = ir->labelsCount;
+    ir->labelsCount++;
+
+    ir->labels[labelId].type   = type;
+    ir->labels[labelId].number = number;
+    ir->labels[labelId].name   = nullptr;
+    ir->labels[labelId].node   = nullptr;
+
+    return labelId;
+}
+
+IRLabelId IRGetFuncLabel(IR* ir, const char* funcName)
+{
+    assert(ir);
+    assert(funcName);
+
+    InternId nameId = StringIntern(funcName);
+
+    if (nameId >= ir->funcLabelsCapacity)
+        IRFuncLabelsRealloc(ir, (size_t)nameId + 1);
+
+    if (ir->funcLabels[nameId] == IR_NO_LABEL)
+    {
+        IRLabelId labelId = IRLabelCreate(ir, IRLabelType::FUNC, 0);
+        ir->labels[labelId].name = StringInternGet(nameId);
+
+        ir->funcLabels[nameId] = labelId;
+    }
+
+    return ir->funcLabels[nameId];
+}
+
+void IRLabelBind(IR* ir, IRLabelId labelId, IRNode* node)
+{
+    assert(ir);
+    assert(node);
+    assert(labelId < ir->labelsCount);
+    assert(ir->labels[labelId].node == nullptr);
+
+    ir->labels[labelId].node = node;
+}
+
+IRNode* IRLabelGetNode(const IR* ir, IRLabelId labelId)
+{
+    assert(ir);
+    assert(labelId < ir->labelsCount);
+
+    return ir->labels[labelId].node;
+}
+
+const char* IRLabelGetName(const IR* ir, IRLabelId labelId, char* buffer, size_t bufferSize)
+{
+    assert(ir);
+    assert(buffer);
+    assert(labelId < ir->labelsCount);
+
+    const IRLabel* label = &ir->labels[labelId];
+
+    if (label->type == IRLabelType::FUNC)
+        return label->name;
+
+    snprintf(buffer, bufferSize, "%s%zu", IRLabelTypeGetPrefix(label->type), label->number);
+
+    return buffer;
+}
+
+static const char* IRLabelTypeGetPrefix(IRLabelType type)
+{
+    switch (type)
+    {
+        case IRLabelType::COMPARE_PUSH_1:   return "COMPARE_PUSH_1_";
+        case IRLabelType::COMPARE_END:      return "COMPARE_END_";
+        case IRLabelType::END_IF:           return "END_IF_";
+        case IRLabelType::WHILE:            return "WHILE_";
+        case IRLabelType::END_WHILE:        return "END_WHILE_";
+        case IRLabelType::COND_SKIP:        return "COND_SKIP_";
+        case IRLabelType::TAIL_CALL:        return "TAIL_CALL_";
+
+        case IRLabelType::FUNC:
+        default: // Unreachable
+            assert(false);
+            return nullptr;
+    }
+}
+
+static inline void IRLabelsRealloc(IR* ir)
+{
+    assert(ir);
+
+    size_t newCapacity = ir->labelsCapacity ? 2 * ir->labelsCapacity : STANDARD_LABELS_CAPACITY;
+
+    IRLabel* newLabels = (IRLabel*)realloc(ir->labels, newCapacity * sizeof(*newLabels));
+    assert(newLabels);
+
+    ir->labels         = newLabels;
+    ir->labelsCapacity = newCapacity;
+}
+
+static inline void IRFuncLabelsRealloc(IR* ir, size_t minCapacity)
+{
+    assert(ir);
+
+    size_t newCapacity = ir->funcLabelsCapacity ? ir->funcLabelsCapacity : STANDARD_LABELS_CAPACITY;
+    while (newCapacity < minCapacity)
+        newCapacity *= 2;
+
+    IRLabelId* newFuncLabels = (IRLabelId*)realloc(ir->funcLabels, 
+                                                   newCapacity * sizeof(*newFuncLabels));
+    assert(newFuncLabels);
+
+    for (size_t i = ir->funcLabelsCapacity; i < newCapacity; ++i)
+        newFuncLabels[i] = IR_NO_LABEL;
+
+    ir->funcLabels         = newFuncLabels;
+    ir->funcLabelsCapacity = newCapacity;
 }
 
 //-----------------------------------------------
@@ -238,10 +409,14 @@ void IRTextDump(const IR* ir, const char* fileName, const char* funcName, const
         Log("---------------\n");
         Log("Operation - %s\n", IRGetOperationName(node->operation));    
 
-        if (node->labelName) Log("Label name - %s\n", node->labelName);
+        if (node->labelId != IR_NO_LABEL) 
+        {
+            char labelName[IRLabelNameMaxLength] = "";
+            Log("Label name - %s\n", IRLabelGetName(ir, node->labelId, labelName, IRLabelNameMaxLength));
+        }
         
-        if (node->numberOfOperands > 0) IROperandTextDump(node->operand1);
-        if (node->numberOfOperands > 1) IROperandTextDump(node->operand2);
+        if (node->numberOfOperands > 0) IROperandTextDump(ir, node->operand1);
+        if (node->numberOfOperands > 1) IROperandTextDump(ir, node->operand2);
 
         node = node->nextNode;
     } while (node != beginNode);
@@ -249,8 +424,10 @@ void IRTextDump(const IR* ir, const char* fileName, const char* funcName, const
     LogEnd(fileName, funcName, line);
 }
 
-void IROperandTextDump(const IROperand operand)
+void IROperandTextDump(const IR* ir, const IROperand operand)
 {
+    assert(ir);
+
     switch (operand.type)
     {
         case TYPE(IMM):
@@ -280,6 +457,12 @@ void IROperandTextDump(const IROperand operand)
 
     if (operand.value.string) Log("\t str - %s\n", operand.value.string);
     else                      Log("\t str - null\n");
+
+    if (operand.type == TYPE(LABEL)) 
+    {
+        char labelName[IRLabelNameMaxLength] = "";
+        Log("\t label - %s\n", IRLabelGetName(ir, operand.value.label, labelName, IRLabelNameMaxLength));
+    }
 }
 
 const char* IRGetOperationName(IROperation operation)
@@ -1,7 +1,10 @@
 #ifndef IR_LIST_H
 #define IR_LIST_H
 
+#include <stdint.h>
+
 #include "BackEnd/IR/IRRegisters.h"
+#include "Common/StringIntern.h"
 
 #define DEF_IR_OP(IR_OP, ...) IR_OP,
 enum class IROperation
@@ -20,11 +23,29 @@ enum class IROperandType
     STR,    /// < string operand
 };
 
+typedef size_t IRLabelId;
+
+static const IRLabelId IR_NO_LABEL = SIZE_MAX;
+
+enum class IRLabelType
+{
+    FUNC,           /// < named by function identifier
+
+    COMPARE_PUSH_1,
+    COMPARE_END,
+    END_IF,
+    WHILE,
+    END_WHILE,
+    COND_SKIP,      /// < short circuit of and / or in conditions
+    TAIL_CALL,      /// < function entry after the frame, self tail calls jump here
+};
+
 struct IROperandValue
 {
     long long   imm;
     IRRegister  reg;
-    char*       string;
+    const char* string; /// < interned
+    IRLabelId   label;
 };
 
 struct IROperand
@@ -38,13 +59,13 @@ static const size_t MaxCmdLenInBytes = 16;
 struct IRNode
 {
     IROperation operation;
-    char*       labelName;
+    IRLabelId   labelId;   /// < label placed at this node (NOP) or IR_NO_LABEL
 
     size_t    numberOfOperands;
     IROperand operand1;
     IROperand operand2;
 
-    IRNode* jumpTarget;
+    IRNode* jumpTarget;    /// < label node (NOP) jump goes to
 
     bool needPatch;
 
@@ -55,11 +76,30 @@ struct IRNode
     IRNode* prevNode;
 };
 
+/// @brief Enough for any generated label name, size of the buffer for IRLabelGetName
+static const size_t IRLabelNameMaxLength = 48;
+
+struct IRLabel
+{
+    IRLabelType type;
+    size_t      number;     /// < suffix of generated label name
+    const char* name;       /// < interned, only for FUNC labels
+
+    IRNode*     node;       /// < NOP node label is placed at
+};
+
 struct IR
 {
     IRNode* end;
 
     size_t size;
+
+    IRLabel* labels;        /// < labelId -> label
+    size_t   labelsCount;
+    size_t   labelsCapacity;
+
+    IRLabelId* funcLabels;  /// < InternId of function name -> labelId
+    size_t     funcLabelsCapacity;
 };
 
 enum class IRErrors
@@ -67,6 +107,8 @@ enum class IRErrors
     NO_ERR,
 
     MEM_ALLOC_ERR,
+
+    UNSUPPORTED_OPERATION,
 };
 
 //-----------------------------------------------
@@ -77,9 +119,15 @@ void IRDtor(IR* ir);
 void    IRPushBack(IR* irList, IRNode* node);
 IRNode* IRHead    (const IR* irList);
 
+/// @brief Unlinks node from the list and destroys it. Node can't be a label or a jump target
+void    IRRemove  (IR* irList, IRNode* node);
+
+/// @brief Links node right after prevNode
+void    IRInsertAfter(IR* irList, IRNode* prevNode, IRNode* node);
+
 //-----------------------------------------------
 
-IRNode* IRNodeCreate(IROperation operation, const char* labelName, 
+IRNode* IRNodeCreate(IROperation operation, IRLabelId labelId, 
                      size_t numberOfOperands, IROperand operand1, IROperand operand2,
                      bool needPatch = false);
 
@@ -87,7 +135,7 @@ IRNode* IRNodeCreate(IROperation operation, IROperand operand1, bool needPatch =
 IRNode* IRNodeCreate(IROperation operation, IROperand operand1, IROperand operand2, 
                      bool needPatch = false);
 IRNode* IRNodeCreate(IROperation operation);
-IRNode* IRNodeCreate(const char* labelName);
+IRNode* IRNodeCreate(IRLabelId labelId);
 IRNode* IRNodeCtor();
 
 void IRNodeDtor(IRNode* node);
@@ -108,14 +156,27 @@ IROperand IROperandRegCreate    (IRRegister reg);
 IROperand IROperandImmCreate    (const long long imm);
 IROperand IROperandStrCreate    (const char* str);
 IROperand IROperandMemCreate    (const long long imm, IRRegister reg);
-IROperand IROperandLabelCreate  (const char* label);
+IROperand IROperandLabelCreate  (IRLabelId label);
+
+//-----------------------------------------------
+
+IRLabelId   IRLabelCreate   (IR* ir, IRLabelType type, size_t number);
+IRLabelId   IRGetFuncLabel  (IR* ir, const char* funcName);
+void        IRLabelBind     (IR* ir, IRLabelId labelId, IRNode* node);
+
+IRNode*     IRLabelGetNode  (const IR* ir, IRLabelId labelId);
+
+/// @brief Readable label name, formatted only on request (asm output / dumps).
+///        Not FUNC labels are formatted into the buffer and are not interned.
+/// @return function name or buffer
+const char* IRLabelGetName  (const IR* ir, IRLabelId labelId, char* buffer, size_t bufferSize);
 
 //-----------------------------------------------
 
 #define IR_TEXT_DUMP(IR) IRTextDump(IR, __FILE__, __func__, __LINE__)
 void IRTextDump(const IR* ir, const char* fileName, const char* funcName, const int line);
 
-void IROperandTextDump(const IROperand operand);
+void IROperandTextDump(const IR* ir, const IROperand operand);
 
 //-----------------------------------------------
 
@@ -3,20 +3,24 @@
 #endif
 
 // DEF_IR_OP(OP_NAME, X64_GEN_CODE)
-// PRINT_LABEL(LABEL) - prints label to outStream x64 asm
+// PRINT_LABEL(LABEL_ID) - prints label to outStream x64 asm
 
 // PRINT_OPERATION(OP_NAME) - prints operation. Operands are taken from current node info
 
-// PrintOperation(outStream, code, opNameInX64Asm, X64Operation, IROperand operand1, 
-//                                                               IROperand operand2)
+// PrintOperation(outStream, ir, code, opNameInX64Asm, X64Operation, IROperand operand1, 
+//                                                                   IROperand operand2)
 
-// Vars : IRNode* node, FILE* outStream, CodeArrayType* code
+// PRINT_JUMP(OP_NAME) - prints jump / call to node->jumpTarget, records fixup for it
+// PRINT_STD_LIB_CALL(STD_LIB_FUNC) - CALL to StdLibAddresses::STD_LIB_FUNC (binary only)
+
+// Vars : const IR* ir, IRNode* node, FILE* outStream, CodeArrayType* code,
+//        RodataInfo rodata, X64Fixups fixups
 
 DEF_IR_OP(NOP,
 {
-    if (node->labelName)
+    if (node->labelId != IR_NO_LABEL)
     {
-        PRINT_LABEL(node->labelName);
+        PRINT_LABEL(node->labelId);
     }
     else
     {
@@ -91,7 +95,7 @@ DEF_IR_OP(F_POW,
 
 DEF_IR_OP(F_SQRT,
 {
-    PrintOperation(outStream, code, "SQRTPD", X64Operation::SQRTPD, 
+    PrintOperation(outStream, ir, code, "SQRTPD", X64Operation::SQRTPD, 
                    node->operand1, node->operand1);
 })
 
@@ -119,7 +123,7 @@ DEF_IR_OP(F_PUSH,
 {
     PrintAsmCodeLine(outStream, "\tSUB RSP, %d\n", (int)XMM_REG_BYTE_SIZE);
     PrintAsmCodeLine(outStream, "\tMOVSD [RSP], ");
-    PrintOperand    (outStream, node->operand1);
+    PrintOperand    (outStream, ir, node->operand1);
     PrintAsmCodeLine(outStream, "\n");
 
     PrintOperationInCodeArray(code, X64Operation::SUB, 
@@ -134,7 +138,7 @@ DEF_IR_OP(F_PUSH,
 DEF_IR_OP(F_POP,
 {
     PrintAsmCodeLine(outStream, "\tMOVSD ");
-    PrintOperand    (outStream, node->operand1); 
+    PrintOperand    (outStream, ir, node->operand1); 
     PrintAsmCodeLine(outStream, ", [RSP]\n");
     PrintAsmCodeLine(outStream, "\tADD RSP, %d\n", (int)XMM_REG_BYTE_SIZE);
 
@@ -152,19 +156,22 @@ DEF_IR_OP(F_MOV,
     if (node->operand2.type == IROperandType::IMM)
     {
         PrintAsmCodeLine(outStream, "\tMOVSD ");
-        PrintOperand    (outStream, node->operand1);
-
-        long long imm = node->operand2.value.imm;
+        PrintOperand    (outStream, ir, node->operand1);
 
-        RodataImmediatesValue* immLabelInfo = GetImmLabelInfo(imm, rodata.rodataImmediates);
+        size_t immPos = RodataAddImmediate(&rodata, node->operand2.value.imm);
 
-        PrintAsmCodeLine(outStream, ", [%s]\n", immLabelInfo->label);
+        PrintAsmCodeLine(outStream, ", [" RODATA_IMM_LABEL "]\n", immPos);
 
+        size_t movPos = code->size;
         PrintOperationInCodeArray(code, X64Operation::MOVSD, 
                                   ConvertIRToX64Operand(node->operand1),
-                                  X64OperandMemCreate(X64Register::NO_REG, immLabelInfo->asmAddr));
+                                  X64OperandMemCreate(X64Register::NO_REG, 0));
+        AddRodataFixup(&fixups, code, movPos, X64Operation::MOVSD, 
+                       X64FixupType::RODATA_IMM_ABS32, immPos);
 
     }
+    else if (node->operand1.type == IROperandType::REG && node->operand2.type == IROperandType::REG)
+        PRINT_OPERATION(MOVAPS);
     else
         PRINT_OPERATION(MOVSD);
 })
@@ -176,62 +183,61 @@ DEF_IR_OP(F_CMP,
 
 DEF_IR_OP(JMP,
 {
-    SetLabelRelativeShift(node);
-    PRINT_OPERATION(JMP);
+    PRINT_JUMP(JMP);
 })
 
 DEF_IR_OP(JE,
 {
-    SetLabelRelativeShift(node);
-    PRINT_OPERATION(JE);
+    PRINT_JUMP(JE);
 })
 
 DEF_IR_OP(JNE,
 {
-    SetLabelRelativeShift(node);
-    PRINT_OPERATION(JNE);
+    PRINT_JUMP(JNE);
 })
 
 DEF_IR_OP(JB,
 {
-    SetLabelRelativeShift(node);
-    PRINT_OPERATION(JB);
+    PRINT_JUMP(JB);
 })
 
 DEF_IR_OP(JBE,
 {
-    SetLabelRelativeShift(node);
-    PRINT_OPERATION(JBE);
+    PRINT_JUMP(JBE);
 })
 
 DEF_IR_OP(JA,
 {
-    SetLabelRelativeShift(node);
-    PRINT_OPERATION(JA);
+    PRINT_JUMP(JA);
 })
 
 DEF_IR_OP(JAE,
 {
-    SetLabelRelativeShift(node);
-    PRINT_OPERATION(JAE);
+    PRINT_JUMP(JAE);
 })
 
 DEF_IR_OP(CALL,
 {
-    SetLabelRelativeShift(node);
-    PRINT_OPERATION(CALL);
+    PRINT_JUMP(CALL);
 })
 
 DEF_IR_OP(RET,
 {
-    PRINT_OPERATION(RET);
+    if (node->operand1.value.imm == 0)
+    {
+        PrintAsmCodeLine(outStream, "\tRET\n");
+
+        PrintOperationInCodeArray(code, X64Operation::RET, X64OperandImmCreate(0));
+    }
+    else
+        PRINT_OPERATION(RET);
 })
 
 DEF_IR_OP(F_OUT,
 {
     PrintAsmCodeLine(outStream, "\tSUB RSP, %d\n", (int)XMM_REG_BYTE_SIZE);
     PrintAsmCodeLine(outStream, "\tMOVSD [RSP], ");
-    PrintOperand    (outStream, node->operand1);
+    PrintOperand    (outStream, ir, node->operand1);
     PrintAsmCodeLine(outStream, "\n");
     PrintAsmCodeLine(outStream, "\tCALL StdFOut\n");
     
@@ -243,47 +249,42 @@ DEF_IR_OP(F_OUT,
                               X64OperandMemCreate(X64Register::RSP, 0),
                               ConvertIRToX64Operand(node->operand1));
 
-    PrintOperationInCodeArray(code, X64Operation::CALL,
-                              X64OperandImmCreate(
-                              (int)StdLibAddresses::OUT_FLOAT - node->asmCmdEndAddress));
+    PRINT_STD_LIB_CALL(OUT_FLOAT);
 })
 
 DEF_IR_OP(F_IN,
 {
     PrintAsmCodeLine(outStream, "\tCALL StdIn\n");
 
-    PrintOperationInCodeArray(code, X64Operation::CALL,
-                              X64OperandImmCreate(
-                              (int)StdLibAddresses::IN_FLOAT - node->asmCmdEndAddress));
+    PRINT_STD_LIB_CALL(IN_FLOAT);
 })
 
 DEF_IR_OP(STR_OUT,
 {
     const char* string = node->operand1.value.string;
 
-    RodataStringsValue* strLabelInfo  = GetStrLabelInfo(string, rodata.rodataStrings);
+    size_t strPos = RodataAddString(&rodata, string);
 
-    PrintAsmCodeLine(outStream, "\tLEA RAX, [%s]\n", strLabelInfo->label);
+    PrintAsmCodeLine(outStream, "\tLEA RAX, [" RODATA_STR_LABEL "]\n", strPos);
     PrintAsmCodeLine(outStream, "\tPUSH RAX\n");
     PrintAsmCodeLine(outStream, "\tCALL StdStrOut\n");
 
+    size_t leaPos = code->size;
     PrintOperationInCodeArray(code, X64Operation::LEA, 
                               X64OperandRegCreate(X64Register::RAX),
-                              X64OperandMemCreate(X64Register::NO_REG, strLabelInfo->asmAddr));
+                              X64OperandMemCreate(X64Register::NO_REG, 0));
+    AddRodataFixup(&fixups, code, leaPos, X64Operation::LEA,
+                   X64FixupType::RODATA_STR_ABS32, strPos);
 
     PrintOperationInCodeArray(code, X64Operation::PUSH,
                               X64OperandRegCreate(X64Register::RAX));
 
-    PrintOperationInCodeArray(code, X64Operation::CALL,
-                              X64OperandImmCreate(
-                              (int)StdLibAddresses::OUT_STRING - node->asmCmdEndAddress));
+    PRINT_STD_LIB_CALL(OUT_STRING);
 })
 
 DEF_IR_OP(HLT,
 {
     PrintAsmCodeLine(outStream, "\tCALL StdHlt\n");
 
-    PrintOperationInCodeArray(code, X64Operation::CALL,
-                              X64OperandImmCreate(
-                              (int)StdLibAddresses::HLT - node->asmCmdEndAddress));
+    PRINT_STD_LIB_CALL(HLT);
 })
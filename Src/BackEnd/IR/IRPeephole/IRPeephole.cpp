@@ -0,0 +1,318 @@
+#include <assert.h>
+
+#include "IRPeephole.h"
+
+// Longest pattern, after a change scan steps back that many nodes minus one
+static const size_t MaxPatternLen = 3;
+
+#define DEF_IR_PEEPHOLE(NAME, ...) static bool Peephole_##NAME(IR* ir, IRNode* node);
+#include "IRPeepholePatterns.h"
+#undef DEF_IR_PEEPHOLE
+
+static inline bool IsOperation      (const IRNode* node, IROperation operation);
+static inline bool IsRegOperand     (const IROperand operand);
+static inline bool IsRegOperand     (const IROperand operand, IRRegister reg);
+static inline bool OperandsEqual    (const IROperand operand1, const IROperand operand2);
+static inline bool OperandUsesReg   (const IROperand operand, IRRegister reg);
+static inline bool OperandUsesStack (const IROperand operand);
+static inline bool IsValidFMov      (const IROperand dest, const IROperand src);
+static inline bool OverwritesReg    (const IRNode* node, IRRegister reg);
+
+#define OP(OP_NAME) IROperation::OP_NAME
+
+//-----------------------------------------------------------------------------
+
+IRPeepholeStats IRPeepholeStatsCtor()
+{
+    IRPeepholeStats stats = {};
+
+    for (size_t i = 0; i < (size_t)IRPeepholePattern::COUNT; ++i)
+        stats.hits[i] = 0;
+
+    stats.removedNodes = 0;
+
+    return stats;
+}
+
+void IRPeephole(IR* ir, IRPeepholeStats* stats)
+{
+    assert(ir);
+    assert(stats);
+
+    size_t  sizeBefore = ir->size;
+
+    IRNode* head = IRHead(ir);
+    IRNode* node = head->nextNode;
+
+    while (node != head)
+    {
+        IRNode* prevNode = node->prevNode;
+        bool    changed  = false;
+
+    #define DEF_IR_PEEPHOLE(NAME, ...)                                  \
+        if (!changed && Peephole_##NAME(ir, node))                      \
+        {                                                               \
+            stats->hits[(size_t)IRPeepholePattern::NAME]++;             \
+            changed = true;                                             \
+        }
+
+        #include "IRPeepholePatterns.h"
+
+    #undef DEF_IR_PEEPHOLE
+
+        if (!changed)
+        {
+            node = node->nextNode;
+            continue;
+        }
+
+        // nodes before the changed one can form new patterns with the nodes after it
+        node = prevNode;
+        for (size_t i = 2; i < MaxPatternLen && node != head; ++i)
+            node = node->prevNode;
+
+        if (node == head)
+            node = head->nextNode;
+    }
+
+    stats->removedNodes += sizeBefore - ir->size;
+}
+
+void IRPeepholeStatsPrint(FILE* outStream, const IRPeepholeStats* stats)
+{
+    assert(outStream);
+    assert(stats);
+
+    fprintf(outStream, "IR peephole: removed nodes - %zu\n", stats->removedNodes);
+
+#define DEF_IR_PEEPHOLE(NAME, DESCRIPTION)                                          \
+    fprintf(outStream, "\t%-16s %8zu    %s\n", #NAME,                               \
+            stats->hits[(size_t)IRPeepholePattern::NAME], DESCRIPTION);
+
+    #include "IRPeepholePatterns.h"
+
+#undef DEF_IR_PEEPHOLE
+}
+
+//-----------------------------------------------------------------------------
+
+static bool Peephole_PUSH_POP_CANCEL(IR* ir, IRNode* node)
+{
+    IRNode* popNode = node->nextNode;
+
+    if (!IsOperation(node, OP(F_PUSH)) || !IsOperation(popNode, OP(F_POP)))
+        return false;
+
+    if (!OperandsEqual(node->operand1, popNode->operand1) || OperandUsesStack(node->operand1))
+        return false;
+
+    IRRemove(ir, popNode);
+    IRRemove(ir, node);
+
+    return true;
+}
+
+static bool Peephole_PUSH_POP_TO_MOV(IR* ir, IRNode* node)
+{
+    IRNode* popNode = node->nextNode;
+
+    if (!IsOperation(node, OP(F_PUSH)) || !IsOperation(popNode, OP(F_POP)))
+        return false;
+
+    if (OperandUsesStack(node->operand1) || OperandUsesStack(popNode->operand1) ||
+        !IsValidFMov(popNode->operand1, node->operand1))
+        return false;
+
+    popNode->operation        = OP(F_MOV);
+    popNode->numberOfOperands = 2;
+    popNode->operand2         = node->operand1;
+
+    IRRemove(ir, node);
+
+    return true;
+}
+
+static bool Peephole_PUSH_POP_AROUND(IR* ir, IRNode* node)
+{
+    IRNode* movNode = node->nextNode;
+    IRNode* popNode = movNode->nextNode;
+
+    if (!IsOperation(node, OP(F_PUSH)) || !IsOperation(movNode, OP(F_MOV)) || 
+        !IsOperation(popNode, OP(F_POP)))
+        return false;
+
+    if (!IsRegOperand(node->operand1) || !OperandsEqual(node->operand1, popNode->operand1))
+        return false;
+
+    // Value is kept in the register instead of the stack, move must not touch both of them
+    if (OperandUsesStack(movNode->operand1) || OperandUsesStack(movNode->operand2) ||
+        OperandUsesReg(movNode->operand1, node->operand1.value.reg))
+        return false;
+
+    IRRemove(ir, popNode);
+    IRRemove(ir, node);
+
+    return true;
+}
+
+static bool Peephole_SELF_MOV(IR* ir, IRNode* node)
+{
+    if (!IsOperation(node, OP(F_MOV)) && !IsOperation(node, OP(MOV)))
+        return false;
+
+    if (!IsRegOperand(node->operand1) || !OperandsEqual(node->operand1, node->operand2))
+        return false;
+
+    IRRemove(ir, node);
+
+    return true;
+}
+
+static bool Peephole_MOV_BACK(IR* ir, IRNode* node)
+{
+    IRNode* backNode = node->nextNode;
+
+    if (!IsOperation(node, OP(F_MOV)) || !IsOperation(backNode, OP(F_MOV)))
+        return false;
+
+    // y already holds the value of x, moving it back changes nothing
+    if (!OperandsEqual(node->operand1, backNode->operand2) ||
+        !OperandsEqual(node->operand2, backNode->operand1))
+        return false;
+
+    IRRemove(ir, backNode);
+
+    return true;
+}
+
+static bool Peephole_DEAD_F_MOV(IR* ir, IRNode* node)
+{
+    IRNode* nextNode = node->nextNode;
+
+    if (!IsOperation(node, OP(F_MOV)))
+        return false;
+
+    bool isDead = false;
+
+    if (IsRegOperand(node->operand1))
+        isDead = OverwritesReg(nextNode, node->operand1.value.reg);
+
+    else if (node->operand1.type == IROperandType::MEM)
+        isDead = IsOperation(nextNode, OP(F_MOV)) && 
+                 OperandsEqual(node->operand1, nextNode->operand1) &&
+                 nextNode->operand2.type != IROperandType::MEM;
+
+    if (!isDead)
+        return false;
+
+    IRRemove(ir, node);
+
+    return true;
+}
+
+static bool Peephole_FORWARD_F_MOV(IR* ir, IRNode* node)
+{
+    IRNode* movNode       = node->nextNode;
+    IRNode* overwriteNode = movNode->nextNode;
+
+    if (!IsOperation(node, OP(F_MOV)) || !IsOperation(movNode, OP(F_MOV)))
+        return false;
+
+    if (!IsRegOperand(node->operand1) || !OperandsEqual(node->operand1, movNode->operand2) ||
+        OperandsEqual(node->operand1, movNode->operand1))
+        return false;
+
+    if (!IsValidFMov(movNode->operand1, node->operand2) ||
+        !OverwritesReg(overwriteNode, node->operand1.value.reg))
+        return false;
+
+    movNode->operand2 = node->operand2;
+
+    IRRemove(ir, node);
+
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+
+static inline bool IsOperation(const IRNode* node, IROperation operation)
+{
+    assert(node);
+
+    // label is NOP node too, both of them are never a part of a pattern
+    return node->operation == operation && node->labelId == IR_NO_LABEL;
+}
+
+static inline bool IsRegOperand(const IROperand operand)
+{
+    return operand.type == IROperandType::REG;
+}
+
+static inline bool IsRegOperand(const IROperand operand, IRRegister reg)
+{
+    return operand.type == IROperandType::REG && operand.value.reg == reg;
+}
+
+static inline bool OperandsEqual(const IROperand operand1, const IROperand operand2)
+{
+    if (operand1.type != operand2.type)
+        return false;
+
+    switch (operand1.type)
+    {
+        case IROperandType::REG:
+            return operand1.value.reg == operand2.value.reg;
+
+        case IROperandType::MEM:
+            return operand1.value.reg == operand2.value.reg && 
+                   operand1.value.imm == operand2.value.imm;
+
+        case IROperandType::IMM:
+            return operand1.value.imm == operand2.value.imm;
+
+        case IROperandType::LABEL:
+        case IROperandType::STR:
+        default:
+            return false;
+    }
+}
+
+static inline bool OperandUsesReg(const IROperand operand, IRRegister reg)
+{
+    return (operand.type == IROperandType::REG || operand.type == IROperandType::MEM) &&
+            operand.value.reg == reg;
+}
+
+static inline bool OperandUsesStack(const IROperand operand)
+{
+    return OperandUsesReg(operand, IRRegister::RSP);
+}
+
+/// @brief F_MOV is encoded as MOVSD, so at least one operand is XMM register
+static inline bool IsValidFMov(const IROperand dest, const IROperand src)
+{
+    if (dest.type == IROperandType::REG)
+        return src.type == IROperandType::REG || src.type == IROperandType::MEM ||
+               src.type == IROperandType::IMM;
+
+    return dest.type == IROperandType::MEM && src.type == IROperandType::REG;
+}
+
+/// @brief True if node writes reg without reading its previous value
+static inline bool OverwritesReg(const IRNode* node, IRRegister reg)
+{
+    assert(node);
+
+    if (IsOperation(node, OP(F_POP)))
+        return IsRegOperand(node->operand1, reg);
+
+    if (IsOperation(node, OP(F_MOV)))
+        return IsRegOperand(node->operand1, reg) && !OperandUsesReg(node->operand2, reg);
+
+    if (IsOperation(node, OP(F_XOR)))
+        return IsRegOperand(node->operand1, reg) && IsRegOperand(node->operand2, reg);
+
+    return false;
+}
+
+#undef OP
@@ -0,0 +1,31 @@
+#ifndef IR_PEEPHOLE_H
+#define IR_PEEPHOLE_H
+
+#include <stdio.h>
+
+#include "BackEnd/IR/IRList/IR.h"
+
+#define DEF_IR_PEEPHOLE(NAME, ...) NAME,
+enum class IRPeepholePattern
+{
+    #include "IRPeepholePatterns.h"
+
+    COUNT,
+};
+#undef DEF_IR_PEEPHOLE
+
+struct IRPeepholeStats
+{
+    size_t hits[(size_t)IRPeepholePattern::COUNT];  ///< how many times every pattern fired
+
+    size_t removedNodes;
+};
+
+IRPeepholeStats IRPeepholeStatsCtor();
+
+/// @brief Applies all patterns from IRPeepholePatterns.h until none of them fires
+void IRPeephole(IR* ir, IRPeepholeStats* stats);
+
+void IRPeepholeStatsPrint(FILE* outStream, const IRPeepholeStats* stats);
+
+#endif
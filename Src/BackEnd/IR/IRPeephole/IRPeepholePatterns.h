@@ -0,0 +1,17 @@
+#ifndef DEF_IR_PEEPHOLE
+#define DEF_IR_PEEPHOLE(...)
+#endif
+
+// DEF_IR_PEEPHOLE(NAME, DESCRIPTION)
+// Every pattern is implemented in IRPeephole.cpp as 
+//      static bool Peephole_NAME(IR* ir, IRNode* node)
+// It looks at node and the nodes after it, returns true if IR was changed.
+// Pattern must not change or remove nodes before node.
+
+DEF_IR_PEEPHOLE(PUSH_POP_CANCEL,    "F_PUSH x; F_POP x          -> -")
+DEF_IR_PEEPHOLE(PUSH_POP_TO_MOV,    "F_PUSH x; F_POP y          -> F_MOV y, x")
+DEF_IR_PEEPHOLE(PUSH_POP_AROUND,    "F_PUSH x; F_MOV y, z; F_POP x -> F_MOV y, z")
+DEF_IR_PEEPHOLE(SELF_MOV,           "F_MOV x, x / MOV x, x      -> -")
+DEF_IR_PEEPHOLE(MOV_BACK,           "F_MOV x, y; F_MOV y, x     -> F_MOV x, y")
+DEF_IR_PEEPHOLE(DEAD_F_MOV,         "F_MOV x, y; <x overwritten> -> <x overwritten>")
+DEF_IR_PEEPHOLE(FORWARD_F_MOV,      "F_MOV x, y; F_MOV z, x; <x overwritten> -> F_MOV z, y; ...")
@@ -0,0 +1,566 @@
+#include <assert.h>
+#include <stdlib.h>
+
+#include "IRRegAlloc.h"
+
+// Calling convention: XMM0 - XMM7 (args, result, expressions) are caller saved, 
+// XMM8 - XMM15 are callee saved - function saves every one of them it writes.
+// Standard library spoils only XMM0 - XMM4, so variables that live across no calls
+// can use XMM5 - XMM7 too.
+static const size_t FirstAllocXmm       = 5;
+static const size_t FirstCalleeSavedXmm = 8;
+static const size_t XmmRegsCount        = 16;
+
+static const size_t STANDARD_CAPACITY   = 64;
+static const size_t NO_POS              = SIZE_MAX;
+
+struct RegAllocInterval
+{
+    long long  memShift;    ///< home slot [RBP + memShift], Name keeps describing it
+    size_t     begin;
+    size_t     end;
+
+    bool       isParam;     ///< lives from function entry, loaded from the home slot there
+    bool       isPinned;    ///< used not only by F_MOV, stays in memory
+    bool       crossesCall; ///< needs callee saved register
+
+    IRRegister reg;         ///< NO_REG - in memory
+};
+
+struct RegAllocLoop
+{
+    size_t begin;           ///< label back jump goes to
+    size_t end;             ///< back jump
+};
+
+struct RegAllocState
+{
+    IRNode**          nodes;            ///< nodes of the current function by position
+    size_t            nodesCount;
+    size_t            nodesCapacity;
+
+    RegAllocInterval* intervals;
+    size_t            intervalsCount;
+    size_t            intervalsCapacity;
+
+    RegAllocLoop*     loops;
+    size_t            loopsCount;
+    size_t            loopsCapacity;
+
+    size_t*           calls;            ///< positions of CALL nodes
+    size_t            callsCount;
+    size_t            callsCapacity;
+
+    size_t*           labelPos;         ///< labelId -> position in the function it was met in
+
+    bool              isXmmUsed[XmmRegsCount];  ///< referenced by function code before allocation
+};
+
+static RegAllocState RegAllocStateCtor(const IR* ir);
+static void          RegAllocStateDtor(RegAllocState* state);
+
+static IRNode* CollectFuncNodes     (RegAllocState* state, const IR* ir, IRNode* funcBegin);
+static void    CollectIntervals     (RegAllocState* state);
+static void    CollectJumps         (RegAllocState* state);
+static void    ExtendOverLoops      (RegAllocState* state);
+static void    MarkCallsCrossing    (RegAllocState* state);
+static void    LinearScan           (RegAllocState* state);
+static void    RewriteFunc          (RegAllocState* state, IR* ir);
+
+static RegAllocInterval* GetInterval(RegAllocState* state, long long memShift);
+static int     IntervalsBeginCmp    (const void* lhs, const void* rhs);
+
+static inline bool   IsFuncBegin    (const IR* ir, const IRNode* node);
+static inline bool   IsVarOperand   (const IROperand operand);
+static inline bool   IsRegOperand   (const IROperand operand, IRRegister reg);
+static inline bool   IsFrameQuit    (const IRNode* node);
+static inline size_t GetXmmNum      (IRRegister reg);
+static inline IRRegister GetXmmReg  (size_t xmmNum);
+
+static void*   ArrayReserve         (void* data, size_t* capacity, size_t size, size_t elemSize);
+
+#define OP(OP_NAME)   IROperation::OP_NAME
+
+//-----------------------------------------------------------------------------
+
+void IRRegAlloc(IR* ir)
+{
+    assert(ir);
+
+    RegAllocState state = RegAllocStateCtor(ir);
+
+    IRNode* head = IRHead(ir);
+    IRNode* node = head->nextNode;
+
+    while (node != head && !IsFuncBegin(ir, node))
+        node = node->nextNode;
+
+    while (node != head)
+    {
+        IRNode* nextFunc = CollectFuncNodes(&state, ir, node);
+
+        CollectIntervals(&state);
+        CollectJumps    (&state);
+        ExtendOverLoops (&state);
+        MarkCallsCrossing(&state);
+        LinearScan      (&state);
+        RewriteFunc     (&state, ir);
+
+        node = nextFunc;
+    }
+
+    RegAllocStateDtor(&state);
+}
+
+//-----------------------------------------------------------------------------
+
+static IRNode* CollectFuncNodes(RegAllocState* state, const IR* ir, IRNode* funcBegin)
+{
+    assert(state);
+    assert(ir);
+    assert(funcBegin);
+
+    IRNode* head = IRHead(ir);
+    IRNode* node = funcBegin;
+
+    state->nodesCount = 0;
+
+    do
+    {
+        state->nodes = (IRNode**)ArrayReserve(state->nodes, &state->nodesCapacity,
+                                              state->nodesCount, sizeof(*state->nodes));
+
+        if (node->labelId != IR_NO_LABEL)
+            state->labelPos[node->labelId] = state->nodesCount;
+
+        state->nodes[state->nodesCount++] = node;
+        node = node->nextNode;
+    } while (node != head && !IsFuncBegin(ir, node));
+
+    return node;
+}
+
+static void CollectIntervals(RegAllocState* state)
+{
+    assert(state);
+
+    state->intervalsCount = 0;
+
+    for (size_t xmmNum = 0; xmmNum < XmmRegsCount; ++xmmNum)
+        state->isXmmUsed[xmmNum] = false;
+
+    for (size_t pos = 0; pos < state->nodesCount; ++pos)
+    {
+        const IRNode* node = state->nodes[pos];
+
+        const IROperand* operands[] = { &node->operand1, &node->operand2 };
+
+        for (size_t i = 0; i < node->numberOfOperands; ++i)
+        {
+            const IROperand* operand = operands[i];
+
+            if (operand->type == IROperandType::REG && GetXmmNum(operand->value.reg) < XmmRegsCount)
+                state->isXmmUsed[GetXmmNum(operand->value.reg)] = true;
+
+            if (!IsVarOperand(*operand))
+                continue;
+
+            RegAllocInterval* interval = GetInterval(state, operand->value.imm);
+
+            interval->begin     = interval->isParam ? 0 :
+                                  (interval->begin == NO_POS ? pos : interval->begin);
+            interval->end       = pos;
+            interval->isPinned |= node->operation != OP(F_MOV);
+        }
+    }
+}
+
+// Back jumps are loops
+static void CollectJumps(RegAllocState* state)
+{
+    assert(state);
+
+    state->loopsCount = 0;
+    state->callsCount = 0;
+
+    for (size_t pos = 0; pos < state->nodesCount; ++pos)
+    {
+        const IRNode* node = state->nodes[pos];
+
+        if (node->operation == OP(CALL))
+        {
+            state->calls = (size_t*)ArrayReserve(state->calls, &state->callsCapacity,
+                                                 state->callsCount, sizeof(*state->calls));
+            state->calls[state->callsCount++] = pos;
+            continue;
+        }
+
+        if (node->jumpTarget == nullptr)
+            continue;
+
+        assert(node->jumpTarget->labelId != IR_NO_LABEL);
+        size_t targetPos = state->labelPos[node->jumpTarget->labelId];
+
+        assert(targetPos < state->nodesCount && state->nodes[targetPos] == node->jumpTarget);
+        if (targetPos > pos)
+            continue;
+
+        state->loops = (RegAllocLoop*)ArrayReserve(state->loops, &state->loopsCapacity,
+                                                   state->loopsCount, sizeof(*state->loops));
+
+        state->loops[state->loopsCount++] = { targetPos, pos };
+    }
+}
+
+// Variable used inside a loop can be live around the back jump, interval covers the whole loop.
+// Extension can make interval cross outer loops, so it's repeated until nothing changes.
+static void ExtendOverLoops(RegAllocState* state)
+{
+    assert(state);
+
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+
+        for (size_t i = 0; i < state->intervalsCount; ++i)
+        {
+            RegAllocInterval* interval = &state->intervals[i];
+
+            for (size_t j = 0; j < state->loopsCount; ++j)
+            {
+                const RegAllocLoop* loop = &state->loops[j];
+
+                if (interval->begin > loop->end || interval->end < loop->begin)
+                    continue;
+
+                if (interval->begin <= loop->begin && interval->end >= loop->end)
+                    continue;
+
+                if (interval->begin > loop->begin) interval->begin = loop->begin;
+                if (interval->end   < loop->end)   interval->end   = loop->end;
+
+                changed = true;
+            }
+        }
+    }
+}
+
+static void MarkCallsCrossing(RegAllocState* state)
+{
+    assert(state);
+
+    for (size_t i = 0; i < state->intervalsCount; ++i)
+    {
+        RegAllocInterval* interval = &state->intervals[i];
+
+        for (size_t j = 0; j < state->callsCount && !interval->crossesCall; ++j)
+            interval->crossesCall = interval->begin < state->calls[j] && 
+                                    state->calls[j] < interval->end;
+    }
+}
+
+static void LinearScan(RegAllocState* state)
+{
+    assert(state);
+
+    qsort(state->intervals, state->intervalsCount, sizeof(*state->intervals), IntervalsBeginCmp);
+
+    bool isXmmFree[XmmRegsCount] = {};
+    for (size_t xmmNum = FirstAllocXmm; xmmNum < XmmRegsCount; ++xmmNum)
+        isXmmFree[xmmNum] = !state->isXmmUsed[xmmNum];
+
+    RegAllocInterval* active[XmmRegsCount] = {};
+    size_t            activeCount          = 0;
+
+    for (size_t i = 0; i < state->intervalsCount; ++i)
+    {
+        RegAllocInterval* interval = &state->intervals[i];
+
+        if (interval->isPinned)
+            continue;
+
+        for (size_t j = 0; j < activeCount; )
+        {
+            if (active[j]->end >= interval->begin)
+            {
+                ++j;
+                continue;
+            }
+
+            isXmmFree[GetXmmNum(active[j]->reg)] = true;
+            active[j] = active[--activeCount];
+        }
+
+        size_t firstXmm = interval->crossesCall ? FirstCalleeSavedXmm : FirstAllocXmm;
+
+        size_t xmmNum = firstXmm;
+        while (xmmNum < XmmRegsCount && !isXmmFree[xmmNum])
+            ++xmmNum;
+
+        if (xmmNum < XmmRegsCount)
+        {
+            isXmmFree[xmmNum] = false;
+            interval->reg     = GetXmmReg(xmmNum);
+            active[activeCount++] = interval;
+
+            continue;
+        }
+
+        // No free registers - interval that ends last stays in memory
+        size_t lastEnding = activeCount;
+        for (size_t j = 0; j < activeCount; ++j)
+        {
+            if (GetXmmNum(active[j]->reg) >= firstXmm && 
+                (lastEnding == activeCount || active[j]->end > active[lastEnding]->end))
+                lastEnding = j;
+        }
+
+        if (lastEnding == activeCount || active[lastEnding]->end <= interval->end)
+            continue;
+
+        interval->reg = active[lastEnding]->reg;
+        active[lastEnding]->reg = IRRegister::NO_REG;
+        active[lastEnding]      = interval;
+    }
+}
+
+static void RewriteFunc(RegAllocState* state, IR* ir)
+{
+    assert(state);
+    assert(ir);
+
+    // Prologue is PUSH RBP; MOV RBP, RSP; ADD RSP, -localsSize. _start has no frame
+    IRNode* frameNode = nullptr;
+    for (size_t pos = 0; pos < state->nodesCount && !frameNode; ++pos)
+    {
+        if (state->nodes[pos]->operation == OP(ADD) && 
+            IsRegOperand(state->nodes[pos]->operand1, IRRegister::RSP))
+            frameNode = state->nodes[pos];
+    }
+
+    if (frameNode == nullptr)
+        return;
+
+    bool isXmmSaved[XmmRegsCount] = {};
+    for (size_t xmmNum = FirstCalleeSavedXmm; xmmNum < XmmRegsCount; ++xmmNum)
+        isXmmSaved[xmmNum] = state->isXmmUsed[xmmNum];
+
+    for (size_t i = 0; i < state->intervalsCount; ++i)
+    {
+        size_t xmmNum = GetXmmNum(state->intervals[i].reg);
+        if (xmmNum >= FirstCalleeSavedXmm && xmmNum < XmmRegsCount)
+            isXmmSaved[xmmNum] = true;
+    }
+
+    for (size_t pos = 0; pos < state->nodesCount; ++pos)
+    {
+        IRNode* node = state->nodes[pos];
+
+        IROperand* operands[] = { &node->operand1, &node->operand2 };
+
+        for (size_t i = 0; i < node->numberOfOperands; ++i)
+        {
+            if (!IsVarOperand(*operands[i]))
+                continue;
+
+            RegAllocInterval* interval = GetInterval(state, operands[i]->value.imm);
+            if (interval->reg != IRRegister::NO_REG)
+                *operands[i] = IROperandRegCreate(interval->reg);
+        }
+    }
+
+    // Saved registers get slots below local variables
+    long long savedSlot   = frameNode->operand2.value.imm;
+    IRNode*   prologueEnd = frameNode;
+
+    for (size_t xmmNum = FirstCalleeSavedXmm; xmmNum < XmmRegsCount; ++xmmNum)
+    {
+        if (!isXmmSaved[xmmNum])
+            continue;
+
+        savedSlot -= (long long)XMM_REG_BYTE_SIZE;
+
+        IRNode* saveNode = IRNodeCreate(OP(F_MOV), IROperandMemCreate(savedSlot, IRRegister::RBP),
+                                                   IROperandRegCreate(GetXmmReg(xmmNum)));
+        IRInsertAfter(ir, prologueEnd, saveNode);
+        prologueEnd = saveNode;
+
+        for (size_t pos = 0; pos < state->nodesCount; ++pos)
+        {
+            IRNode* node = state->nodes[pos];
+            if (!IsFrameQuit(node))
+                continue;
+
+            IRInsertAfter(ir, node->prevNode,
+                          IRNodeCreate(OP(F_MOV), IROperandRegCreate(GetXmmReg(xmmNum)),
+                                                  IROperandMemCreate(savedSlot, IRRegister::RBP)));
+        }
+    }
+
+    frameNode->operand2.value.imm = savedSlot;
+
+    for (size_t i = 0; i < state->intervalsCount; ++i)
+    {
+        const RegAllocInterval* interval = &state->intervals[i];
+        if (!interval->isParam || interval->reg == IRRegister::NO_REG)
+            continue;
+
+        IRNode* loadNode = IRNodeCreate(OP(F_MOV), IROperandRegCreate(interval->reg),
+                                        IROperandMemCreate(interval->memShift, IRRegister::RBP));
+        IRInsertAfter(ir, prologueEnd, loadNode);
+        prologueEnd = loadNode;
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+static RegAllocInterval* GetInterval(RegAllocState* state, long long memShift)
+{
+    assert(state);
+
+    // Functions have few variables
+    for (size_t i = 0; i < state->intervalsCount; ++i)
+    {
+        if (state->intervals[i].memShift == memShift)
+            return &state->intervals[i];
+    }
+
+    state->intervals = (RegAllocInterval*)ArrayReserve(state->intervals, &state->intervalsCapacity,
+                                                       state->intervalsCount,
+                                                       sizeof(*state->intervals));
+
+    RegAllocInterval* interval = &state->intervals[state->intervalsCount++];
+
+    interval->memShift = memShift;
+    interval->begin    = NO_POS;
+    interval->end      = NO_POS;
+    interval->isParam  = memShift > 0;
+    interval->isPinned    = false;
+    interval->crossesCall = false;
+    interval->reg      = IRRegister::NO_REG;
+
+    return interval;
+}
+
+static int IntervalsBeginCmp(const void* lhs, const void* rhs)
+{
+    assert(lhs);
+    assert(rhs);
+
+    const RegAllocInterval* lhsInterval = (const RegAllocInterval*)lhs;
+    const RegAllocInterval* rhsInterval = (const RegAllocInterval*)rhs;
+
+    if (lhsInterval->begin != rhsInterval->begin)
+        return lhsInterval->begin < rhsInterval->begin ? -1 : 1;
+
+    // equal begins only for params, keeps the order stable
+    if (lhsInterval->memShift != rhsInterval->memShift)
+        return lhsInterval->memShift < rhsInterval->memShift ? -1 : 1;
+
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+
+static inline bool IsFuncBegin(const IR* ir, const IRNode* node)
+{
+    assert(ir);
+    assert(node);
+
+    return node->labelId != IR_NO_LABEL && ir->labels[node->labelId].type == IRLabelType::FUNC;
+}
+
+static inline bool IsVarOperand(const IROperand operand)
+{
+    return operand.type == IROperandType::MEM && operand.value.reg == IRRegister::RBP;
+}
+
+static inline bool IsRegOperand(const IROperand operand, IRRegister reg)
+{
+    return operand.type == IROperandType::REG && operand.value.reg == reg;
+}
+
+/// @brief MOV RSP, RBP - start of every function quit
+static inline bool IsFrameQuit(const IRNode* node)
+{
+    assert(node);
+
+    return node->operation == OP(MOV) && IsRegOperand(node->operand1, IRRegister::RSP) &&
+                                         IsRegOperand(node->operand2, IRRegister::RBP);
+}
+
+/// @brief XmmRegsCount if reg is not XMM
+static inline size_t GetXmmNum(IRRegister reg)
+{
+    if (reg < IRRegister::XMM0 || reg > IRRegister::XMM15)
+        return XmmRegsCount;
+
+    return (size_t)reg - (size_t)IRRegister::XMM0;
+}
+
+static inline IRRegister GetXmmReg(size_t xmmNum)
+{
+    assert(xmmNum < XmmRegsCount);
+
+    return (IRRegister)((size_t)IRRegister::XMM0 + xmmNum);
+}
+
+//-----------------------------------------------------------------------------
+
+static RegAllocState RegAllocStateCtor(const IR* ir)
+{
+    assert(ir);
+
+    RegAllocState state = {};
+
+    state.nodes             = nullptr;
+    state.nodesCount        = 0;
+    state.nodesCapacity     = 0;
+
+    state.intervals         = nullptr;
+    state.intervalsCount    = 0;
+    state.intervalsCapacity = 0;
+
+    state.loops             = nullptr;
+    state.loopsCount        = 0;
+    state.loopsCapacity     = 0;
+
+    state.calls             = nullptr;
+    state.callsCount        = 0;
+    state.callsCapacity     = 0;
+
+    state.labelPos = (size_t*)calloc(ir->labelsCount + 1, sizeof(*state.labelPos));
+    assert(state.labelPos);
+
+    return state;
+}
+
+static void RegAllocStateDtor(RegAllocState* state)
+{
+    assert(state);
+
+    free(state->nodes);
+    free(state->intervals);
+    free(state->loops);
+    free(state->calls);
+    free(state->labelPos);
+
+    *state = {};
+}
+
+static void* ArrayReserve(void* data, size_t* capacity, size_t size, size_t elemSize)
+{
+    assert(capacity);
+
+    if (size < *capacity)
+        return data;
+
+    *capacity = *capacity ? 2 * *capacity : STANDARD_CAPACITY;
+    data      = realloc(data, *capacity * elemSize);
+    assert(data);
+
+    return data;
+}
+
+#undef OP
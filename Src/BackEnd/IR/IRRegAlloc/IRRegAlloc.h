@@ -0,0 +1,12 @@
+#ifndef IR_REG_ALLOC_H
+#define IR_REG_ALLOC_H
+
+#include "BackEnd/IR/IRList/IR.h"
+
+/// @brief Linear scan register allocation for variables of every function.
+///        Variable [RBP + shift] that is only moved to / from registers gets one of
+///        XMM5 - XMM15 for its whole live interval, the rest stay in memory.
+///        Variables living across calls get callee saved XMM8 - XMM15.
+void IRRegAlloc(IR* ir);
+
+#endif
@@ -289,6 +289,72 @@ CodeArrayErrors CodeArrayPush(CodeArrayType* codeArray, const CodeArrayValue val
     return CodeArrayErrors::NO_ERR;
 }
 
+CodeArrayErrors CodeArrayReserve(CodeArrayType* codeArray, const size_t count, 
+                                 CodeArrayValue** outTail)
+{
+    assert(codeArray);
+    assert(outTail);
+
+    CODE_ARRAY_CHECK(codeArray);
+
+    while (codeArray->size + count > codeArray->capacity)
+    {
+        size_t oldCapacity = codeArray->capacity;
+
+        CodeArrayErrors codeArrayReallocErr = CodeArrayRealloc(codeArray, true);
+        IF_ERR_RETURN(codeArrayReallocErr);
+
+        if (codeArray->capacity == oldCapacity)
+            return CodeArrayErrors::MEMORY_ALLOCATION_ERROR;
+    }
+
+    *outTail = codeArray->data + codeArray->size;
+
+    return CodeArrayErrors::NO_ERR;
+}
+
+CodeArrayErrors CodeArrayCommit(CodeArrayType* codeArray, const size_t count)
+{
+    assert(codeArray);
+    assert(codeArray->size + count <= codeArray->capacity);
+
+    codeArray->size += count;
+
+    ON_HASH
+    (
+        UpdateDataHash(codeArray);
+        UpdateStructHash(codeArray);
+    )
+
+    CODE_ARRAY_CHECK(codeArray);
+
+    return CodeArrayErrors::NO_ERR;
+}
+
+CodeArrayErrors CodeArrayPatch(CodeArrayType* codeArray, const size_t pos,
+                               const CodeArrayValue* values, const size_t count)
+{
+    assert(codeArray);
+    assert(values);
+
+    CODE_ARRAY_CHECK(codeArray);
+
+    if (pos + count > codeArray->size)
+        return CodeArrayErrors::SIZE_OUT_OF_RANGE;
+
+    memcpy(codeArray->data + pos, values, count * sizeof(*values));
+
+    ON_HASH
+    (
+        UpdateDataHash(codeArray);
+        UpdateStructHash(codeArray);
+    )
+
+    CODE_ARRAY_CHECK(codeArray);
+
+    return CodeArrayErrors::NO_ERR;
+}
+
 CodeArrayErrors CodeArrayFind(const CodeArrayType* table, const CodeArrayValue value, CodeArrayValue** outVal)
 {
     assert(table);
@@ -113,6 +113,15 @@ CodeArrayErrors CodeArrayDtor(CodeArrayType* const stk);
 /// @return errors that occurred
 CodeArrayErrors CodeArrayPush(CodeArrayType* stk, const CodeArrayValue val);
 
+/// @brief Makes room for count values after the last one, outTail points to it.
+///        Values written there become a part of array after CodeArrayCommit
+CodeArrayErrors CodeArrayReserve(CodeArrayType* stk, const size_t count, CodeArrayValue** outTail);
+CodeArrayErrors CodeArrayCommit (CodeArrayType* stk, const size_t count);
+
+/// @brief Overwrites count already pushed values starting from pos
+CodeArrayErrors CodeArrayPatch  (CodeArrayType* stk, const size_t pos, 
+                                 const CodeArrayValue* values, const size_t count);
+
 CodeArrayErrors CodeArrayFind(const CodeArrayType* table, const CodeArrayValue value, CodeArrayValue** outVal);
 
 CodeArrayErrors CodeArrayGetPos(const CodeArrayType* table, CodeArrayValue* namePtr, size_t* outPos);
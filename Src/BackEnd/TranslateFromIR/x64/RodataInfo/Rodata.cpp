@@ -1,10 +1,49 @@
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
 #include "Rodata.h"
 
+static const size_t STANDARD_CAPACITY       = 16;
+static const size_t STANDARD_INDEX_CAPACITY = 2 * STANDARD_CAPACITY;
+
+static inline uint64_t RodataHash           (uint64_t key);
+static inline uint64_t RodataImmediateBits  (long long imm);
+
+static void   RodataIndexInsert       (size_t* index, size_t indexCapacity, uint64_t hash, size_t pos);
+static void   RodataImmediatesIndexRebuild(RodataInfo* info, size_t newCapacity);
+static void   RodataStringsIndexRebuild   (RodataInfo* info, size_t newCapacity);
+
+static void   RodataShareStringTails  (RodataInfo* info);
+static int    RodataReversedStringsCmp(const void* lhs, const void* rhs);
+
+static inline uint64_t AlignUp(uint64_t value, uint64_t alignment);
+
+//-----------------------------------------------------------------------------
+
 RodataInfo RodataInfoCtor()
 {
     RodataInfo info = {};
-    RodataImmediatesCtor(&info.rodataImmediates);
-    RodataStringsCtor   (&info.rodataStrings);
+
+    info.immediates              = nullptr;
+    info.immediatesCount         = 0;
+    info.immediatesCapacity      = 0;
+    info.immediatesIndex         = nullptr;
+    info.immediatesIndexCapacity = 0;
+
+    info.strings                 = nullptr;
+    info.stringsCount            = 0;
+    info.stringsCapacity         = 0;
+    info.stringsIndex            = nullptr;
+    info.stringsIndexCapacity    = 0;
+
+    info.immediatesAddr          = 0;
+    info.stringsAddr             = 0;
+    info.endAddr                 = 0;
+    info.isLaidOut               = false;
+
+    RodataImmediatesIndexRebuild(&info, STANDARD_INDEX_CAPACITY);
+    RodataStringsIndexRebuild   (&info, STANDARD_INDEX_CAPACITY);
 
     return info;
 }
@@ -13,9 +52,305 @@ void RodataInfoDtor(RodataInfo* info)
 {
     assert(info);
 
-    RodataImmediatesDtor(info->rodataImmediates);
-    RodataStringsDtor   (info->rodataStrings);
+    free(info->immediates);
+    free(info->immediatesIndex);
+    free(info->strings);
+    free(info->stringsIndex);
+
+    *info = {};
+}
+
+//-----------------------------------------------------------------------------
+
+size_t RodataAddImmediate(RodataInfo* info, long long imm)
+{
+    assert(info);
+    assert(!info->isLaidOut);
+
+    size_t pos = RodataFindImmediate(info, imm);
+    if (pos != NO_RODATA_ENTRY)
+        return pos;
+
+    if (info->immediatesCount == info->immediatesCapacity)
+    {
+        info->immediatesCapacity = info->immediatesCapacity ? 2 * info->immediatesCapacity
+                                                            : STANDARD_CAPACITY;
+        info->immediates = (RodataImmediate*)realloc(info->immediates,
+                                            info->immediatesCapacity * sizeof(*info->immediates));
+        assert(info->immediates);
+    }
+
+    pos = info->immediatesCount++;
+
+    info->immediates[pos].imm     = imm;
+    info->immediates[pos].bits    = RodataImmediateBits(imm);
+    info->immediates[pos].asmAddr = 0;
+
+    if (2 * info->immediatesCount > info->immediatesIndexCapacity)
+        RodataImmediatesIndexRebuild(info, 2 * info->immediatesIndexCapacity);
+    else
+        RodataIndexInsert(info->immediatesIndex, info->immediatesIndexCapacity,
+                          RodataHash(info->immediates[pos].bits), pos);
+
+    return pos;
+}
+
+size_t RodataAddString(RodataInfo* info, const char* string)
+{
+    assert(info);
+    assert(string);
+    assert(!info->isLaidOut);
+
+    size_t pos = RodataFindString(info, string);
+    if (pos != NO_RODATA_ENTRY)
+        return pos;
+
+    if (info->stringsCount == info->stringsCapacity)
+    {
+        info->stringsCapacity = info->stringsCapacity ? 2 * info->stringsCapacity
+                                                      : STANDARD_CAPACITY;
+        info->strings = (RodataString*)realloc(info->strings,
+                                               info->stringsCapacity * sizeof(*info->strings));
+        assert(info->strings);
+    }
+
+    pos = info->stringsCount++;
+
+    InternId stringId = StringIntern(string);
+
+    info->strings[pos].string   = StringInternGet(stringId);
+    info->strings[pos].stringId = stringId;
+    info->strings[pos].length   = strlen(string);
+    info->strings[pos].owner    = pos;
+    info->strings[pos].asmAddr  = 0;
+
+    if (2 * info->stringsCount > info->stringsIndexCapacity)
+        RodataStringsIndexRebuild(info, 2 * info->stringsIndexCapacity);
+    else
+        RodataIndexInsert(info->stringsIndex, info->stringsIndexCapacity,
+                          RodataHash(stringId), pos);
+
+    return pos;
+}
+
+size_t RodataFindImmediate(const RodataInfo* info, long long imm)
+{
+    assert(info);
+    assert(info->immediatesIndex);
+
+    uint64_t bits = RodataImmediateBits(imm);
+    size_t   mask = info->immediatesIndexCapacity - 1;
+
+    for (size_t cell = RodataHash(bits) & mask; info->immediatesIndex[cell] != 0;
+                cell = (cell + 1) & mask)
+    {
+        size_t pos = info->immediatesIndex[cell] - 1;
+
+        if (info->immediates[pos].bits == bits)
+            return pos;
+    }
+
+    return NO_RODATA_ENTRY;
+}
+
+size_t RodataFindString(const RodataInfo* info, const char* string)
+{
+    assert(info);
+    assert(string);
+    assert(info->stringsIndex);
+
+    InternId stringId = StringInternFind(string);
+    if (stringId == NO_INTERN_ID)
+        return NO_RODATA_ENTRY;
+
+    size_t mask = info->stringsIndexCapacity - 1;
+
+    for (size_t cell = RodataHash(stringId) & mask; info->stringsIndex[cell] != 0;
+                cell = (cell + 1) & mask)
+    {
+        size_t pos = info->stringsIndex[cell] - 1;
+
+        if (info->strings[pos].stringId == stringId)
+            return pos;
+    }
+
+    return NO_RODATA_ENTRY;
+}
+
+//-----------------------------------------------------------------------------
+
+void RodataLayout(RodataInfo* info, uint64_t beginAddr)
+{
+    assert(info);
+    assert(!info->isLaidOut);
+
+    info->immediatesAddr = AlignUp(beginAddr, RODATA_IMMEDIATE_SLOT_SIZE);
+
+    for (size_t i = 0; i < info->immediatesCount; ++i)
+        info->immediates[i].asmAddr = info->immediatesAddr + i * RODATA_IMMEDIATE_SLOT_SIZE;
+
+    info->stringsAddr = info->immediatesAddr + info->immediatesCount * RODATA_IMMEDIATE_SLOT_SIZE;
+
+    RodataShareStringTails(info);
+
+    uint64_t asmAddr = info->stringsAddr;
+    for (size_t i = 0; i < info->stringsCount; ++i)
+    {
+        RodataString* string = &info->strings[i];
+        if (string->owner != i)
+            continue;
 
-    info->rodataImmediates = nullptr;
-    info->rodataStrings    = nullptr;
-}
\ No newline at end of file
+        string->asmAddr = asmAddr;
+        asmAddr += string->length + 1;
+    }
+
+    for (size_t i = 0; i < info->stringsCount; ++i)
+    {
+        RodataString* string = &info->strings[i];
+        if (string->owner == i)
+            continue;
+
+        const RodataString* owner = &info->strings[string->owner];
+        string->asmAddr = owner->asmAddr + owner->length - string->length;
+    }
+
+    info->endAddr   = asmAddr;
+    info->isLaidOut = true;
+}
+
+// Sorted by reversed contents, every string is followed by the strings it's a tail of,
+// so walking from the end gives each string the longest string that contains it as a tail.
+static void RodataShareStringTails(RodataInfo* info)
+{
+    assert(info);
+
+    if (info->stringsCount == 0)
+        return;
+
+    const RodataString** sorted = (const RodataString**)calloc(info->stringsCount,
+                                                               sizeof(*sorted));
+    assert(sorted);
+
+    for (size_t i = 0; i < info->stringsCount; ++i)
+        sorted[i] = &info->strings[i];
+
+    qsort(sorted, info->stringsCount, sizeof(*sorted), RodataReversedStringsCmp);
+
+    for (size_t i = info->stringsCount - 1; i > 0; --i)
+    {
+        const RodataString* tail   = sorted[i - 1];
+        const RodataString* string = sorted[i];
+
+        if (tail->length > string->length ||
+            strcmp(string->string + string->length - tail->length, tail->string) != 0)
+            continue;
+
+        info->strings[tail - info->strings].owner = string->owner;
+    }
+
+    free(sorted);
+}
+
+static int RodataReversedStringsCmp(const void* lhs, const void* rhs)
+{
+    assert(lhs);
+    assert(rhs);
+
+    const RodataString* lhsString = *(const RodataString* const*)lhs;
+    const RodataString* rhsString = *(const RodataString* const*)rhs;
+
+    size_t lhsPos = lhsString->length;
+    size_t rhsPos = rhsString->length;
+
+    while (lhsPos > 0 && rhsPos > 0)
+    {
+        --lhsPos;
+        --rhsPos;
+
+        unsigned char lhsChar = (unsigned char)lhsString->string[lhsPos];
+        unsigned char rhsChar = (unsigned char)rhsString->string[rhsPos];
+
+        if (lhsChar != rhsChar)
+            return lhsChar < rhsChar ? -1 : 1;
+    }
+
+    if (lhsPos == rhsPos)
+        return 0;
+
+    return lhsPos == 0 ? -1 : 1;
+}
+
+//-----------------------------------------------------------------------------
+
+static void RodataIndexInsert(size_t* index, size_t indexCapacity, uint64_t hash, size_t pos)
+{
+    assert(index);
+    assert((indexCapacity & (indexCapacity - 1)) == 0);
+
+    size_t mask = indexCapacity - 1;
+    size_t cell = hash & mask;
+
+    while (index[cell] != 0)
+        cell = (cell + 1) & mask;
+
+    index[cell] = pos + 1;
+}
+
+static void RodataImmediatesIndexRebuild(RodataInfo* info, size_t newCapacity)
+{
+    assert(info);
+
+    size_t* newIndex = (size_t*)calloc(newCapacity, sizeof(*newIndex));
+    assert(newIndex);
+
+    free(info->immediatesIndex);
+    info->immediatesIndex         = newIndex;
+    info->immediatesIndexCapacity = newCapacity;
+
+    for (size_t i = 0; i < info->immediatesCount; ++i)
+        RodataIndexInsert(newIndex, newCapacity, RodataHash(info->immediates[i].bits), i);
+}
+
+static void RodataStringsIndexRebuild(RodataInfo* info, size_t newCapacity)
+{
+    assert(info);
+
+    size_t* newIndex = (size_t*)calloc(newCapacity, sizeof(*newIndex));
+    assert(newIndex);
+
+    free(info->stringsIndex);
+    info->stringsIndex         = newIndex;
+    info->stringsIndexCapacity = newCapacity;
+
+    for (size_t i = 0; i < info->stringsCount; ++i)
+        RodataIndexInsert(newIndex, newCapacity, RodataHash(info->strings[i].stringId), i);
+}
+
+//-----------------------------------------------------------------------------
+
+static inline uint64_t RodataHash(uint64_t key)
+{
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdULL;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ULL;
+    key ^= key >> 33;
+
+    return key;
+}
+
+static inline uint64_t RodataImmediateBits(long long imm)
+{
+    double   value = (double)imm;
+    uint64_t bits  = 0;
+    memcpy(&bits, &value, sizeof(bits));
+
+    return bits;
+}
+
+static inline uint64_t AlignUp(uint64_t value, uint64_t alignment)
+{
+    assert((alignment & (alignment - 1)) == 0);
+
+    return (value + alignment - 1) & ~(alignment - 1);
+}
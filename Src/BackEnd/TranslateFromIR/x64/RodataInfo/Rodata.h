@@ -1,16 +1,73 @@
 #ifndef RODATA_H
 #define RODATA_H
 
-#include "RodataImmediates/RodataImmediates.h"
-#include "RodataStrings/RodataStrings.h"
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Common/StringIntern.h"
+
+// Constant pool of the program. Constants are added while code is emitted,
+// RodataLayout assigns addresses once, after that pool is only looked up.
+
+/// @brief Double slots are 16 bytes (value + zero) and 16 aligned, so any slot is valid m128 operand
+static const uint64_t RODATA_IMMEDIATE_SLOT_SIZE = 16;
+
+static const size_t   NO_RODATA_ENTRY = SIZE_MAX;
+
+struct RodataImmediate
+{
+    long long imm;
+    uint64_t  bits;         ///< bit pattern of (double)imm, pool key
+
+    uint64_t  asmAddr;
+};
+
+struct RodataString
+{
+    const char* string;     ///< interned
+    InternId    stringId;   ///< pool key
+    size_t      length;
+
+    size_t      owner;      ///< string this one is a tail of (itself if not shared)
+    uint64_t    asmAddr;
+};
 
 struct RodataInfo
 {
-    RodataImmediatesType* rodataImmediates;
-    RodataStringsType*    rodataStrings;
+    RodataImmediate* immediates;
+    size_t           immediatesCount;
+    size_t           immediatesCapacity;
+
+    size_t*          immediatesIndex;       ///< open addressing, stores pos + 1, 0 - empty
+    size_t           immediatesIndexCapacity;
+
+    RodataString*    strings;
+    size_t           stringsCount;
+    size_t           stringsCapacity;
+
+    size_t*          stringsIndex;          ///< open addressing, stores pos + 1, 0 - empty
+    size_t           stringsIndexCapacity;
+
+    uint64_t         immediatesAddr;        ///< first slot address (after alignment padding)
+    uint64_t         stringsAddr;
+    uint64_t         endAddr;
+
+    bool             isLaidOut;
 };
 
 RodataInfo RodataInfoCtor();
 void       RodataInfoDtor(RodataInfo* info);
 
-#endif
\ No newline at end of file
+/// @brief Adds constant if it's not in the pool yet. Returns its position
+size_t RodataAddImmediate   (RodataInfo* info, long long imm);
+size_t RodataAddString      (RodataInfo* info, const char* string);
+
+/// @brief Returns position of the constant or NO_RODATA_ENTRY
+size_t RodataFindImmediate  (const RodataInfo* info, long long imm);
+size_t RodataFindString     (const RodataInfo* info, const char* string);
+
+/// @brief Assigns addresses from beginAddr: aligned double slots, then strings
+///        (strings that are tails of other strings share their bytes)
+void   RodataLayout         (RodataInfo* info, uint64_t beginAddr);
+
+#endif
@@ -12,8 +12,8 @@ static void LoadStdLibCode(FILE* outBinary);
 
 static void LoadStdLibRodata(FILE* outBinary, uint64_t* asmAddr);
 
-static void LoadRodataImmediates(RodataImmediatesType* immediates, FILE* outBinary, uint64_t* asmAddr);
-static void LoadRodataStrings   (RodataStringsType*    strings,    FILE* outBinary, uint64_t* asmAddr);
+static void LoadRodataImmediates(const RodataInfo* rodata, FILE* outBinary, uint64_t* asmAddr);
+static void LoadRodataStrings   (const RodataInfo* rodata, FILE* outBinary, uint64_t* asmAddr);
 
 enum class HeaderPos
 {
@@ -175,9 +175,14 @@ void LoadRodata(RodataInfo* rodata, FILE* outBinary)
     uint64_t asmAddr = (uint64_t)SegmentAddress::RODATA;
 
     fseek(outBinary, (long)SegmentFilePos::RODATA, SEEK_SET);
-    LoadStdLibRodata    (outBinary, &asmAddr);
-    LoadRodataImmediates(rodata->rodataImmediates, outBinary, &asmAddr);
-    LoadRodataStrings   (rodata->rodataStrings,    outBinary, &asmAddr);
+    LoadStdLibRodata(outBinary, &asmAddr);
+
+    RodataLayout(rodata, asmAddr);
+
+    LoadRodataImmediates(rodata, outBinary, &asmAddr);
+    LoadRodataStrings   (rodata, outBinary, &asmAddr);
+
+    assert(asmAddr == rodata->endAddr);
 
     // Load rodata pheader 
     Elf64_Phdr rodataPheader = RodataPheader;
@@ -190,41 +195,43 @@ void LoadRodata(RodataInfo* rodata, FILE* outBinary)
     fwrite(&rodataPheader, sizeof(rodataPheader), 1, outBinary);
 }
 
-static void LoadRodataImmediates(RodataImmediatesType* immediates, FILE* outBinary, uint64_t* asmAddr)
+static void LoadRodataImmediates(const RodataInfo* rodata, FILE* outBinary, uint64_t* asmAddr)
 {
-    assert(immediates);
+    assert(rodata);
     assert(outBinary);
     assert(asmAddr);
+
+    for (; *asmAddr < rodata->immediatesAddr; ++*asmAddr)
+        fputc(0, outBinary);
     
-    for (size_t i = 0; i < immediates->size; ++i)
+    for (size_t i = 0; i < rodata->immediatesCount; ++i)
     {
-        long long imm = immediates->data[i].imm;
-        double value = (double)imm;
+        assert(rodata->immediates[i].asmAddr == *asmAddr);
 
-        fwrite(&value, sizeof(value), 1, outBinary);
+        double slot[RODATA_IMMEDIATE_SLOT_SIZE / sizeof(double)] = {};
+        slot[0] = (double)rodata->immediates[i].imm;
 
-        immediates->data[i].asmAddr = *asmAddr;
-        *asmAddr += sizeof(value);
+        fwrite(slot, sizeof(slot), 1, outBinary);
+        *asmAddr += sizeof(slot);
     }
 }
 
-static void LoadRodataStrings(RodataStringsType* strings, FILE* outBinary, uint64_t* asmAddr)
+static void LoadRodataStrings(const RodataInfo* rodata, FILE* outBinary, uint64_t* asmAddr)
 {
-    assert(strings);
+    assert(rodata);
     assert(outBinary);
     assert(asmAddr);
 
-    for (size_t i = 0; i < strings->size; ++i)
+    for (size_t i = 0; i < rodata->stringsCount; ++i)
     {
-        const char* string = strings->data[i].string;
-        
-        int putsRes = fputs(string, outBinary);
-        assert(putsRes != EOF);
-        putsRes     = fputc('\0', outBinary);
-        assert(putsRes != EOF);
-
-        strings->data[i].asmAddr = *asmAddr;
-        *asmAddr += strlen(string) + 1;
+        const RodataString* string = &rodata->strings[i];
+        if (string->owner != i) // bytes are shared with owner string
+            continue;
+
+        assert(string->asmAddr == *asmAddr);
+
+        fwrite(string->string, string->length + 1, 1, outBinary);
+        *asmAddr += string->length + 1;
     }
 }
 
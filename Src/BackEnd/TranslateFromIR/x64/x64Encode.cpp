@@ -27,8 +27,10 @@ struct X64Instruction
         bool requireModRM               : 1;
         bool requireSIB                 : 1;
         bool requireDisp32              : 1;
+        bool requireDisp8               : 1;
         bool requireImm32               : 1;
         bool requireImm16               : 1;
+        bool requireImm8                : 1;
     };
 
     uint8_t mandatoryPrefix;
@@ -40,8 +42,10 @@ struct X64Instruction
     uint8_t sib;
 
     int32_t disp32;
+    int8_t  disp8;
     int32_t imm32;
     int16_t imm16;
+    int8_t  imm8;
 };
 
 enum class X64OperandByteTarget
@@ -53,6 +57,7 @@ enum class X64OperandByteTarget
 
     IMM32,
     IMM16,      ///< for RET instruction
+    IMM8,       ///< for short jumps
 };
 
 static inline void SetOperands(X64Instruction* instruction, size_t numberOfOperands,
@@ -74,19 +79,24 @@ static inline void SetRegInOpcode               (X64Instruction* instruction, X6
 static inline void SetModRmReg                  (X64Instruction* instruction, X64Operand operand);
 static inline void SetModRmDirectAddressingMod  (X64Instruction* instruction);
 static inline void SetModRmRmToReg              (X64Instruction* instruction, X64Operand operand);
-static inline void SetModRmSibDisp32Mod         (X64Instruction* instruction);
+static inline void SetModRmBaseDispMod          (X64Instruction* instruction, 
+                                                 uint8_t baseLowBits, int disp);
 static inline void SetModRmModField             (X64Instruction* instruction, uint8_t mod);
 static inline void SetModRmRegField             (X64Instruction* instruction, uint8_t bits);
-static inline void SetSibBaseAndDisp32          (X64Instruction* instruction, X64Operand operand);
+static inline void SetBaseAndDisp               (X64Instruction* instruction, X64Operand operand);
 static inline void SetSibIndex                  (X64Instruction* instruction, uint8_t index);
 static inline void SetSibBase                   (X64Instruction* instruction, uint8_t base);
 static inline void SetDisp32                    (X64Instruction* instruction, X64Operand operand);
+static inline void SetDisp8                     (X64Instruction* instruction, X64Operand operand);
 static inline void SetModRmRipAddressing        (X64Instruction* instruction);
 static inline void SetModRmRmField              (X64Instruction* instruction, uint8_t rmBits);
 static inline void SetRipAddressing             (X64Instruction* instruction, X64Operand operand);
 static inline void SetAbsoluteAddressing        (X64Instruction* instruction, X64Operand operand);
 static inline void SetImm32                     (X64Instruction* instruction, X64Operand operand);
 static inline void SetImm16                     (X64Instruction* instruction, X64Operand operand);
+static inline void SetImm8                      (X64Instruction* instruction, X64Operand operand);
+
+static inline bool FitsInImm8(int value);
 
 static X64Instruction X64InstructionCtor();
 
@@ -107,65 +117,107 @@ static X64Instruction X64InstructionInit(X64Operation operation, size_t numberOf
 
 //-----------------------------------------------------------------------------
 
-uint8_t* EncodeX64(X64Operation operation, size_t numberOfOperands, 
-                   X64Operand operand1, X64Operand operand2, 
-                   size_t* outInstructionLen)
+size_t EncodeX64(uint8_t* outBytes, X64Operation operation, size_t numberOfOperands, 
+                 X64Operand operand1, X64Operand operand2)
 {
+    assert(outBytes);
+
     X64Instruction instruction = X64InstructionInit(operation, numberOfOperands, 
                                                     operand1, operand2);
 
-    static const size_t maxInstructionLen = 16;
-    uint8_t* instructionBytes = (uint8_t*)calloc(maxInstructionLen, sizeof(*instructionBytes));
-
     size_t instructionLen = 0;
 
     if (instruction.requireMandatoryPrefix) 
-        instructionBytes[instructionLen++] = instruction.mandatoryPrefix;
+        outBytes[instructionLen++] = instruction.mandatoryPrefix;
     if (instruction.requireREX)
-        instructionBytes[instructionLen++] = instruction.rex;
+        outBytes[instructionLen++] = instruction.rex;
     if (instruction.requireOpcodePrefix1)
-        instructionBytes[instructionLen++] = instruction.opcodePrefix1;
+        outBytes[instructionLen++] = instruction.opcodePrefix1;
     if (instruction.requireOpcodePrefix2)
-        instructionBytes[instructionLen++] = instruction.opcodePrefix2;
+        outBytes[instructionLen++] = instruction.opcodePrefix2;
 
-    instructionBytes[instructionLen++] = instruction.opcode;
+    outBytes[instructionLen++] = instruction.opcode;
 
     if (instruction.requireModRM)
-        instructionBytes[instructionLen++] = instruction.modRM;
+        outBytes[instructionLen++] = instruction.modRM;
     if (instruction.requireSIB)
-        instructionBytes[instructionLen++] = instruction.sib;
+        outBytes[instructionLen++] = instruction.sib;
+    if (instruction.requireDisp8)
+        outBytes[instructionLen++] = (uint8_t)instruction.disp8;
     if (instruction.requireDisp32)
     {
-        memcpy(instructionBytes + instructionLen, &instruction.disp32, sizeof(instruction.disp32));
+        memcpy(outBytes + instructionLen, &instruction.disp32, sizeof(instruction.disp32));
         instructionLen += sizeof(instruction.disp32);
     }
     if (instruction.requireImm16)
     {
-        memcpy(instructionBytes + instructionLen, &instruction.imm16, sizeof(instruction.imm16));
+        memcpy(outBytes + instructionLen, &instruction.imm16, sizeof(instruction.imm16));
         instructionLen += sizeof(instruction.imm16);
     }
     if (instruction.requireImm32)
     {
-        memcpy(instructionBytes + instructionLen, &instruction.imm32, sizeof(instruction.imm32));
+        memcpy(outBytes + instructionLen, &instruction.imm32, sizeof(instruction.imm32));
         instructionLen += sizeof(instruction.imm32);
     }
+    if (instruction.requireImm8)
+        outBytes[instructionLen++] = (uint8_t)instruction.imm8;
     
-    assert(instructionLen <= maxInstructionLen);
+    assert(instructionLen <= X64MaxInstructionLen);
+
+    return instructionLen;
+}
+
+size_t EncodeX64(CodeArrayType* code, X64Operation operation, size_t numberOfOperands, 
+                 X64Operand operand1, X64Operand operand2)
+{
+    assert(code);
 
-    *outInstructionLen = instructionLen;
-    return instructionBytes;
+    CodeArrayValue* codeTail = nullptr;
+    CodeArrayErrors err = CodeArrayReserve(code, X64MaxInstructionLen, &codeTail);
+    assert(err == CodeArrayErrors::NO_ERR);
+
+    size_t instructionLen = EncodeX64(codeTail, operation, numberOfOperands, operand1, operand2);
+
+    CodeArrayCommit(code, instructionLen);
+
+    return instructionLen;
 }
 
-uint8_t* EncodeX64(X64Operation operation, X64Operand operand1, X64Operand operand2, 
-                   size_t* outInstructionLen)
+size_t EncodeX64(CodeArrayType* code, X64Operation operation, 
+                 X64Operand operand1, X64Operand operand2)
 {
-    return EncodeX64(operation, 2, operand1, operand2, outInstructionLen);
+    return EncodeX64(code, operation, 2, operand1, operand2);
 }
 
-uint8_t* EncodeX64(X64Operation operation, X64Operand operand, size_t* outInstructionLen)
+size_t EncodeX64(CodeArrayType* code, X64Operation operation, X64Operand operand)
 {
     X64Operand emptyOperand = {};
-    return EncodeX64(operation, 1, operand, emptyOperand, outInstructionLen);
+    return EncodeX64(code, operation, 1, operand, emptyOperand);
+}
+
+bool X64GetShortJump(X64Operation jump, X64Operation* outShortJump)
+{
+    assert(outShortJump);
+
+#define CASE(JUMP)                                  \
+    case X64Operation::JUMP:                        \
+        *outShortJump = X64Operation::JUMP##_SHORT; \
+        return true;
+
+    switch (jump)
+    {
+        CASE(JMP);
+        CASE(JE);
+        CASE(JNE);
+        CASE(JB);
+        CASE(JBE);
+        CASE(JA);
+        CASE(JAE);
+
+        default:
+            return false;
+    }
+#undef CASE
 }
 
 //-----------------------------------------------------------------------------
@@ -334,8 +386,10 @@ static X64Instruction X64InstructionCtor()
     SET_0(requireModRM);
     SET_0(requireSIB);
     SET_0(requireDisp32);
+    SET_0(requireDisp8);
     SET_0(requireImm32);
     SET_0(requireImm16);
+    SET_0(requireImm8);
 
     SET_0(mandatoryPrefix);
     SET_0(rex);
@@ -345,8 +399,10 @@ static X64Instruction X64InstructionCtor()
     SET_0(modRM);
     SET_0(sib);
     SET_0(disp32);
+    SET_0(disp8);
     SET_0(imm32);
     SET_0(imm16);
+    SET_0(imm8);
 #undef SET_0
 
     SetRexDefault(&instruction);
@@ -450,6 +506,16 @@ static inline void SetOperand (X64Instruction* instruction,
             break;
         }
 
+        case BYTE_TARGET(IMM8):
+        {
+            assert(operand.type == X64OperandType::IMM);
+            
+            instruction->requireImm8 = true;
+            SetImm8(instruction, operand);
+
+            break;
+        }
+
         default: // Unreachable
             assert(false);
             break;
@@ -484,11 +550,8 @@ static inline void SetModRmRmOperand(X64Instruction* instruction, X64Operand ope
             else
             {
                 assert(operand.value.reg != X64Register::NO_REG);
-                
-                instruction->requireSIB    = true;
-                instruction->requireDisp32 = true;
 
-                SetSibBaseAndDisp32(instruction, operand);
+                SetBaseAndDisp(instruction, operand);
             }
 
             break;
@@ -548,14 +611,27 @@ static inline void SetModRmRmToReg(X64Instruction* instruction, X64Operand opera
 #undef DEF_X64_REG
 }
 
-static inline void SetModRmSibDisp32Mod(X64Instruction* instruction)
+// Shortest mod for [base + disp]: no displacement, disp8 or disp32. 
+// rm = 0b101 with mod = 0 means RIP / absolute addressing, so RBP and R13 always have disp.
+static inline void SetModRmBaseDispMod(X64Instruction* instruction, uint8_t baseLowBits, int disp)
 {
-    static const size_t sibDisp32Mod = 2; // 0b10
-
-    SetModRmModField(instruction, sibDisp32Mod);
+    static const uint8_t noDispMod       = 0; // 0b00
+    static const uint8_t disp8Mod        = 1; // 0b01
+    static const uint8_t disp32Mod       = 2; // 0b10
+    static const uint8_t ripRelativeBits = 5; // 0b101
 
-    static const size_t sibDisp32RmBits = 4; // 0b100
-    SetModRmRmField(instruction, sibDisp32RmBits);
+    if (disp == 0 && baseLowBits != ripRelativeBits)
+        SetModRmModField(instruction, noDispMod);
+    else if (FitsInImm8(disp))
+    {
+        SetModRmModField(instruction, disp8Mod);
+        instruction->requireDisp8 = true;
+    }
+    else
+    {
+        SetModRmModField(instruction, disp32Mod);
+        instruction->requireDisp32 = true;
+    }
 }
 
 static inline void SetModRmModField(X64Instruction* instruction, uint8_t mod)
@@ -572,17 +648,13 @@ static inline void SetModRmRegField(X64Instruction* instruction, uint8_t bits)
     instruction->modRM |= (bits << regFieldShift);
 }
 
-static inline void SetSibBaseAndDisp32(X64Instruction* instruction, X64Operand operand)
+static inline void SetBaseAndDisp(X64Instruction* instruction, X64Operand operand)
 {
-    SetModRmSibDisp32Mod(instruction);
-
-    static const uint8_t baseDisp32Index = 4; // 0100
-
-    SetSibIndex(instruction, baseDisp32Index);
+    uint8_t baseLowBits = 0;
 
 #define DEF_X64_REG(REG, LOW_BITS, HIGH_BIT, ...)               \
     case X64Register::REG:                                      \
-        SetSibBase(instruction, LOW_BITS);                      \
+        baseLowBits = LOW_BITS;                                 \
         if (HIGH_BIT) SetRexB(instruction);                     \
         break;
 
@@ -595,7 +667,28 @@ static inline void SetSibBaseAndDisp32(X64Instruction* instruction, X64Operand o
             break;
     }
 #undef DEF_X64_REG
-    SetDisp32(instruction, operand);
+
+    // rm = 0b100 means SIB follows, so RSP and R12 can be base only through SIB
+    static const uint8_t sibRmBits  = 4; // 0b100
+    static const uint8_t noSibIndex = 4; // 0b100
+
+    if (baseLowBits == sibRmBits)
+    {
+        instruction->requireSIB = true;
+
+        SetModRmRmField(instruction, sibRmBits);
+        SetSibIndex    (instruction, noSibIndex);
+        SetSibBase     (instruction, baseLowBits);
+    }
+    else
+        SetModRmRmField(instruction, baseLowBits);
+
+    SetModRmBaseDispMod(instruction, baseLowBits, operand.value.imm);
+
+    if (instruction->requireDisp8)
+        SetDisp8 (instruction, operand);
+    else if (instruction->requireDisp32)
+        SetDisp32(instruction, operand);
 }
 
 static inline void SetSibIndex(X64Instruction* instruction, uint8_t index)
@@ -617,6 +710,13 @@ static inline void SetDisp32(X64Instruction* instruction, X64Operand operand)
     instruction->disp32 = operand.value.imm;
 }
 
+static inline void SetDisp8(X64Instruction* instruction, X64Operand operand)
+{
+    assert(FitsInImm8(operand.value.imm));
+
+    instruction->disp8 = (int8_t)operand.value.imm;
+}
+
 static inline void SetModRmRipAddressing(X64Instruction* instruction)
 {
     static uint8_t modRmRipAddressingMod = 0;
@@ -666,6 +766,18 @@ static inline void SetImm16(X64Instruction* instruction, X64Operand operand)
     instruction->imm16 = (int16_t)operand.value.imm;
 }
 
+static inline void SetImm8(X64Instruction* instruction, X64Operand operand)
+{
+    assert(FitsInImm8(operand.value.imm));
+
+    instruction->imm8 = (int8_t)operand.value.imm;
+}
+
+static inline bool FitsInImm8(int value)
+{
+    return INT8_MIN <= value && value <= INT8_MAX;
+}
+
 static inline void SetRexDefault (X64Instruction* instruction)
 {
     instruction->rex = 0x40;
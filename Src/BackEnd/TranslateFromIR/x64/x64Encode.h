@@ -3,6 +3,7 @@
 
 #include <stdint.h>
 #include "BackEnd/IR/IRList/IR.h"
+#include "CodeArray/CodeArray.h"
 
 #define DEF_X64_REG(REG, ...) REG,
 enum class X64Register
@@ -46,13 +47,23 @@ X64OperandValue ConvertIRToX64OperandValue  (IROperandValue value);
 X64OperandType  ConvertIRToX64OperandType   (IROperandType type);
 X64Register     ConvertIRToX64Register      (IRRegister reg);
 
-uint8_t* EncodeX64(X64Operation operation, size_t numberOfOperands, 
-                   X64Operand operand1, X64Operand operand2, 
-                   size_t* outInstructionLen);
+static const size_t X64MaxInstructionLen = 16;
+static const size_t X64ShortJumpLen      = 2;   ///< opcode + rel8
 
-uint8_t* EncodeX64(X64Operation operation, X64Operand operand1, X64Operand operand2, 
-                   size_t* outInstructionLen);
+/// @brief Encodes instruction to outBytes (at least X64MaxInstructionLen long), returns its length
+size_t EncodeX64(uint8_t* outBytes, X64Operation operation, size_t numberOfOperands, 
+                 X64Operand operand1, X64Operand operand2);
 
-uint8_t* EncodeX64(X64Operation operation, X64Operand operand, size_t* outInstructionLen);
+/// @brief Encodes instruction straight to the end of code, returns its length
+size_t EncodeX64(CodeArrayType* code, X64Operation operation, size_t numberOfOperands, 
+                 X64Operand operand1, X64Operand operand2);
+
+size_t EncodeX64(CodeArrayType* code, X64Operation operation, 
+                 X64Operand operand1, X64Operand operand2);
+
+size_t EncodeX64(CodeArrayType* code, X64Operation operation, X64Operand operand);
+
+/// @brief Gives rel8 form of JMP / Jcc. Returns false if operation doesn't have one
+bool X64GetShortJump(X64Operation jump, X64Operation* outShortJump);
 
 #endif 
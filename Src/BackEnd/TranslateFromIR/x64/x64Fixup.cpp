@@ -0,0 +1,328 @@
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "x64Fixup.h"
+
+static const size_t STANDARD_CAPACITY = 64;
+
+static inline int64_t  X64FixupGetValue     (const X64Fixups* fixups, const X64Fixup* fixup, 
+                                             const RodataInfo* rodata);
+static inline uint64_t X64FixupGetEndAddr   (const X64Fixups* fixups, const X64Fixup* fixup);
+
+static inline bool     X64FixupIsRelaxable  (const X64Fixup* fixup);
+
+static bool   RelaxationStep    (const X64Fixups* fixups, bool* isShort, size_t* shrinkBefore);
+static size_t RelaxedPos        (const X64Fixups* fixups, const size_t* shrinkBefore, size_t pos);
+static void   RelaxIRAddresses  (const X64Fixups* fixups, const size_t* shrinkBefore, const IR* ir);
+static void   RelaxCode         (X64Fixups* fixups, const bool* isShort, 
+                                 const size_t* shrinkBefore, CodeArrayType** code);
+
+static inline void CodeArrayAppend(CodeArrayType* code, const CodeArrayValue* values, size_t count);
+
+//-----------------------------------------------------------------------------
+
+X64Fixups X64FixupsCtor(uint64_t codeBeginAddr)
+{
+    X64Fixups fixups = {};
+
+    fixups.data          = nullptr;
+    fixups.size          = 0;
+    fixups.capacity      = 0;
+    fixups.codeBeginAddr = codeBeginAddr;
+
+    return fixups;
+}
+
+void X64FixupsDtor(X64Fixups* fixups)
+{
+    assert(fixups);
+
+    free(fixups->data);
+
+    *fixups = {};
+}
+
+void X64FixupAdd(X64Fixups* fixups, const CodeArrayType* code, size_t instructionPos,
+                 X64Operation operation, X64FixupType type, X64FixupTarget target)
+{
+    assert(fixups);
+    assert(code);
+    assert(code->size >= instructionPos + sizeof(int32_t));
+    assert(fixups->size == 0 || 
+           fixups->data[fixups->size - 1].instructionPos < instructionPos);
+
+    if (fixups->size == fixups->capacity)
+    {
+        fixups->capacity = fixups->capacity ? 2 * fixups->capacity : STANDARD_CAPACITY;
+        fixups->data     = (X64Fixup*)realloc(fixups->data, fixups->capacity * sizeof(*fixups->data));
+        assert(fixups->data);
+    }
+
+    X64Fixup* fixup = &fixups->data[fixups->size++];
+
+    fixup->type           = type;
+    fixup->target         = target;
+    fixup->operation      = operation;
+    fixup->instructionPos = instructionPos;
+    fixup->instructionLen = code->size - instructionPos;
+}
+
+void X64FixupsApply(const X64Fixups* fixups, CodeArrayType* code, const RodataInfo* rodata)
+{
+    assert(fixups);
+    assert(code);
+    assert(rodata);
+    assert(rodata->isLaidOut);
+
+    for (size_t i = 0; i < fixups->size; ++i)
+    {
+        const X64Fixup* fixup = &fixups->data[i];
+
+        int64_t value = X64FixupGetValue(fixups, fixup, rodata);
+        assert(INT32_MIN <= value && value <= INT32_MAX);
+
+        int32_t field    = (int32_t)value;
+        size_t  patchPos = fixup->instructionPos + fixup->instructionLen - sizeof(field);
+
+        CodeArrayErrors error = CodeArrayPatch(code, patchPos,
+                                               (const CodeArrayValue*)&field, sizeof(field));
+        assert(error == CodeArrayErrors::NO_ERR);
+    }
+}
+
+//-----------------------------------------------------------------------------
+
+// Jumps start short and only grow, so iterations stop after at most fixups->size steps.
+void X64FixupsRelaxJumps(X64Fixups* fixups, CodeArrayType** code, const IR* ir)
+{
+    assert(fixups);
+    assert(code);
+    assert(*code);
+    assert(ir);
+
+    bool*   isShort      = (bool*)  calloc(fixups->size,     sizeof(*isShort));
+    size_t* shrinkBefore = (size_t*)calloc(fixups->size + 1, sizeof(*shrinkBefore));
+    assert(isShort);
+    assert(shrinkBefore);
+
+    for (size_t i = 0; i < fixups->size; ++i)
+        isShort[i] = X64FixupIsRelaxable(&fixups->data[i]);
+
+    while (RelaxationStep(fixups, isShort, shrinkBefore))
+        ;
+
+    if (shrinkBefore[fixups->size] != 0)
+    {
+        RelaxIRAddresses(fixups, shrinkBefore, ir);
+        RelaxCode       (fixups, isShort, shrinkBefore, code);
+    }
+
+    free(isShort);
+    free(shrinkBefore);
+}
+
+// Recalculates shrinkBefore for current choice and makes long jumps that don't fit in rel8.
+// Returns true if choice has changed.
+static bool RelaxationStep(const X64Fixups* fixups, bool* isShort, size_t* shrinkBefore)
+{
+    assert(fixups);
+    assert(isShort);
+    assert(shrinkBefore);
+
+    shrinkBefore[0] = 0;
+    for (size_t i = 0; i < fixups->size; ++i)
+    {
+        size_t shrink = isShort[i] ? fixups->data[i].instructionLen - X64ShortJumpLen : 0;
+
+        shrinkBefore[i + 1] = shrinkBefore[i] + shrink;
+    }
+
+    bool changed = false;
+    for (size_t i = 0; i < fixups->size; ++i)
+    {
+        if (!isShort[i])
+            continue;
+
+        const X64Fixup* fixup = &fixups->data[i];
+
+        size_t targetPos = fixup->target.node->asmCmdBeginAddress - fixups->codeBeginAddr;
+        size_t endPos    = fixup->instructionPos + fixup->instructionLen;
+
+        int64_t shift = (int64_t)RelaxedPos(fixups, shrinkBefore, targetPos) - 
+                        (int64_t)RelaxedPos(fixups, shrinkBefore, endPos);
+
+        if (shift < INT8_MIN || shift > INT8_MAX)
+        {
+            isShort[i] = false;
+            changed    = true;
+        }
+    }
+
+    return changed;
+}
+
+// Position of the old code pos after all jumps before it are relaxed
+static size_t RelaxedPos(const X64Fixups* fixups, const size_t* shrinkBefore, size_t pos)
+{
+    assert(fixups);
+    assert(shrinkBefore);
+
+    size_t left  = 0;
+    size_t right = fixups->size;
+
+    // number of fixups with instructionPos < pos
+    while (left < right)
+    {
+        size_t mid = left + (right - left) / 2;
+
+        if (fixups->data[mid].instructionPos < pos)
+            left  = mid + 1;
+        else
+            right = mid;
+    }
+
+    return pos - shrinkBefore[left];
+}
+
+static void RelaxIRAddresses(const X64Fixups* fixups, const size_t* shrinkBefore, const IR* ir)
+{
+    assert(fixups);
+    assert(shrinkBefore);
+    assert(ir);
+
+    IRNode* beginNode = IRHead(ir);
+    IRNode* node      = beginNode->nextNode;
+
+    while (node != beginNode)
+    {
+        node->asmCmdBeginAddress = fixups->codeBeginAddr + 
+            RelaxedPos(fixups, shrinkBefore, node->asmCmdBeginAddress - fixups->codeBeginAddr);
+        node->asmCmdEndAddress   = fixups->codeBeginAddr + 
+            RelaxedPos(fixups, shrinkBefore, node->asmCmdEndAddress   - fixups->codeBeginAddr);
+
+        node = node->nextNode;
+    }
+}
+
+// IR addresses have to be relaxed already, they are used for rel8 values
+static void RelaxCode(X64Fixups* fixups, const bool* isShort, 
+                      const size_t* shrinkBefore, CodeArrayType** code)
+{
+    assert(fixups);
+    assert(isShort);
+    assert(shrinkBefore);
+    assert(code);
+    assert(*code);
+
+    const CodeArrayType* oldCode = *code;
+
+    CodeArrayType* newCode = nullptr;
+    CodeArrayCtor(&newCode, oldCode->size - shrinkBefore[fixups->size]);
+
+    size_t copiedPos     = 0;
+    size_t fixupsNewSize = 0;
+
+    for (size_t i = 0; i < fixups->size; ++i)
+    {
+        X64Fixup fixup = fixups->data[i];
+
+        if (!isShort[i])
+        {
+            fixup.instructionPos -= shrinkBefore[i];
+            fixups->data[fixupsNewSize++] = fixup;
+
+            continue;
+        }
+
+        CodeArrayAppend(newCode, oldCode->data + copiedPos, fixup.instructionPos - copiedPos);
+        copiedPos = fixup.instructionPos + fixup.instructionLen;
+
+        X64Operation shortJump = X64Operation::JMP_SHORT;
+        bool hasShortForm = X64GetShortJump(fixup.operation, &shortJump);
+        assert(hasShortForm);
+
+        uint64_t endAddr = fixups->codeBeginAddr + newCode->size + X64ShortJumpLen;
+        int      shift   = (int)((int64_t)fixup.target.node->asmCmdBeginAddress - (int64_t)endAddr);
+
+        size_t instructionLen = EncodeX64(newCode, shortJump, X64OperandImmCreate(shift));
+        assert(instructionLen == X64ShortJumpLen);
+    }
+
+    CodeArrayAppend(newCode, oldCode->data + copiedPos, oldCode->size - copiedPos);
+
+    assert(newCode->size == oldCode->size - shrinkBefore[fixups->size]);
+
+    fixups->size = fixupsNewSize;
+
+    CodeArrayDtor(*code);
+    *code = newCode;
+}
+
+//-----------------------------------------------------------------------------
+
+static inline int64_t X64FixupGetValue(const X64Fixups* fixups, const X64Fixup* fixup, 
+                                       const RodataInfo* rodata)
+{
+    assert(fixups);
+    assert(fixup);
+    assert(rodata);
+
+    switch (fixup->type)
+    {
+        case X64FixupType::LABEL_REL32:
+            assert(fixup->target.node);
+            return (int64_t)fixup->target.node->asmCmdBeginAddress - 
+                   (int64_t)X64FixupGetEndAddr(fixups, fixup);
+
+        case X64FixupType::ADDR_REL32:
+            return (int64_t)fixup->target.address - (int64_t)X64FixupGetEndAddr(fixups, fixup);
+
+        case X64FixupType::RODATA_IMM_ABS32:
+            assert(fixup->target.rodataPos < rodata->immediatesCount);
+            return (int64_t)rodata->immediates[fixup->target.rodataPos].asmAddr;
+
+        case X64FixupType::RODATA_STR_ABS32:
+            assert(fixup->target.rodataPos < rodata->stringsCount);
+            return (int64_t)rodata->strings[fixup->target.rodataPos].asmAddr;
+
+        default: // Unreachable
+            assert(false);
+            return 0;
+    }
+}
+
+static inline uint64_t X64FixupGetEndAddr(const X64Fixups* fixups, const X64Fixup* fixup)
+{
+    assert(fixups);
+    assert(fixup);
+
+    return fixups->codeBeginAddr + fixup->instructionPos + fixup->instructionLen;
+}
+
+static inline bool X64FixupIsRelaxable(const X64Fixup* fixup)
+{
+    assert(fixup);
+
+    X64Operation shortJump = X64Operation::JMP_SHORT;
+
+    return fixup->type == X64FixupType::LABEL_REL32 && 
+           X64GetShortJump(fixup->operation, &shortJump);
+}
+
+static inline void CodeArrayAppend(CodeArrayType* code, const CodeArrayValue* values, size_t count)
+{
+    assert(code);
+    assert(values);
+
+    if (count == 0)
+        return;
+
+    CodeArrayValue* codeTail = nullptr;
+    CodeArrayErrors error = CodeArrayReserve(code, count, &codeTail);
+    assert(error == CodeArrayErrors::NO_ERR);
+
+    memcpy(codeTail, values, count * sizeof(*values));
+
+    CodeArrayCommit(code, count);
+}
@@ -0,0 +1,64 @@
+#ifndef X64_FIXUP_H
+#define X64_FIXUP_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "BackEnd/IR/IRList/IR.h"
+#include "RodataInfo/Rodata.h"
+#include "CodeArray/CodeArray.h"
+#include "x64Encode.h"
+
+// Code is emitted in one pass with zero placeholders in place of addresses that are
+// not known yet. Every placeholder gets a fixup, all of them are patched once layout is final.
+
+enum class X64FixupType
+{
+    LABEL_REL32,        ///< JMP / Jcc / CALL to IR node, target is known after code emission
+    ADDR_REL32,         ///< CALL to fixed address (stdlib function)
+    RODATA_IMM_ABS32,   ///< absolute address of immediate from constant pool
+    RODATA_STR_ABS32,   ///< absolute address of string from constant pool
+};
+
+union X64FixupTarget
+{
+    const IRNode* node;
+    uint64_t      address;
+    size_t        rodataPos;
+};
+
+struct X64Fixup
+{
+    X64FixupType   type;
+    X64FixupTarget target;
+
+    X64Operation   operation;       ///< instruction that has the placeholder
+    size_t         instructionPos;  ///< pos of the instruction in code array
+    size_t         instructionLen;  ///< placeholder is the last 4 bytes of the instruction
+};
+
+struct X64Fixups
+{
+    X64Fixup* data;
+    size_t    size;
+    size_t    capacity;
+
+    uint64_t  codeBeginAddr;        ///< address of code array beginning
+};
+
+X64Fixups X64FixupsCtor(uint64_t codeBeginAddr);
+void      X64FixupsDtor(X64Fixups* fixups);
+
+/// @brief Records fixup for the last instruction in code array that begins at instructionPos
+void X64FixupAdd    (X64Fixups* fixups, const CodeArrayType* code, size_t instructionPos,
+                     X64Operation operation, X64FixupType type, X64FixupTarget target);
+
+/// @brief Branch relaxation. Replaces JMP / Jcc with their rel8 forms where displacement fits,
+///        moves code and IR nodes addresses accordingly. Relaxed jumps are resolved and removed
+void X64FixupsRelaxJumps(X64Fixups* fixups, CodeArrayType** code, const IR* ir);
+
+/// @brief Patches all recorded fields. Rodata has to be laid out,
+///        IR nodes have to know their final addresses
+void X64FixupsApply (const X64Fixups* fixups, CodeArrayType* code, const RodataInfo* rodata);
+
+#endif
@@ -6,6 +6,7 @@
 
 // Available Vars    : IRNode* node, X64Instruction instruction
 // Available defines : BYTE_TARGET(), EMPTY_BYTE_TARGET from x64Encode.cpp
+// Available funcs   : static helpers from x64Encode.cpp (SetRexW, FitsInImm8, ...)
 
 DEF_X64_OP(NOP,
 {
@@ -47,11 +48,21 @@ DEF_X64_OP(ADD,
     assert(numberOfOperands == 2 && operand1.type == X64OperandType::REG &&
                                     operand2.type == X64OperandType::IMM);
 
-    instruction.opcode = 0x81;
     SetRexW(&instruction);
     SetModRmRegField(&instruction, 0);
     
-    X64_INSTRUCTION_INIT(BYTE_TARGET(MODRM_RM), BYTE_TARGET(IMM32));
+    if (FitsInImm8(operand2.value.imm))
+    {
+        instruction.opcode = 0x83; // sign extended imm8
+
+        X64_INSTRUCTION_INIT(BYTE_TARGET(MODRM_RM), BYTE_TARGET(IMM8));
+    }
+    else
+    {
+        instruction.opcode = 0x81;
+
+        X64_INSTRUCTION_INIT(BYTE_TARGET(MODRM_RM), BYTE_TARGET(IMM32));
+    }
 })
 
 DEF_X64_OP(SUB,
@@ -59,11 +70,21 @@ DEF_X64_OP(SUB,
     assert(numberOfOperands == 2 && operand1.type == X64OperandType::REG &&
                                     operand2.type == X64OperandType::IMM);
 
-    instruction.opcode = 0x81;
     SetRexW(&instruction);
     SetModRmRegField(&instruction, 5);
     
-    X64_INSTRUCTION_INIT(BYTE_TARGET(MODRM_RM), BYTE_TARGET(IMM32));
+    if (FitsInImm8(operand2.value.imm))
+    {
+        instruction.opcode = 0x83; // sign extended imm8
+
+        X64_INSTRUCTION_INIT(BYTE_TARGET(MODRM_RM), BYTE_TARGET(IMM8));
+    }
+    else
+    {
+        instruction.opcode = 0x81;
+
+        X64_INSTRUCTION_INIT(BYTE_TARGET(MODRM_RM), BYTE_TARGET(IMM32));
+    }
 })
 
 //TODO: Think about copypaste ADDSD, SUBSD, ...
@@ -219,7 +240,8 @@ DEF_X64_OP(MOVSD,
 {
     assert(numberOfOperands == 2);
     assert((operand1.type == X64OperandType::MEM && operand2.type == X64OperandType::REG) ||
-           (operand1.type == X64OperandType::REG && operand2.type == X64OperandType::MEM));
+           (operand1.type == X64OperandType::REG && operand2.type == X64OperandType::MEM) ||
+           (operand1.type == X64OperandType::REG && operand2.type == X64OperandType::REG));
 
     instruction.requireMandatoryPrefix = true;
     instruction.mandatoryPrefix        = MandatoryPrefix_F2;
@@ -241,6 +263,21 @@ DEF_X64_OP(MOVSD,
     }
 })
 
+// Register copy of the whole register: MOVSD xmm, xmm merges into the destination 
+// and makes it depend on its previous value
+DEF_X64_OP(MOVAPS,
+{
+    assert(numberOfOperands == 2 && operand1.type == X64OperandType::REG && 
+                                    operand2.type == X64OperandType::REG);
+
+    instruction.requireOpcodePrefix1   = true; 
+    instruction.opcodePrefix1          = OpcodePrefix1_0F;
+
+    instruction.opcode = 0x28;
+
+    X64_INSTRUCTION_INIT(BYTE_TARGET(MODRM_REG), BYTE_TARGET(MODRM_RM));
+})
+
 DEF_X64_OP(COMISD,
 {
     assert(numberOfOperands == 2 && operand1.type == X64OperandType::REG && 
@@ -307,6 +344,57 @@ DEF_X64_OP(JAE,
 
 #undef GEN_JCC
 
+// Short forms with rel8 displacement, chosen by branch relaxation
+
+DEF_X64_OP(JMP_SHORT,
+{
+    assert(numberOfOperands == 1 && operand1.type == X64OperandType::IMM);
+
+    instruction.opcode = 0xEB;
+
+    X64_INSTRUCTION_INIT(BYTE_TARGET(IMM8), EMPTY_BYTE_TARGET);
+})
+
+#define GEN_JCC_SHORT(OPCODE)                                       \
+do                                                                  \
+{                                                                   \
+    assert(numberOfOperands == 1 && operand1.type == X64OperandType::IMM); \
+    instruction.opcode = OPCODE;                                    \
+    X64_INSTRUCTION_INIT(BYTE_TARGET(IMM8), EMPTY_BYTE_TARGET);     \
+} while (0)
+
+DEF_X64_OP(JE_SHORT,
+{
+    GEN_JCC_SHORT(0x74);
+})
+
+DEF_X64_OP(JNE_SHORT,
+{
+    GEN_JCC_SHORT(0x75);
+})
+
+DEF_X64_OP(JB_SHORT,
+{
+    GEN_JCC_SHORT(0x72);
+})
+
+DEF_X64_OP(JBE_SHORT,
+{
+    GEN_JCC_SHORT(0x76);
+})
+
+DEF_X64_OP(JA_SHORT,
+{
+    GEN_JCC_SHORT(0x77);
+})
+
+DEF_X64_OP(JAE_SHORT,
+{
+    GEN_JCC_SHORT(0x73);
+})
+
+#undef GEN_JCC_SHORT
+
 DEF_X64_OP(CALL,
 {
     assert(numberOfOperands == 1 && operand1.type == X64OperandType::IMM);
@@ -320,9 +408,14 @@ DEF_X64_OP(RET,
 {
     assert(numberOfOperands == 1 && operand1.type == X64OperandType::IMM);
 
-    instruction.opcode = 0xC2;
+    if (operand1.value.imm == 0)
+        instruction.opcode = 0xC3; // RET without popping arguments, no operands
+    else
+    {
+        instruction.opcode = 0xC2;
 
-    X64_INSTRUCTION_INIT(BYTE_TARGET(IMM16), EMPTY_BYTE_TARGET);
+        X64_INSTRUCTION_INIT(BYTE_TARGET(IMM16), EMPTY_BYTE_TARGET);
+    }
 })
 
 DEF_X64_OP(LEA,
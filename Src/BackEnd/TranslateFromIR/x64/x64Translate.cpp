@@ -5,21 +5,23 @@
 #include "x64Translate.h"
 #include "x64Encode.h"
 #include "x64Elf.h"
+#include "x64Fixup.h"
 #include "RodataInfo/Rodata.h"
 #include "CodeArray/CodeArray.h"
 #include "StdLib/StdLib.h"
+#include "Common/StringIntern.h"
 
 //-----------------------------------------------------------------------------
 
-#define PRINT_LABEL(LABEL) PrintLabel(outStream, LABEL)
-static inline void PrintLabel(FILE* outStream, const char* label);
+#define PRINT_LABEL(LABEL_ID) PrintLabel(outStream, ir, LABEL_ID)
+static inline void PrintLabel(FILE* outStream, const IR* ir, IRLabelId labelId);
 
 #define EMPTY_OPERAND IROperandCtor()
 
-#define PRINT_OPERATION(OPERATION) PrintOperation(outStream, code, #OPERATION,     \
+#define PRINT_OPERATION(OPERATION) PrintOperation(outStream, ir, code, #OPERATION, \
                                                   X64Operation::OPERATION, node)
 
-static inline void PrintOperation(FILE* outStream, CodeArrayType* code,
+static inline void PrintOperation(FILE* outStream, const IR* ir, CodeArrayType* code,
                                   const char* operationName, X64Operation x64Operation, 
                                   const IRNode* node);
 
@@ -33,37 +35,56 @@ static inline void PrintOperationInCodeArray(CodeArrayType* code, X64Operation x
 static inline void PrintOperationInCodeArray(CodeArrayType* code, X64Operation x64Operation,
                                              X64Operand operand1);
 
-static inline void PrintOperation(FILE* outStream, CodeArrayType* code, 
+static inline void PrintOperation(FILE* outStream, const IR* ir, CodeArrayType* code, 
                                   const char* operationName, X64Operation x64Operation,
                                   const IROperand operand1, const IROperand operand2);
 
-static inline void PrintOperation(FILE* outStream, CodeArrayType* code, 
+static inline void PrintOperation(FILE* outStream, const IR* ir, CodeArrayType* code, 
                                   const char* operationName, X64Operation x64Operation,
                                   const IROperand operand1);
 
-static inline void PrintOperand(FILE* outStream, const IROperand operand);
+static inline void PrintOperand(FILE* outStream, const IR* ir, const IROperand operand);
 
 static inline void PrintAsmCodeLine(FILE* outStream, const char* format, ...);
 
 //-----------------------------------------------------------------------------
 
-static inline void PrintRodata          (FILE* outStream, const RodataInfo* rodata);
-static inline void PrintRodataImmediates(FILE* outStream, RodataImmediatesType* rodataImmediates);
-static inline void PrintRodataStrings   (FILE* outStream, RodataStringsType*    rodataStrings);
-
-static inline RodataStringsValue*      GetStrLabelInfo(const char* string, 
-                                                          RodataStringsType* rodataString);
-
-static inline char* CreateStringLabel   (const char* string);
-
-static inline RodataImmediatesValue* GetImmLabelInfo(const long long imm, 
-                                                        RodataImmediatesType* rodataImm);
+#define RODATA_IMM_LABEL "XMM_VALUE_%zu"
+#define RODATA_STR_LABEL "STR_%zu"
 
-static inline char* CreateImmediateLabel(const long long imm);
+static inline void PrintRodata          (FILE* outStream, const RodataInfo* rodata);
+static inline void PrintRodataImmediates(FILE* outStream, const RodataInfo* rodata);
+static inline void PrintRodataStrings   (FILE* outStream, const RodataInfo* rodata);
 
 //-----------------------------------------------------------------------------
 
-static inline void SetLabelRelativeShift(IRNode* node);
+#define PRINT_JUMP(OPERATION)                                               \
+    do                                                                      \
+    {                                                                       \
+        size_t jumpPos = code->size;                                        \
+        PRINT_OPERATION(OPERATION);                                         \
+        AddLabelFixup(&fixups, code, jumpPos, X64Operation::OPERATION,      \
+                      node->jumpTarget);                                    \
+    } while (0)
+
+#define PRINT_STD_LIB_CALL(STD_LIB_FUNC)                                    \
+    do                                                                      \
+    {                                                                       \
+        size_t callPos = code->size;                                        \
+        PrintOperationInCodeArray(code, X64Operation::CALL,                 \
+                                  X64OperandImmCreate(0));                  \
+        AddAddressFixup(&fixups, code, callPos,                             \
+                        (uint64_t)StdLibAddresses::STD_LIB_FUNC);           \
+    } while (0)
+
+static inline void AddLabelFixup  (X64Fixups* fixups, const CodeArrayType* code, 
+                                   size_t instructionPos, X64Operation operation,
+                                   const IRNode* target);
+static inline void AddAddressFixup(X64Fixups* fixups, const CodeArrayType* code, 
+                                   size_t instructionPos, uint64_t address);
+static inline void AddRodataFixup (X64Fixups* fixups, const CodeArrayType* code,
+                                   size_t instructionPos, X64Operation operation,
+                                   X64FixupType type, size_t rodataPos);
 
 //-----------------------------------------------------------------------------
 
@@ -71,83 +92,72 @@ static inline void PrintEntry(FILE* outStream);
 
 //-----------------------------------------------------------------------------
 
-static inline void SetLabelRelativeShift(IRNode* node)
-{
-    assert(node->numberOfOperands == 1);
-    assert(node->operand1.type = IROperandType::LABEL);
-    assert(node->jumpTarget);
-
-    node->operand1.value.imm = node->jumpTarget->asmCmdBeginAddress - node->asmCmdEndAddress;
-}
-
 void TranslateToX64(const IR* ir, FILE* outStream, FILE* outBin)
 {
     assert(ir);
     
     RodataInfo rodata = RodataInfoCtor();
-
-    static const size_t numberOfCompilationPasses = 2;
+    X64Fixups  fixups = X64FixupsCtor((uint64_t)SegmentAddress::PROGRAM_CODE);
 
     CodeArrayType* code = nullptr;
-    CodeArrayCtor(&code, 0);
+    CodeArrayCtor(&code, ir->size * X64MaxInstructionLen); // enough for most of the IR nodes
 
     PrintEntry(outStream);
 
-    for (size_t compilationPass = 0; compilationPass < numberOfCompilationPasses; ++compilationPass)
-    {
-        IRNode* beginNode = IRHead(ir);
-        IRNode* node = beginNode->nextNode;
+    // Single pass: addresses that are not known yet are emitted as zeroes and patched below
+    IRNode* beginNode = IRHead(ir);
+    IRNode* node = beginNode->nextNode;
 
-        CodeArrayDtor(code);    // each pass writing code again
-        CodeArrayCtor(&code, 0);
+    while (node != beginNode)
+    {
+        node->asmCmdBeginAddress = (int)SegmentAddress::PROGRAM_CODE + code->size;
+    #define DEF_IR_OP(OP_NAME, X64_GEN, ...)            \
+        case IROperation::OP_NAME:                      \
+            X64_GEN;                                    \
+            break;
 
-        while (node != beginNode)
+        switch (node->operation)
         {
-            node->asmCmdBeginAddress = (int)SegmentAddress::PROGRAM_CODE + code->size;
-        #define DEF_IR_OP(OP_NAME, X64_GEN, ...)            \
-            case IROperation::OP_NAME:                      \
-                X64_GEN;                                    \
+            #include "BackEnd/IR/IROperations.h" // cases
+        
+            default:    // Unreachable
+                assert(false);
                 break;
-
-            switch (node->operation)
-            {
-                #include "BackEnd/IR/IROperations.h" // cases
-            
-                default:    // Unreachable
-                    assert(false);
-                    break;
-            }
-
-        #undef DEF_IR_OP
-
-            node->asmCmdEndAddress = (int)SegmentAddress::PROGRAM_CODE + code->size;
-            node = node->nextNode;
         }
 
-        PrintRodata(outStream, &rodata);
-        LoadRodata(&rodata, outBin);
-
-        outStream = nullptr; // don't print asm code after first compilation pass  
+    #undef DEF_IR_OP
 
+        node->asmCmdEndAddress = (int)SegmentAddress::PROGRAM_CODE + code->size;
         node = node->nextNode;
     }
 
+    X64FixupsRelaxJumps(&fixups, &code, ir);
+
+    LoadRodata(&rodata, outBin);    // lays constant pool out
+    X64FixupsApply(&fixups, code, &rodata);
+
+    PrintRodata(outStream, &rodata);
     LoadCode(code, outBin);
 
+    X64FixupsDtor(&fixups);
     RodataInfoDtor(&rodata);
     CodeArrayDtor(code);
 }
 
 //-----------------------------------------------------------------------------
 
-static inline void PrintLabel(FILE* outStream, const char* label)
+static inline void PrintLabel(FILE* outStream, const IR* ir, IRLabelId labelId)
 {
-    assert(label);
+    assert(ir);
 
-    if (outStream) fprintf(outStream, "%s:\n", label);
+    if (!outStream)
+        return;
+
+    char labelName[IRLabelNameMaxLength] = "";
+    fprintf(outStream, "%s:\n", IRLabelGetName(ir, labelId, labelName, IRLabelNameMaxLength));
 }
 
-static inline void PrintOperation(FILE* outStream, CodeArrayType* code,
+static inline void PrintOperation(FILE* outStream, const IR* ir, CodeArrayType* code,
                                   const char* operationName, X64Operation x64Operation,
                                   size_t numberOfOperands, 
                                   const IROperand operand1, const IROperand operand2)
@@ -159,12 +169,12 @@ static inline void PrintOperation(FILE* outStream, CodeArrayType* code,
         fprintf(outStream, "\t%s ", operationName);
 
         if (numberOfOperands > 0)
-            PrintOperand(outStream, operand1);
+            PrintOperand(outStream, ir, operand1);
         
         if (numberOfOperands > 1)
         {
             fprintf(outStream, ", ");
-            PrintOperand(outStream, operand2);
+            PrintOperand(outStream, ir, operand2);
         }
 
         fprintf(outStream, "\n");
@@ -180,14 +190,7 @@ static inline void PrintOperationInCodeArray(CodeArrayType* code, X64Operation x
 {
     assert(code);
 
-    size_t instructionLen = 0;
-    uint8_t* instructionCode = EncodeX64(x64Operation, numberOfOperands, 
-                                         operand1, operand2, &instructionLen);
-
-    for (size_t i = 0; i < instructionLen; ++i)
-        CodeArrayPush(code, instructionCode[i]);
-
-    free(instructionCode);
+    EncodeX64(code, x64Operation, numberOfOperands, operand1, operand2);
 }
 
 static inline void PrintOperationInCodeArray(CodeArrayType* code, X64Operation x64Operation,
@@ -203,29 +206,29 @@ static inline void PrintOperationInCodeArray(CodeArrayType* code, X64Operation x
     PrintOperationInCodeArray(code, x64Operation, 1, operand1, emptyOperand);
 }
 
-static inline void PrintOperation(FILE* outStream, CodeArrayType* code,
+static inline void PrintOperation(FILE* outStream, const IR* ir, CodeArrayType* code,
                                   const char* operationName, X64Operation x64Operation,
                                   const IRNode* node)
 {
-    PrintOperation(outStream, code, operationName, x64Operation, node->numberOfOperands, 
+    PrintOperation(outStream, ir, code, operationName, x64Operation, node->numberOfOperands, 
                    node->operand1, node->operand2);
 }
 
-static inline void PrintOperation(FILE* outStream, CodeArrayType* code, 
+static inline void PrintOperation(FILE* outStream, const IR* ir, CodeArrayType* code, 
                                   const char* operationName, X64Operation x64Operation,
                                   const IROperand operand1, const IROperand operand2)
 {
-    PrintOperation(outStream, code, operationName, x64Operation, 2, operand1, operand2);
+    PrintOperation(outStream, ir, code, operationName, x64Operation, 2, operand1, operand2);
 }
 
-static inline void PrintOperation(FILE* outStream, CodeArrayType* code, 
+static inline void PrintOperation(FILE* outStream, const IR* ir, CodeArrayType* code, 
                                   const char* operationName, X64Operation x64Operation,
                                   const IROperand operand1)
 {
-    PrintOperation(outStream, code, operationName, x64Operation, 1, operand1, EMPTY_OPERAND);
+    PrintOperation(outStream, ir, code, operationName, x64Operation, 1, operand1, EMPTY_OPERAND);
 }
 
-static inline void PrintOperand(FILE* outStream, const IROperand operand)
+static inline void PrintOperand(FILE* outStream, const IR* ir, const IROperand operand)
 {
     if (!outStream)
         return;
@@ -249,9 +252,14 @@ static inline void PrintOperand(FILE* outStream, const IROperand operand)
             break;
         
         case IROperandType::LABEL:
-            assert(operand.value.string);
-            fprintf(outStream, "%s", operand.value.string);
+        {
+            assert(ir);
+
+            char labelName[IRLabelNameMaxLength] = "";
+            fprintf(outStream, "%s", 
+                    IRLabelGetName(ir, operand.value.label, labelName, IRLabelNameMaxLength));
             break;
+        }
 
         case IROperandType::STR: // Unreachable
             assert(false);
@@ -300,134 +308,102 @@ static inline void PrintRodata(FILE* outStream, const RodataInfo* rodata)
 
     fprintf(outStream, "section .rodata\n\n");
 
-    PrintRodataImmediates(outStream, rodata->rodataImmediates);
-    PrintRodataStrings   (outStream, rodata->rodataStrings);
+    PrintRodataImmediates(outStream, rodata);
+    PrintRodataStrings   (outStream, rodata);
 }
 
-static inline void PrintRodataImmediates(FILE* outStream, RodataImmediatesType* rodataImmediates)
+static inline void PrintRodataImmediates(FILE* outStream, const RodataInfo* rodata)
 {
     assert(outStream);
-    assert(rodataImmediates);
+    assert(rodata);
 
-    // TODO: Implementation defined - change on memcpy
-    union 
-    {
-        double value;
-        int    dwords[2];
-    } doubleBytes;
+    if (rodata->immediatesCount == 0)
+        return;
 
-    for (size_t i = 0; i < rodataImmediates->size; ++i)
-    {
-        long long imm = rodataImmediates->data[i].imm;
-        doubleBytes.value = (double)imm;
+    fprintf(outStream, "align %d\n\n", (int)RODATA_IMMEDIATE_SLOT_SIZE);
 
-        const char* immLabel = GetImmLabelInfo(imm, rodataImmediates)->label;
+    for (size_t i = 0; i < rodata->immediatesCount; ++i)
+    {
+        int    dwords[2] = {};
+        double value     = (double)rodata->immediates[i].imm;
+        memcpy(dwords, &value, sizeof(dwords));
 
-        fprintf(outStream, "%s:\n"
+        fprintf(outStream, RODATA_IMM_LABEL ":\n"
                            "\tdd %d\n"
-                           "\tdd %d\n\n",
-                           immLabel, doubleBytes.dwords[0], doubleBytes.dwords[1]);
+                           "\tdd %d\n"
+                           "\tdq 0\n\n",
+                           i, dwords[0], dwords[1]);
     }
 }
 
-static inline void PrintRodataStrings   (FILE* outStream, RodataStringsType* rodataStrings)
+static inline void PrintRodataStrings(FILE* outStream, const RodataInfo* rodata)
 {
     assert(outStream);
-    assert(rodataStrings);
+    assert(rodata);
 
-    for (size_t i = 0; i < rodataStrings->size; ++i)
+    for (size_t i = 0; i < rodata->stringsCount; ++i)
     {
-        const char* string = rodataStrings->data[i].string;
-        const char* stringLabel = GetStrLabelInfo(string, rodataStrings)->label;
+        const RodataString* string = &rodata->strings[i];
+        if (string->owner != i)
+            continue;
 
-        fprintf(outStream, "%s:\n"
+        fprintf(outStream, RODATA_STR_LABEL ":\n"
                            "\tdb \'%s\', 0\n\n", 
-                           stringLabel, string);
+                           i, string->string);
     }
-}
 
-static inline char* CreateStringLabel(const char* string)
-{
-    assert(string);
-
-    static size_t labelId = 0;
-
-    static const size_t maxLabelLen = 32;
-    char label[maxLabelLen] = "";
-
-    snprintf(label, maxLabelLen, "STR_%zu", labelId);
-    ++labelId;
-
-    return strdup(label);   
-}
-
-static inline RodataStringsValue* GetStrLabelInfo(const char* string, 
-                                                  RodataStringsType* rodataStrings)
-{
-    assert(string);
-
-    RodataStringsValue* value = nullptr;
-    RodataStringsFind(rodataStrings, string, &value);
-
-    if (value == nullptr)
+    for (size_t i = 0; i < rodata->stringsCount; ++i)
     {
-        char* label = CreateStringLabel(string);
+        const RodataString* string = &rodata->strings[i];
+        if (string->owner == i)
+            continue;
 
-        RodataStringsValue pushValue = {};
-        RodataStringsValueCtor(&pushValue, string, label);
-        RodataStringsPush(rodataStrings, pushValue);
+        const RodataString* owner = &rodata->strings[string->owner];
 
-        RodataStringsFind(rodataStrings, string, &value);
-
-        free(label);
+        fprintf(outStream, RODATA_STR_LABEL " equ " RODATA_STR_LABEL " + %zu\n",
+                           i, string->owner, owner->length - string->length);
     }
-
-    assert(value);
-    assert(value->label);
-
-    return value;
 }
 
-static inline RodataImmediatesValue* GetImmLabelInfo(const long long imm, 
-                                                     RodataImmediatesType* rodataImmediates)
-{
-    RodataImmediatesValue* value = nullptr;
-    RodataImmediatesFind(rodataImmediates, imm, &value);
+//-----------------------------------------------------------------------------
 
-    if (value == nullptr)
-    {
-        char* label = CreateImmediateLabel(imm);
+static inline void AddLabelFixup(X64Fixups* fixups, const CodeArrayType* code, 
+                                 size_t instructionPos, X64Operation operation,
+                                 const IRNode* target)
+{
+    assert(target);
 
-        RodataImmediatesValue pushValue = {};
-        RodataImmediatesValueCtor(&pushValue, imm, label);
-        RodataImmediatesPush(rodataImmediates, pushValue);
+    X64FixupTarget fixupTarget = {};
+    fixupTarget.node = target;
 
-        RodataImmediatesFind(rodataImmediates, imm, &value);
+    X64FixupAdd(fixups, code, instructionPos, operation, X64FixupType::LABEL_REL32, fixupTarget);
+}
 
-        free(label);
-    }
+static inline void AddAddressFixup(X64Fixups* fixups, const CodeArrayType* code, 
+                                   size_t instructionPos, uint64_t address)
+{
+    X64FixupTarget fixupTarget = {};
+    fixupTarget.address = address;
 
-    assert(value);
-    assert(value->label);
-    
-    return value;
+    X64FixupAdd(fixups, code, instructionPos, X64Operation::CALL, 
+                X64FixupType::ADDR_REL32, fixupTarget);
 }
 
-static inline char* CreateImmediateLabel(const long long imm)
+static inline void AddRodataFixup(X64Fixups* fixups, const CodeArrayType* code,
+                                  size_t instructionPos, X64Operation operation,
+                                  X64FixupType type, size_t rodataPos)
 {
-    static const size_t maxLabelLen = 32;
-    char label[maxLabelLen] = "";
+    assert(rodataPos != NO_RODATA_ENTRY);
 
-    if (imm < 0)
-        snprintf(label, maxLabelLen, "XMM_VALUE__%lld", -imm);
-    else
-        snprintf(label, maxLabelLen, "XMM_VALUE_%lld", imm);
+    X64FixupTarget fixupTarget = {};
+    fixupTarget.rodataPos = rodataPos;
 
-    return strdup(label);
+    X64FixupAdd(fixups, code, instructionPos, operation, type, fixupTarget);
 }
 
-
 #undef PRINT_LABEL
+#undef PRINT_JUMP
+#undef PRINT_STD_LIB_CALL
 #undef EMPTY_OPERAND
 #undef PRINT_OPERATION
 #undef PRINT_OPERATION_TWO_OPERANDS
@@ -435,4 +411,6 @@ static inline char* CreateImmediateLabel(const long long imm)
 #undef PRINT_STR
 #undef PRINT_FORMAT_STR
 #undef GET_STR_LABEL
+#undef RODATA_IMM_LABEL
+#undef RODATA_STR_LABEL
 #undef GET_IMM_LABEL
\ No newline at end of file
@@ -4,6 +4,9 @@
 #include "Tree/Tree.h"
 #include "Tree/NameTable/NameTable.h"
 #include "IR/IRBuild/IRBuild.h"
+#include "IR/IRPeephole/IRPeephole.h"
+#include "IR/IRRegAlloc/IRRegAlloc.h"
+#include "IR/IRFrame/IRFrame.h"
 #include "TranslateFromIR/x64/x64Translate.h"
 #include "Common/Log.h"
 #include "Common/CommandLineArgsParser.h"
@@ -13,6 +16,9 @@
 static void GetFileNames(int argc, const char* argv[], 
                          char** inFileName, char** outBinFileName, char** outAsmFileName);
 
+static const char* PeepholeStatsOption    = "-peephole-stats";
+static const char* KeepFramePointerOption = "-keep-frame-pointer";
+
 int main(int argc, const char* argv[])
 {
     LogOpen(argv[0]);
@@ -41,11 +47,26 @@ int main(int argc, const char* argv[])
     Tree tree = {};
     TreeCtor(&tree);
 
-    TreeReadPrefixFormat(&tree, inStream);
+    TreeRead(&tree, inStream);
 
     TreeGraphicDump(&tree, true);
-    IR* ir = IRBuild(&tree);
-    TranslateToX64(ir, outAsmStream, outBinStream);
+    IRErrors err = IRErrors::NO_ERR;
+    IR* ir = IRBuild(&tree, &err);
+
+    if (err == IRErrors::NO_ERR)
+    {
+        IRRegAlloc(ir);
+
+        IRPeepholeStats peepholeStats = IRPeepholeStatsCtor();
+        IRPeephole(ir, &peepholeStats);
+        if (GetCommandLineArgPos(argc, argv, PeepholeStatsOption) != NO_COMMAND_LINE_ARG)
+            IRPeepholeStatsPrint(stdout, &peepholeStats);
+
+        IRFrameOptimize(ir, GetCommandLineArgPos(argc, argv, KeepFramePointerOption) != 
+                             NO_COMMAND_LINE_ARG);
+
+        TranslateToX64(ir, outAsmStream, outBinStream);
+    }
 
     TreeDtor(&tree);
     IRDtor(ir);
@@ -53,6 +74,8 @@ int main(int argc, const char* argv[])
     fclose(inStream);
     fclose(outBinStream);
     if (outAsmStream) fclose(outAsmStream);
+
+    return (int)err;
 }
 
 static void GetFileNames(int argc, const char* argv[], 
@@ -63,7 +86,9 @@ static void GetFileNames(int argc, const char* argv[],
     if (argc < 3)
     {
         printf("Usage: %s [file with AST] [out binary file] [optional...]\n", argv[0]);
-        printf("Optional: %s (asm file output)\n", asmOutputOption);
+        printf("Optional: %s (asm file output), %s (IR peephole pattern hits), "
+               "%s (RBP frames for profilers)\n", 
+               asmOutputOption, PeepholeStatsOption, KeepFramePointerOption);
 
         exit(0);
     }
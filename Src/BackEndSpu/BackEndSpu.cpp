@@ -358,10 +358,6 @@ static void NameTablePushFuncParams(TreeNode* node, NameTableType* local,
     {
         Name pushName = {};
         NameCtor(&pushName, allNamesTable->data[node->value.nameId].name, nullptr, *varRamId);
-        // TODO: Name ctors strdups name. 
-        // It's kind of useless when I am creating local table - 
-        // I'm not going to delete local tables strings without deleting global table
-        // Just using extra mem + time. 
 
         // TODO: mem leak never DTOR name table. + Create recursive name table dtor
         *varRamId += 1;
@@ -17,7 +17,7 @@ int main(int argc, char* argv[])
     Tree tree = {};
     TreeCtor(&tree);
 
-    TreeReadPrefixFormat(&tree, inStream);
+    TreeRead(&tree, inStream);
 
     TreeGraphicDump(&tree, true);
 
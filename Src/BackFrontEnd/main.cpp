@@ -14,7 +14,7 @@ int main(int argc, char* argv[])
     Tree tree = {};
     TreeCtor(&tree);
     
-    TreeReadPrefixFormat(&tree, inStream);
+    TreeRead(&tree, inStream);
     
     CodeBuild(&tree, outStream);
 
@@ -0,0 +1,20 @@
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+#include <time.h>
+
+// Benchmarks of compiler internals, they are not a part of the compilation pipeline.
+// Run: bench57 [benchmark name]
+
+void NameTableBench();
+void EncoderBench();
+
+static inline double BenchGetTimeSec()
+{
+    timespec time = {};
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return (double)time.tv_sec + (double)time.tv_nsec * 1e-9;
+}
+
+#endif
@@ -0,0 +1,131 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Benchmarks.h"
+#include "BackEnd/TranslateFromIR/x64/x64Encode.h"
+#include "BackEnd/TranslateFromIR/x64/CodeArray/CodeArray.h"
+
+struct EncoderBenchInstruction
+{
+    X64Operation operation;
+    size_t       numberOfOperands;
+    X64Operand   operand1;
+    X64Operand   operand2;
+};
+
+static double EncodeAll         (const EncoderBenchInstruction* instructions, bool inPlace,
+                                 size_t* outCodeSize);
+static void   FillInstructions  (EncoderBenchInstruction* instructions, size_t count);
+static size_t EncodeAllocating  (CodeArrayType* code, const EncoderBenchInstruction* instruction);
+
+static const size_t InstructionsCount = 1 << 12;
+static const size_t Repeats           = 1 << 9;
+
+void EncoderBench()
+{
+    EncoderBenchInstruction* instructions =
+        (EncoderBenchInstruction*)calloc(InstructionsCount, sizeof(*instructions));
+    assert(instructions);
+
+    FillInstructions(instructions, InstructionsCount);
+
+    printf("%12s %18s %14s\n", "encoder", "M instructions/s", "code bytes");
+
+    size_t codeSize = 0;
+    double time     = EncodeAll(instructions, false, &codeSize);
+    printf("%12s %18.1f %14zu\n", "calloc+push", 
+           (double)(InstructionsCount * Repeats) / time * 1e-6, codeSize);
+
+    time = EncodeAll(instructions, true, &codeSize);
+    printf("%12s %18.1f %14zu\n", "in place", 
+           (double)(InstructionsCount * Repeats) / time * 1e-6, codeSize);
+
+    free(instructions);
+}
+
+static double EncodeAll(const EncoderBenchInstruction* instructions, bool inPlace, 
+                        size_t* outCodeSize)
+{
+    assert(instructions);
+    assert(outCodeSize);
+
+    double begin = BenchGetTimeSec();
+    for (size_t repeat = 0; repeat < Repeats; ++repeat)
+    {
+        CodeArrayType* code = nullptr;
+        CodeArrayCtor(&code, inPlace ? InstructionsCount * X64MaxInstructionLen : 0);
+
+        for (size_t i = 0; i < InstructionsCount; ++i)
+        {
+            const EncoderBenchInstruction* instruction = &instructions[i];
+
+            if (inPlace)
+                EncodeX64(code, instruction->operation, instruction->numberOfOperands,
+                          instruction->operand1, instruction->operand2);
+            else
+                EncodeAllocating(code, instruction);
+        }
+
+        *outCodeSize = code->size;
+        CodeArrayDtor(code);
+    }
+
+    return BenchGetTimeSec() - begin;
+}
+
+// Mix of instructions emitted for expressions, pushes / pops and branches
+static void FillInstructions(EncoderBenchInstruction* instructions, size_t count)
+{
+    assert(instructions);
+
+    const X64Operand xmm0      = X64OperandRegCreate(X64Register::XMM0);
+    const X64Operand xmm1      = X64OperandRegCreate(X64Register::XMM1);
+    const X64Operand rsp       = X64OperandRegCreate(X64Register::RSP);
+    const X64Operand rbp       = X64OperandRegCreate(X64Register::RBP);
+    const X64Operand stackTop  = X64OperandMemCreate(X64Register::RSP, 0);
+    const X64Operand local     = X64OperandMemCreate(X64Register::RBP, -16);
+    const X64Operand xmmSize   = X64OperandImmCreate(16);
+    const X64Operand jumpShift = X64OperandImmCreate(-57);
+    const X64Operand empty     = {};
+
+    const EncoderBenchInstruction pattern[] =
+    {
+        {X64Operation::MOVSD,  2, xmm0,      local},
+        {X64Operation::SUB,    2, rsp,       xmmSize},
+        {X64Operation::MOVSD,  2, stackTop,  xmm0},
+        {X64Operation::MOVSD,  2, xmm1,      stackTop},
+        {X64Operation::ADD,    2, rsp,       xmmSize},
+        {X64Operation::ADDSD,  2, xmm0,      xmm1},
+        {X64Operation::COMISD, 2, xmm0,      xmm1},
+        {X64Operation::JE,     1, jumpShift, empty},
+        {X64Operation::PUSH,   1, rbp,       empty},
+        {X64Operation::CALL,   1, jumpShift, empty},
+    };
+
+    static const size_t patternLen = sizeof(pattern) / sizeof(*pattern);
+
+    for (size_t i = 0; i < count; ++i)
+        instructions[i] = pattern[i % patternLen];
+}
+
+// Emulates the old encoder interface: heap buffer for every instruction, pushed byte by byte
+static size_t EncodeAllocating(CodeArrayType* code, const EncoderBenchInstruction* instruction)
+{
+    assert(code);
+    assert(instruction);
+
+    uint8_t* instructionCode = (uint8_t*)calloc(X64MaxInstructionLen, sizeof(*instructionCode));
+    assert(instructionCode);
+
+    size_t instructionLen = EncodeX64(instructionCode, instruction->operation,
+                                      instruction->numberOfOperands,
+                                      instruction->operand1, instruction->operand2);
+
+    for (size_t i = 0; i < instructionLen; ++i)
+        CodeArrayPush(code, instructionCode[i]);
+
+    free(instructionCode);
+
+    return instructionLen;
+}
@@ -0,0 +1,92 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Benchmarks.h"
+#include "Tree/NameTable/NameTable.h"
+
+static void FillNames(NameTableType* table, const size_t namesCount);
+static Name* LinearFind(const NameTableType* table, const char* name);
+
+static const size_t LookupsCount     = 1000000;
+static const size_t MaxLinearCount   = 10000;   // linear scan is too slow after that
+static const size_t MaxNameLength    = 32;
+
+void NameTableBench()
+{
+    static const size_t namesCounts[] = {10, 100, 1000, 10000, 100000};
+
+    printf("%10s %18s %18s\n", "locals", "hash ns/lookup", "linear ns/lookup");
+
+    for (size_t namesCount : namesCounts)
+    {
+        NameTableType* table = nullptr;
+        NameTableCtor(&table);
+        FillNames(table, namesCount);
+
+        char   name[MaxNameLength] = "";
+        size_t found = 0;
+        
+        srand(57);
+        double begin = BenchGetTimeSec();
+        for (size_t i = 0; i < LookupsCount; ++i)
+        {
+            snprintf(name, MaxNameLength, "var%zu", (size_t)rand() % namesCount);
+
+            Name* outName = nullptr;
+            NameTableFind(table, name, &outName);
+            found += outName != nullptr;
+        }
+        double hashTime = BenchGetTimeSec() - begin;
+
+        double linearTime = -1;
+        if (namesCount <= MaxLinearCount)
+        {
+            srand(57);
+            begin = BenchGetTimeSec();
+            for (size_t i = 0; i < LookupsCount; ++i)
+            {
+                snprintf(name, MaxNameLength, "var%zu", (size_t)rand() % namesCount);
+
+                found += LinearFind(table, name) != nullptr;
+            }
+            linearTime = BenchGetTimeSec() - begin;
+        }
+
+        if (found != (linearTime < 0 ? 1 : 2) * LookupsCount)
+            printf("Lookup failed!\n");
+
+        if (linearTime < 0)
+            printf("%10zu %18.1f %18s\n", namesCount, hashTime * 1e9 / LookupsCount, "-");
+        else
+            printf("%10zu %18.1f %18.1f\n", namesCount, hashTime   * 1e9 / LookupsCount,
+                                                        linearTime * 1e9 / LookupsCount);
+
+        NameTableDtor(table);
+    }
+}
+
+static void FillNames(NameTableType* table, const size_t namesCount)
+{
+    char name[MaxNameLength] = "";
+
+    for (size_t i = 0; i < namesCount; ++i)
+    {
+        snprintf(name, MaxNameLength, "var%zu", i);
+
+        Name pushName = {};
+        NameCtor(&pushName, name, nullptr, 0);
+        NameTablePush(table, pushName);
+    }
+}
+
+static Name* LinearFind(const NameTableType* table, const char* name)
+{
+    for (size_t i = 0; i < table->size; ++i)
+    {
+        if (strcmp(table->data[i].name, name) == 0)
+            return table->data + i;
+    }
+
+    return nullptr;
+}
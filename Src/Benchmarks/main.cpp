@@ -0,0 +1,54 @@
+#include <stdio.h>
+#include <string.h>
+
+#include "Benchmarks.h"
+#include "Common/Log.h"
+
+struct BenchInfo
+{
+    const char* name;
+    void (*BenchFunc)();
+};
+
+static const BenchInfo Benchmarks[] = 
+{
+    {"nameTable", NameTableBench},
+    {"encoder",   EncoderBench},
+};
+
+static const size_t BenchmarksCount = sizeof(Benchmarks) / sizeof(*Benchmarks);
+
+int main(int argc, const char* argv[])
+{
+    LogOpen(argv[0]);
+
+    if (argc < 2)
+    {
+        printf("Usage: %s [benchmark name | all]\n", argv[0]);
+        printf("Benchmarks:");
+        for (size_t i = 0; i < BenchmarksCount; ++i)
+            printf(" %s", Benchmarks[i].name);
+        printf("\n");
+
+        return 0;
+    }
+
+    bool found = false;
+    for (size_t i = 0; i < BenchmarksCount; ++i)
+    {
+        if (strcmp(argv[1], "all") != 0 && strcmp(argv[1], Benchmarks[i].name) != 0)
+            continue;
+
+        printf("-------- %s --------\n", Benchmarks[i].name);
+        Benchmarks[i].BenchFunc();
+        found = true;
+    }
+
+    if (!found)
+    {
+        printf("No benchmark named %s\n", argv[1]);
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,234 @@
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "StringIntern.h"
+
+struct StringInterner
+{
+    char** blocks;          ///< storage for strings, blocks are never reallocated
+    size_t blocksCount;
+    size_t blocksCapacity;
+    size_t lastBlockPos;
+    
+    const char** strings;   ///< id -> string
+    size_t       stringsCount;
+    size_t       stringsCapacity;
+
+    InternId* hashIndex;    ///< open addressing index: id + 1 or 0 for empty cell
+    size_t    hashIndexCapacity;
+};
+
+static StringInterner* GetInterner();
+static void StringInternerDtor();
+
+static const char* StringInternerStore(StringInterner* interner, const char* string, 
+                                                                 const size_t length);
+static void StringInternerRehash      (StringInterner* interner);
+static inline uint64_t StringHash     (const char* string, size_t* outLength);
+
+static const size_t StringsBlockSize          = 1 << 16;
+static const size_t STANDARD_CAPACITY         = 256;
+static const size_t STANDARD_BLOCKS_CAPACITY  = 16;
+
+static StringInterner Interner       = {};
+static bool           InternerInited = false;
+
+//---------------------------------------------------------------------------------------
+
+InternId StringIntern(const char* string)
+{
+    assert(string);
+
+    StringInterner* interner = GetInterner();
+
+    size_t   length = 0;
+    uint64_t hash   = StringHash(string, &length);
+    size_t   mask   = interner->hashIndexCapacity - 1;
+
+    size_t cell = hash & mask;
+    while (interner->hashIndex[cell] != 0)
+    {
+        InternId id = interner->hashIndex[cell] - 1;
+        if (strcmp(interner->strings[id], string) == 0)
+            return id;
+
+        cell = (cell + 1) & mask;
+    }
+
+    if (interner->stringsCount == interner->stringsCapacity)
+    {
+        interner->stringsCapacity *= 2;
+        interner->strings = (const char**)realloc(interner->strings, 
+                                                  interner->stringsCapacity * sizeof(*interner->strings));
+        assert(interner->strings);
+    }
+
+    InternId id = (InternId)interner->stringsCount;
+    interner->strings[id] = StringInternerStore(interner, string, length);
+    interner->stringsCount++;
+
+    interner->hashIndex[cell] = id + 1;
+
+    if (2 * interner->stringsCount > interner->hashIndexCapacity)
+        StringInternerRehash(interner);
+
+    return id;
+}
+
+InternId StringInternFind(const char* string)
+{
+    assert(string);
+
+    StringInterner* interner = GetInterner();
+
+    size_t   length = 0;
+    uint64_t hash   = StringHash(string, &length);
+    size_t   mask   = interner->hashIndexCapacity - 1;
+
+    for (size_t cell = hash & mask; interner->hashIndex[cell] != 0; cell = (cell + 1) & mask)
+    {
+        InternId id = interner->hashIndex[cell] - 1;
+        if (strcmp(interner->strings[id], string) == 0)
+            return id;
+    }
+
+    return NO_INTERN_ID;
+}
+
+const char* StringInternGet(InternId id)
+{
+    StringInterner* interner = GetInterner();
+
+    assert(id < interner->stringsCount);
+
+    return interner->strings[id];
+}
+
+const char* StringInternPtr(const char* string)
+{
+    return StringInternGet(StringIntern(string));
+}
+
+size_t StringInternCount()
+{
+    return GetInterner()->stringsCount;
+}
+
+//---------------------------------------------------------------------------------------
+
+static StringInterner* GetInterner()
+{
+    if (InternerInited)
+        return &Interner;
+
+    Interner.blocksCapacity    = STANDARD_BLOCKS_CAPACITY;
+    Interner.blocks            = (char**)calloc(Interner.blocksCapacity, sizeof(*Interner.blocks));
+
+    Interner.stringsCapacity   = STANDARD_CAPACITY;
+    Interner.strings           = (const char**)calloc(Interner.stringsCapacity, 
+                                                      sizeof(*Interner.strings));
+
+    Interner.hashIndexCapacity = 2 * STANDARD_CAPACITY;
+    Interner.hashIndex         = (InternId*)calloc(Interner.hashIndexCapacity, 
+                                                   sizeof(*Interner.hashIndex));
+
+    assert(Interner.blocks);
+    assert(Interner.strings);
+    assert(Interner.hashIndex);
+
+    InternerInited = true;
+    atexit(StringInternerDtor);
+
+    return &Interner;
+}
+
+static void StringInternerDtor()
+{
+    for (size_t i = 0; i < Interner.blocksCount; ++i)
+        free(Interner.blocks[i]);
+
+    free(Interner.blocks);
+    free(Interner.strings);
+    free(Interner.hashIndex);
+
+    Interner       = {};
+    InternerInited = false;
+}
+
+static const char* StringInternerStore(StringInterner* interner, const char* string, 
+                                                                 const size_t length)
+{
+    assert(interner);
+    assert(string);
+
+    size_t size = length + 1;
+
+    bool needNewBlock = interner->blocksCount == 0 || 
+                        interner->lastBlockPos + size > StringsBlockSize;
+
+    if (needNewBlock)
+    {
+        if (interner->blocksCount == interner->blocksCapacity)
+        {
+            interner->blocksCapacity *= 2;
+            interner->blocks = (char**)realloc(interner->blocks, 
+                                               interner->blocksCapacity * sizeof(*interner->blocks));
+            assert(interner->blocks);
+        }
+
+        size_t blockSize = size > StringsBlockSize ? size : StringsBlockSize;
+        interner->blocks[interner->blocksCount] = (char*)calloc(blockSize, 1);
+        assert(interner->blocks[interner->blocksCount]);
+
+        interner->blocksCount++;
+        interner->lastBlockPos = 0;
+    }
+
+    char* storedString = interner->blocks[interner->blocksCount - 1] + interner->lastBlockPos;
+    memcpy(storedString, string, size);
+    interner->lastBlockPos += size;
+
+    return storedString;
+}
+
+static void StringInternerRehash(StringInterner* interner)
+{
+    assert(interner);
+
+    interner->hashIndexCapacity *= 2;
+    free(interner->hashIndex);
+    interner->hashIndex = (InternId*)calloc(interner->hashIndexCapacity, sizeof(*interner->hashIndex));
+    assert(interner->hashIndex);
+
+    size_t mask = interner->hashIndexCapacity - 1;
+    for (size_t id = 0; id < interner->stringsCount; ++id)
+    {
+        size_t length = 0;
+        size_t cell   = StringHash(interner->strings[id], &length) & mask;
+
+        while (interner->hashIndex[cell] != 0)
+            cell = (cell + 1) & mask;
+
+        interner->hashIndex[cell] = (InternId)id + 1;
+    }
+}
+
+// FNV-1a
+static inline uint64_t StringHash(const char* string, size_t* outLength)
+{
+    assert(string);
+    assert(outLength);
+
+    uint64_t hash = 14695981039346656037ull;
+    
+    size_t length = 0;
+    for (; string[length] != '\0'; ++length)
+    {
+        hash ^= (unsigned char)string[length];
+        hash *= 1099511628211ull;
+    }
+
+    *outLength = length;
+    return hash;
+}
@@ -0,0 +1,33 @@
+#ifndef STRING_INTERN_H
+#define STRING_INTERN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// One interner for the whole compilation. Every string is stored once and never moves,
+// so interned pointers and ids can be compared instead of strcmp.
+// The interner is process-wide and is freed at exit: every compiler program (frontEnd,
+// middleEnd, backEnd, compile57) runs exactly one compilation, and ids are shared by
+// the stages - names in NameTable, function labels in IR and rodata strings - so they
+// must come from one id space. Only names and literals of the program are interned,
+// generated IR labels are not. Compiling several programs in one process would need an
+// interner per compilation passed to the lexer, NameTable and IR ctors.
+
+typedef uint32_t InternId;
+
+static const InternId NO_INTERN_ID = UINT32_MAX;
+
+/// @brief Interns string (copies it on the first call) and returns its id 
+InternId    StringIntern    (const char* string);
+
+/// @brief Returns id of already interned string or NO_INTERN_ID, doesn't intern it
+InternId    StringInternFind(const char* string);
+
+const char* StringInternGet (InternId id);
+
+/// @brief Same as StringInternGet(StringIntern(string))
+const char* StringInternPtr (const char* string);
+
+size_t      StringInternCount();
+
+#endif
@@ -0,0 +1,144 @@
+#include <assert.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "Tree/Tree.h"
+#include "FrontEnd/SyntaxParser.h"
+#include "MiddleEnd/MiddleEnd.h"
+#include "BackEnd/IR/IRBuild/IRBuild.h"
+#include "BackEnd/IR/IRPeephole/IRPeephole.h"
+#include "BackEnd/IR/IRRegAlloc/IRRegAlloc.h"
+#include "BackEnd/IR/IRFrame/IRFrame.h"
+#include "BackEnd/TranslateFromIR/x64/x64Translate.h"
+#include "FastInput/InputOutput.h"
+#include "Common/Log.h"
+#include "Common/CommandLineArgsParser.h"
+
+// Single process pipeline: frontEnd -> middleEnd -> backEnd without writing the tree
+// to text between stages. Separate binaries still exist for other frontends / backends.
+
+static void GetFileNames(int argc, const char* argv[],
+                         char** inFileName, char** outBinFileName, char** outAsmFileName);
+
+static const char* PeepholeStatsOption    = "-peephole-stats";
+static const char* KeepFramePointerOption = "-keep-frame-pointer";
+static const char* DeadCodeStatsOption    = "-dce-stats";
+
+int main(int argc, const char* argv[])
+{
+    LogOpen(argv[0]);
+
+    char* inFileName      = nullptr;
+    char* outAsmFileName  = nullptr;
+    char* outBinFileName  = nullptr;
+
+    GetFileNames(argc, argv, &inFileName, &outBinFileName, &outAsmFileName);
+
+    FILE* inStream     = fopen(inFileName, "r");
+    free(inFileName);
+    assert(inStream);
+    FILE* outBinStream = fopen(outBinFileName, "wb");
+    free(outBinFileName);
+    assert(outBinStream);
+
+    FILE* outAsmStream = nullptr;
+    if (outAsmFileName)
+    {
+        outAsmStream = fopen(outAsmFileName, "w");
+        free(outAsmFileName);
+        assert(outAsmStream);
+    }
+
+    char* inputTxt = ReadText(inStream);
+    assert(inputTxt);
+
+    SyntaxParserErrors err = SyntaxParserErrors::NO_ERR;
+    Tree tree = CodeParse(inputTxt, &err);
+    int  exitCode = (int)err;
+
+    if (err == SyntaxParserErrors::NO_ERR)
+    {
+        TreeInline(&tree);
+        TreePropagateConstants(&tree);
+        TreeSimplify(&tree);
+
+        // results of calls can make args of other calls constant
+        while (TreeEvaluatePureCalls(&tree) > 0)
+        {
+            TreePropagateConstants(&tree);
+            TreeSimplify(&tree);
+        }
+
+        size_t deadNodes = TreeRemoveDeadCode(&tree);
+        if (GetCommandLineArgPos(argc, argv, DeadCodeStatsOption) != NO_COMMAND_LINE_ARG)
+            printf("Dead code: removed nodes - %zu\n", deadNodes);
+
+        TreeHoistLoopInvariants(&tree);
+        TreeEliminateCommonExprs(&tree);
+
+        IRErrors irErr = IRErrors::NO_ERR;
+        IR* ir = IRBuild(&tree, &irErr);
+
+        if (irErr == IRErrors::NO_ERR)
+        {
+            IRRegAlloc(ir);
+
+            IRPeepholeStats peepholeStats = IRPeepholeStatsCtor();
+            IRPeephole(ir, &peepholeStats);
+            if (GetCommandLineArgPos(argc, argv, PeepholeStatsOption) != NO_COMMAND_LINE_ARG)
+                IRPeepholeStatsPrint(stdout, &peepholeStats);
+
+            IRFrameOptimize(ir, GetCommandLineArgPos(argc, argv, KeepFramePointerOption) != 
+                                 NO_COMMAND_LINE_ARG);
+
+            TranslateToX64(ir, outAsmStream, outBinStream);
+        }
+        else
+            exitCode = (int)irErr;
+
+        IRDtor(ir);
+    }
+
+    free(inputTxt);
+    TreeDtor(&tree);
+
+    fclose(inStream);
+    fclose(outBinStream);
+    if (outAsmStream) fclose(outAsmStream);
+
+    return exitCode;
+}
+
+static void GetFileNames(int argc, const char* argv[],
+                         char** inFileName, char** outBinFileName, char** outAsmFileName)
+{
+    static const char* asmOutputOption = "-S";
+
+    if (argc < 3)
+    {
+        printf("Usage: %s [file with code] [out binary file] [optional...]\n", argv[0]);
+        printf("Optional: %s (asm file output), %s (IR peephole pattern hits), "
+               "%s (RBP frames for profilers), %s (removed dead code)\n", 
+               asmOutputOption, PeepholeStatsOption, KeepFramePointerOption,
+               DeadCodeStatsOption);
+
+        exit(0);
+    }
+
+    *inFileName     = strdup(argv[1]);
+    *outBinFileName = strdup(argv[2]);
+
+    if (argc == 3)
+        return;
+
+    if (GetCommandLineArgPos(argc, argv, asmOutputOption) != NO_COMMAND_LINE_ARG)
+    {
+        static const size_t maxAsmFileName  = 256;
+        char    asmFileName[maxAsmFileName] = "";
+
+        snprintf(asmFileName, maxAsmFileName, "%s.s", *inFileName);
+
+        *outAsmFileName = strdup(asmFileName);
+    }
+}
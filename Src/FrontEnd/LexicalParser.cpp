@@ -5,6 +5,7 @@
 #include "LexicalParser.h"
 #include "Common/StringFuncs.h"
 #include "Common/Colors.h"
+#include "Common/StringIntern.h"
 #include "LexicalParserTokenType.h"
 
 static inline void SyntaxError(const size_t line, const size_t posErr, const char* str)
@@ -473,7 +474,7 @@ TokenValue TokenValueCreateName(const char* name)
 {
     TokenValue val =
     {
-        .name = strdup(name),
+        .name = StringInternPtr(name),
     };
 
     return val;
@@ -483,7 +484,7 @@ TokenValue TokenValueCreateLiteral(const char* string)
 {
     TokenValue val = 
     {
-        .stringLiteral = strdup(string),
+        .stringLiteral = StringInternPtr(string),
     };
 
     return val;
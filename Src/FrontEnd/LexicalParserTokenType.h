@@ -48,8 +48,8 @@ enum class LangOpId
 union TokenValue
 {
     LangOpId        langOpId;
-    char*           name;
-    char*           stringLiteral;
+    const char*     name;           ///< interned
+    const char*     stringLiteral;  ///< interned
     int             num;
 };
 
@@ -25,9 +25,11 @@ struct DescentState
     NameTableType* allNamesTable;
 
     const char* codeString;
+
+    Tree* tree;     ///< nodes are created in its arena
 };
 
-static void DescentStateCtor(DescentState* state, const char* codeString);
+static void DescentStateCtor(DescentState* state, const char* codeString, Tree* tree);
 static void DescentStateDtor(DescentState* state);
 
 #define POS(state) state->tokenPos
@@ -243,7 +245,7 @@ Tree CodeParse(const char* code, SyntaxParserErrors* outErr)
     TreeCtor(&tree);
 
     DescentState state = {};
-    DescentStateCtor(&state, code);
+    DescentStateCtor(&state, code, &tree);
 
     ParseOnTokens(code, &state.tokens);
 
@@ -273,7 +275,7 @@ static TreeNode* GetGrammar(DescentState* state, bool* outErr)
         TreeNode* tmpNode = GetFunc(state, outErr);
         IF_ERR_RET(outErr, root, tmpNode);
 
-        root = CREATE_NEW_FUNC_NODE(root, tmpNode);
+        root = CREATE_NEW_FUNC_NODE(state->tree, root, tmpNode);
     }
 
     SynAssert(state, PickToken(state, LangOpId::PROGRAM_END), outErr);
@@ -300,15 +302,21 @@ static TreeNode* GetFuncDef(DescentState* state, bool* outErr)
     TreeNode* typeNode = GetType(state, outErr);
     IF_ERR_RET(outErr, typeNode, nullptr);
 
+    // function names live in the global table, the previous function's table is closed here
+    state->currentLocalTable = state->globalTable;
+
     printf("Before creating func name\n");
     TreeNode* funcName = CreateVar(state, outErr);
     IF_ERR_RET(outErr, typeNode, funcName);
     
     printf("current nameid - %d\n", funcName->value.nameId);
-    assert(!state->globalTable->data[funcName->value.nameId].localNameTable);
-    state->globalTable->data[funcName->value.nameId].localNameTable = (void*)localNameTable;
+
+    // nameId indexes allNamesTable, function's own entry is the last one pushed to globalTable
+    size_t funcGlobalPos = state->globalTable->size - 1;
+    assert(!state->globalTable->data[funcGlobalPos].localNameTable);
+    state->globalTable->data[funcGlobalPos].localNameTable = (void*)localNameTable;
     state->currentLocalTable = localNameTable;
-    func = CREATE_FUNC_NODE(funcName);
+    func = CREATE_FUNC_NODE(state->tree, funcName);
 
     TreeNode* funcVars = GetFuncVarsDef(state, outErr);
     funcName->left = funcVars;
@@ -321,7 +329,7 @@ static TreeNode* GetFuncDef(DescentState* state, bool* outErr)
     funcName->right = funcCode;
     IF_ERR_RET(outErr, func, typeNode);
 
-    func = CREATE_TYPE_NODE(typeNode, func);
+    func = CREATE_TYPE_NODE(state->tree, typeNode, func);
 
     return func;
 }
@@ -331,7 +339,8 @@ static TreeNode* GetType(DescentState* state, bool* outErr)
     ConsumeToken(state, LangOpId::TYPE_INT, outErr);
     IF_ERR_RET(outErr, nullptr, nullptr);
 
-    return TreeNodeCreate(TreeCreateOpVal(TreeOperationId::TYPE_INT), TreeNodeValueType::OPERATION);
+    return TreeNodeCreate(state->tree, TreeCreateOpVal(TreeOperationId::TYPE_INT),
+                          TreeNodeValueType::OPERATION);
 }
 
 static TreeNode* GetFuncVarsDef(DescentState* state, bool* outErr)
@@ -347,7 +356,7 @@ static TreeNode* GetFuncVarsDef(DescentState* state, bool* outErr)
     TreeNode* varName = CreateVar(state, outErr);
     IF_ERR_RET(outErr, varType, varName);
 
-    varsDefNode = CREATE_TYPE_NODE(varType, varName);
+    varsDefNode = CREATE_TYPE_NODE(state->tree, varType, varName);
 
     while (!PickToken(state, LangOpId::FIFTY_SEVEN))
     {
@@ -355,10 +364,10 @@ static TreeNode* GetFuncVarsDef(DescentState* state, bool* outErr)
         IF_ERR_RET(outErr, varsDefNode, varType);
 
         varName = CreateVar(state, outErr);
-        TreeNode* tmpVar = CREATE_TYPE_NODE(varType, varName);
+        TreeNode* tmpVar = CREATE_TYPE_NODE(state->tree, varType, varName);
         IF_ERR_RET(outErr, tmpVar, varsDefNode);
 
-        varsDefNode = CREATE_COMMA_NODE(varsDefNode, tmpVar);
+        varsDefNode = CREATE_COMMA_NODE(state->tree, varsDefNode, tmpVar);
     }
 
     return varsDefNode;
@@ -393,7 +402,7 @@ static TreeNode* GetOp(DescentState* state, bool* outErr)
         ConsumeToken(state, LangOpId::FIFTY_SEVEN, outErr);
         IF_ERR_RET(outErr, opNode, nullptr);
 
-        TreeNode* jointNode = CREATE_LINE_END_NODE(nullptr, nullptr);
+        TreeNode* jointNode = CREATE_LINE_END_NODE(state->tree, nullptr, nullptr);
         opNode = jointNode;
         while (true)
         {
@@ -405,7 +414,7 @@ static TreeNode* GetOp(DescentState* state, bool* outErr)
             if (PickToken(state, LangOpId::L_BRACE))
                 break;
 
-            jointNode->right = CREATE_LINE_END_NODE(nullptr, nullptr);
+            jointNode->right = CREATE_LINE_END_NODE(state->tree, nullptr, nullptr);
             jointNode        = jointNode->right;
         }
 
@@ -427,7 +436,7 @@ static TreeNode* GetOp(DescentState* state, bool* outErr)
 
 static TreeNode* GetReturn(DescentState* state, bool* outErr)
 {
-    return CREATE_RETURN_NODE(GetOr(state, outErr));
+    return CREATE_RETURN_NODE(state->tree, GetOr(state, outErr));
 }
 
 static TreeNode* GetIf(DescentState* state, bool* outErr)
@@ -444,7 +453,7 @@ static TreeNode* GetIf(DescentState* state, bool* outErr)
     TreeNode* op = GetOp(state, outErr);
     IF_ERR_RET(outErr, condition, op);
 
-    return CREATE_IF_NODE(condition, op);
+    return CREATE_IF_NODE(state->tree, condition, op);
 }
 
 static TreeNode* GetWhile(DescentState* state, bool* outErr)
@@ -461,7 +470,7 @@ static TreeNode* GetWhile(DescentState* state, bool* outErr)
     TreeNode* op = GetOp(state, outErr);
     IF_ERR_RET(outErr, condition, op);
 
-    return CREATE_WHILE_NODE(condition, op);
+    return CREATE_WHILE_NODE(state->tree, condition, op);
 }
 
 static TreeNode* GetVarDef(DescentState* state, bool* outErr)
@@ -476,10 +485,10 @@ static TreeNode* GetVarDef(DescentState* state, bool* outErr)
     IF_ERR_RET(outErr, typeNode, varName);
 
     TreeNode* expr   = GetOr(state, outErr);
-    TreeNode* assign = CREATE_ASSIGN_NODE(varName, expr);
+    TreeNode* assign = CREATE_ASSIGN_NODE(state->tree, varName, expr);
     IF_ERR_RET(outErr, expr, typeNode);
 
-    return CREATE_TYPE_NODE(typeNode, assign);
+    return CREATE_TYPE_NODE(state->tree, typeNode, assign);
 }
 
 static TreeNode* GetExpr(DescentState* state, bool* outErr)
@@ -512,7 +521,7 @@ static TreeNode* GetPrint(DescentState* state, bool* outErr)
 
     IF_ERR_RET(outErr, arg, nullptr);
 
-    return CREATE_PRINT_NODE(arg);
+    return CREATE_PRINT_NODE(state->tree, arg);
 }
 
 static TreeNode* GetRead(DescentState* state, bool* outErr)
@@ -520,7 +529,7 @@ static TreeNode* GetRead(DescentState* state, bool* outErr)
     ConsumeToken(state, LangOpId::L_BRACE, outErr);
     IF_ERR_RET(outErr, nullptr, nullptr);
 
-    return CREATE_READ_NODE(nullptr, nullptr);
+    return CREATE_READ_NODE(state->tree, nullptr, nullptr);
 }
 
 static TreeNode* GetAssign(DescentState* state, bool* outErr)
@@ -534,7 +543,7 @@ static TreeNode* GetAssign(DescentState* state, bool* outErr)
     TreeNode* rightExpr = GetOr(state, outErr);
     IF_ERR_RET(outErr, rightExpr, var);
 
-    return CREATE_ASSIGN_NODE(var, rightExpr);
+    return CREATE_ASSIGN_NODE(state->tree, var, rightExpr);
 }
 
 static TreeNode* GetMadeFuncCall(DescentState* state, bool* outErr)
@@ -552,7 +561,7 @@ static TreeNode* GetMadeFuncCall(DescentState* state, bool* outErr)
     ConsumeToken(state, LangOpId::FIFTY_SEVEN, outErr);
     IF_ERR_RET(outErr, funcName, funcVars);
 
-    return CREATE_FUNC_CALL_NODE(funcName);
+    return CREATE_FUNC_CALL_NODE(state->tree, funcName);
 }
 
 static TreeNode* GetFuncVarsCall(DescentState* state, bool* outErr)
@@ -568,7 +577,7 @@ static TreeNode* GetFuncVarsCall(DescentState* state, bool* outErr)
         TreeNode* tmpVar = GetOr(state, outErr);
         IF_ERR_RET(outErr, vars, tmpVar);
 
-        vars = CREATE_COMMA_NODE(vars, tmpVar);
+        vars = CREATE_COMMA_NODE(state->tree, vars, tmpVar);
     }
     
     return vars;
@@ -587,7 +596,7 @@ static TreeNode* GetOr(DescentState* state, bool* outErr)
         TreeNode* tmpExpr = GetAnd(state, outErr);
         IF_ERR_RET(outErr, tmpExpr, allExpr);
 
-        allExpr = CREATE_OR_NODE(allExpr, tmpExpr);
+        allExpr = CREATE_OR_NODE(state->tree, allExpr, tmpExpr);
     }
 
     return allExpr;
@@ -606,7 +615,7 @@ static TreeNode* GetAnd(DescentState* state, bool* outErr)
         TreeNode* tmpExpr = GetCmp(state, outErr);
         IF_ERR_RET(outErr, tmpExpr, allExpr);
 
-        allExpr = CREATE_AND_NODE(allExpr, tmpExpr);
+        allExpr = CREATE_AND_NODE(state->tree, allExpr, tmpExpr);
     }
 
     return allExpr;
@@ -630,27 +639,27 @@ static TreeNode* GetCmp(DescentState* state, bool* outErr)
         switch (langOpId)
         {
             case LangOpId::LESS:
-                allExpr = CREATE_LESS_NODE(allExpr, newExpr);
+                allExpr = CREATE_LESS_NODE(state->tree, allExpr, newExpr);
                 break;
 
             case LangOpId::LESS_EQ:
-                allExpr = CREATE_LESS_EQ_NODE(allExpr, newExpr);
+                allExpr = CREATE_LESS_EQ_NODE(state->tree, allExpr, newExpr);
                 break;
             
             case LangOpId::GREATER:
-                allExpr = CREATE_GREATER_NODE(allExpr, newExpr);
+                allExpr = CREATE_GREATER_NODE(state->tree, allExpr, newExpr);
                 break;
 
             case LangOpId::GREATER_EQ:
-                allExpr = CREATE_GREATER_EQ_NODE(allExpr, newExpr);
+                allExpr = CREATE_GREATER_EQ_NODE(state->tree, allExpr, newExpr);
                 break;
 
             case LangOpId::EQ:
-                allExpr = CREATE_EQ_NODE(allExpr, newExpr);
+                allExpr = CREATE_EQ_NODE(state->tree, allExpr, newExpr);
                 break;
 
             case LangOpId::NOT_EQ:
-                allExpr = CREATE_NOT_EQ_NODE(allExpr, newExpr);
+                allExpr = CREATE_NOT_EQ_NODE(state->tree, allExpr, newExpr);
                 break;
             default:
                 SynAssert(state, false, outErr);
@@ -678,11 +687,11 @@ static TreeNode* GetAddSub(DescentState* state, bool* outErr)
         switch (langOpId)
         {
             case LangOpId::ADD:
-                allExpr = CREATE_ADD_NODE(allExpr, newExpr);
+                allExpr = CREATE_ADD_NODE(state->tree, allExpr, newExpr);
                 break;
             
             case LangOpId::SUB:
-                allExpr = CREATE_SUB_NODE(allExpr, newExpr);
+                allExpr = CREATE_SUB_NODE(state->tree, allExpr, newExpr);
                 break;
 
             default:
@@ -711,11 +720,11 @@ static TreeNode* GetMulDiv(DescentState* state, bool* outErr)
         switch (langOpId)
         {
             case LangOpId::MUL:
-                allExpr = CREATE_MUL_NODE(allExpr, newExpr);
+                allExpr = CREATE_MUL_NODE(state->tree, allExpr, newExpr);
                 break;
             
             case LangOpId::DIV:
-                allExpr = CREATE_DIV_NODE(allExpr, newExpr);
+                allExpr = CREATE_DIV_NODE(state->tree, allExpr, newExpr);
                 break;
 
             default:
@@ -742,7 +751,7 @@ static TreeNode* GetPow(DescentState* state, bool* outErr)
         IF_ERR_RET(outErr, allExpr, newExpr);
         
         assert(langOpId == LangOpId::POW);
-        allExpr = CREATE_POW_NODE(allExpr, newExpr);
+        allExpr = CREATE_POW_NODE(state->tree, allExpr, newExpr);
     }
 
     return allExpr;
@@ -785,23 +794,23 @@ static TreeNode* GetBuiltInFuncCall(DescentState* state, bool* outErr)
     switch (langOpId)
     {
         case LangOpId::SIN:
-            expr = CREATE_SIN_NODE(expr);
+            expr = CREATE_SIN_NODE(state->tree, expr);
             break;
 
         case LangOpId::COS:
-            expr = CREATE_COS_NODE(expr);
+            expr = CREATE_COS_NODE(state->tree, expr);
             break;
         
         case LangOpId::TAN:
-            expr = CREATE_TAN_NODE(expr);
+            expr = CREATE_TAN_NODE(state->tree, expr);
             break;
 
         case LangOpId::COT:
-            expr = CREATE_COT_NODE(expr);
+            expr = CREATE_COT_NODE(state->tree, expr);
             break;
 
         case LangOpId::SQRT:
-            expr = CREATE_SQRT_NODE(expr);
+            expr = CREATE_SQRT_NODE(state->tree, expr);
             break;
 
         default:
@@ -832,7 +841,7 @@ static TreeNode* GetNum(DescentState* state, bool* outErr)
     SynAssert(state, PickNum(state), outErr);
     IF_ERR_RET(outErr, nullptr, nullptr);
 
-    TreeNode* num = CREATE_NUM(state->tokens.data[POS(state)].value.num);
+    TreeNode* num = CREATE_NUM(state->tree, state->tokens.data[POS(state)].value.num);
     POS(state)++;
 
     return num;
@@ -854,7 +863,7 @@ static TreeNode* CreateVar(DescentState* state, bool* outErr)
 
     NameTablePush(state->currentLocalTable, pushLocalName);
     NameTablePush(state->allNamesTable, pushToAllNamesName);
-    varNode = CREATE_VAR(state->allNamesTable->size - 1);
+    varNode = CREATE_VAR(state->tree, state->allNamesTable->size - 1);
     
     POS(state)++;
 
@@ -875,13 +884,13 @@ static TreeNode* GetVar(DescentState* state, bool* outErr)
     TreeNode* varNode = nullptr;
 
     Name* outName = nullptr;
-    NameTableFind(state->allNamesTable, pushName.name, &outName);
+    NameTableFind(state->allNamesTable, pushName.id, &outName);
 
     SynAssert(state, outName != nullptr, outErr);
     IF_ERR_RET(outErr, varNode, nullptr);
     
     //TODO: здесь пройтись по локали + глобали, проверить на существование переменную типо
-    varNode = CREATE_VAR(outName - state->allNamesTable->data);
+    varNode = CREATE_VAR(state->tree, outName - state->allNamesTable->data);
     
     POS(state)++;
 
@@ -899,14 +908,14 @@ static TreeNode* GetLiteral(DescentState* state, bool* outErr)
     NameTablePush(state->allNamesTable, pushName);
 
     //TODO: здесь пройтись по локали + глобали, проверить на существование переменную типо
-    varNode = CREATE_STRING_LITERAL(state->allNamesTable->size - 1);
+    varNode = CREATE_STRING_LITERAL(state->tree, state->allNamesTable->size - 1);
 
     POS(state)++;
 
     return varNode;
 }
 
-static void DescentStateCtor(DescentState* state, const char* str)
+static void DescentStateCtor(DescentState* state, const char* str, Tree* tree)
 {
     TokensArrCtor(&state->tokens);
     NameTableCtor(&state->globalTable);
@@ -916,6 +925,8 @@ static void DescentStateCtor(DescentState* state, const char* str)
 
     state->codeString       = str;
     state->tokenPos  = 0;
+
+    state->tree = tree;
 }
 
 static void DescentStateDtor(DescentState* state)
@@ -5,9 +5,12 @@
 #include "Common/Log.h"
 #include "SyntaxParser.h"
 #include "FastInput/InputOutput.h"
+#include "Common/CommandLineArgsParser.h"
 
-int main(int argc, char* argv[])
+int main(int argc, const char* argv[])
 {
+    static const char* binaryOutputOption = "-b";
+
     assert(argc > 2);
     LogOpen(argv[0]);
     setbuf(stdout, nullptr);
@@ -21,7 +24,12 @@ int main(int argc, char* argv[])
     Tree ast = CodeParse(inputTxt, &err);
 
     if (err == SyntaxParserErrors::NO_ERR)
-        TreePrintPrefixFormat(&ast, outStream);
+    {
+        if (GetCommandLineArgPos(argc, argv, binaryOutputOption) != NO_COMMAND_LINE_ARG)
+            TreePrintBinaryFormat(&ast, outStream);
+        else
+            TreePrintPrefixFormat(&ast, outStream);
+    }
 
     TreeGraphicDump(&ast, true);
 
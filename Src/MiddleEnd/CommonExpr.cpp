@@ -0,0 +1,431 @@
+#include <assert.h>
+#include <stdlib.h>
+
+#include "MiddleEnd.h"
+#include "TreeUtils.h"
+#include "Tree/DSL.h"
+#include "Tree/NameTable/HashFuncs.h"
+
+// Pure subexpressions (without calls and input) of one LINE_END chain are hash-consed:
+// equal subtrees get equal ids, keyed on operation, variable and number of the node and
+// ids of its children. If the same subexpression is evaluated twice and none of its
+// variables is assigned in between, it is computed once into a fresh "cse.N" declaration
+// before the first use, so the backend allocates it as any other local. Largest repeated
+// subexpression is taken first, then the chain is scanned again.
+// IF / WHILE bodies are separate chains, WHILE conditions are left as is.
+
+static const size_t CseNoId   = (size_t)-1; ///< subtree is not a pure expression
+static const size_t CseNullId = (size_t)-2; ///< missing child
+
+struct CseEntry
+{
+    HashType hash;
+    uint64_t key[4];
+    size_t   id;
+};
+
+struct CseUse
+{
+    TreeNode** link;
+    size_t     id;
+    size_t     stmt;   ///< index of the statement in the chain
+    size_t     size;   ///< nodes in the subexpression
+};
+
+struct CseState
+{
+    Tree* tree;
+
+    CseEntry* entries;      ///< open addressing, id == CseNoId for free entries
+    size_t    entriesCount;
+    size_t    capacity;
+
+    CseUse* uses;
+    size_t  usesCount;
+    size_t  usesCapacity;
+
+    TreeNode*** stmts;      ///< links to LINE_END nodes of the chain
+    size_t      stmtsCount;
+    size_t      stmtsCapacity;
+
+    size_t namesCount;      ///< suffix for fresh names
+};
+
+static CseState CseStateCtor(Tree* tree);
+static void     CseStateDtor(CseState* state);
+
+static void   CseInFuncs(CseState* state, TreeNode* node);
+static void   CseInList (CseState* state, TreeNode** list);
+static bool   CseOnce   (CseState* state, TreeNode** list);
+static size_t CseVisit  (CseState* state, TreeNode** link, size_t stmt);
+static void   CseReplace(CseState* state, size_t first, size_t lastStmt);
+
+static size_t CseFindLastStmt(CseState* state, size_t first);
+static bool   IsKilled       (CseState* state, const TreeNode* expr, const TreeNode* stmt);
+
+static size_t CseTableGetId(CseState* state, uint64_t key0, uint64_t key1,
+                            uint64_t key2, uint64_t key3);
+static void   CseTableClear (CseState* state);
+static void   CseTableRehash(CseState* state);
+
+static void   CseUsesPush (CseState* state, CseUse use);
+static void   CseStmtsPush(CseState* state, TreeNode** link);
+
+
+
+//---------------------------------------------------------------------------------------
+
+void TreeEliminateCommonExprs(Tree* tree)
+{
+    assert(tree);
+
+    CseState state = CseStateCtor(tree);
+
+    CseInFuncs(&state, tree->root);
+
+    CseStateDtor(&state);
+}
+
+static void CseInFuncs(CseState* state, TreeNode* node)
+{
+    assert(state);
+
+    if (node == nullptr || !IS_OP(node))
+        return;
+
+    if (node->value.operation != TreeOperationId::FUNC)
+    {
+        CseInFuncs(state, node->left);
+        CseInFuncs(state, node->right);
+        return;
+    }
+
+    assert(node->left && IS_NAME(node->left));
+
+    CseInList(state, &node->left->right);
+}
+
+static void CseInList(CseState* state, TreeNode** list)
+{
+    assert(state);
+    assert(list);
+
+    // bodies are not changed by rewriting of the outer chain
+    for (TreeNode* link = *list; link; link = link->right)
+    {
+        if (TreeIsOp(link->left, TreeOperationId::IF) ||
+            TreeIsOp(link->left, TreeOperationId::WHILE))
+            CseInList(state, &link->left->right);
+    }
+
+    while (CseOnce(state, list))
+        ;
+}
+
+/// @return true if a subexpression was moved to a new variable
+static bool CseOnce(CseState* state, TreeNode** list)
+{
+    assert(state);
+    assert(list);
+
+    CseTableClear(state);
+    state->usesCount  = 0;
+    state->stmtsCount = 0;
+
+    for (TreeNode** link = list; *link; link = &(*link)->right)
+    {
+        assert(TreeIsOp(*link, TreeOperationId::LINE_END));
+
+        CseStmtsPush(state, link);
+        CseVisit(state, &(*link)->left, state->stmtsCount - 1);
+    }
+
+    size_t bestUse      = CseNoId;
+    size_t bestLastStmt = 0;
+    size_t bestSize     = 0;
+
+    for (size_t i = 0; i < state->usesCount; ++i)
+    {
+        const CseUse* use = state->uses + i;
+        if (use->size <= bestSize)
+            continue;
+
+        bool repeated = false;
+        for (size_t j = i + 1; j < state->usesCount && !repeated; ++j)
+            repeated = state->uses[j].id == use->id;
+
+        if (!repeated)
+            continue;
+
+        size_t lastStmt = CseFindLastStmt(state, i);
+
+        for (size_t j = i + 1; j < state->usesCount; ++j)
+        {
+            if (state->uses[j].id == use->id && state->uses[j].stmt <= lastStmt)
+            {
+                bestUse      = i;
+                bestLastStmt = lastStmt;
+                bestSize     = use->size;
+                break;
+            }
+        }
+    }
+
+    if (bestUse == CseNoId)
+        return false;
+
+    CseReplace(state, bestUse, bestLastStmt);
+
+    return true;
+}
+
+/// @return id of the subtree, CseNoId if it is not a pure expression
+static size_t CseVisit(CseState* state, TreeNode** link, size_t stmt)
+{
+    assert(state);
+    assert(link);
+
+    TreeNode* node = *link;
+
+    if (node == nullptr)
+        return CseNullId;
+
+    if (IS_NUM(node))
+        return CseTableGetId(state, (uint64_t)TreeNodeValueType::NUM, (uint64_t)node->value.num,
+                             CseNullId, CseNullId);
+
+    if (IS_NAME(node))
+        return CseTableGetId(state, (uint64_t)TreeNodeValueType::NAME,
+                             TreeGetNameId(state->tree, node), CseNullId, CseNullId);
+
+    if (!IS_OP(node))
+        return CseNoId;
+
+    switch (node->value.operation)
+    {
+        case TreeOperationId::FUNC_CALL:
+            assert(node->left && IS_NAME(node->left));
+            CseVisit(state, &node->left->left, stmt);
+            return CseNoId;
+
+        case TreeOperationId::WHILE:
+            return CseNoId;
+
+        case TreeOperationId::IF:
+            CseVisit(state, &node->left, stmt);
+            return CseNoId;
+
+        case TreeOperationId::ASSIGN:
+            CseVisit(state, &node->right, stmt);
+            return CseNoId;
+
+        default:
+            break;
+    }
+
+    size_t leftId  = CseVisit(state, &node->left,  stmt);
+    size_t rightId = CseVisit(state, &node->right, stmt);
+
+    if (!TreeOpIsPure(node->value.operation) || leftId == CseNoId || rightId == CseNoId)
+        return CseNoId;
+
+    size_t id = CseTableGetId(state, (uint64_t)TreeNodeValueType::OPERATION,
+                              (uint64_t)node->value.operation, leftId, rightId);
+
+    CseUsesPush(state, { link, id, stmt, TreeCountNodes(node) });
+
+    return id;
+}
+
+/// @brief moves the subexpression of the use first to a new variable declared before its
+///        statement, replaces uses of it up to the statement lastStmt
+static void CseReplace(CseState* state, size_t first, size_t lastStmt)
+{
+    assert(state);
+    assert(first < state->usesCount);
+
+    const CseUse* firstUse = state->uses + first;
+
+    TreeNode* var  = TreeCreateTempVar(state->tree, "cse", &state->namesCount);
+    TreeNode* value = TreeCopySubtree(state->tree, *firstUse->link);
+    TreeNode* decl  = CREATE_TYPE_NODE(state->tree, CREATE_TYPE_INT_NODE(state->tree, nullptr),
+                                       CREATE_ASSIGN_NODE(state->tree, var, value));
+
+    for (size_t i = first; i < state->usesCount; ++i)
+    {
+        const CseUse* use = state->uses + i;
+
+        if (use->id != firstUse->id || use->stmt > lastStmt)
+            continue;
+
+        TreeNodeDeepDtor(*use->link);
+        *use->link = CREATE_VAR(state->tree, var->value.nameId);
+    }
+
+    TreeNode** stmtLink = state->stmts[firstUse->stmt];
+    *stmtLink = CREATE_LINE_END_NODE(state->tree, decl, *stmtLink);
+}
+
+//---------------------------------------------------------------------------------------
+
+/// @return last statement, where the subexpression of the use first has the same value
+static size_t CseFindLastStmt(CseState* state, size_t first)
+{
+    assert(state);
+    assert(first < state->usesCount);
+
+    const CseUse* use = state->uses + first;
+
+    // statement is evaluated before its own assignments take effect
+    for (size_t i = use->stmt; i < state->stmtsCount; ++i)
+    {
+        if (IsKilled(state, *use->link, (*state->stmts[i])->left))
+            return i;
+    }
+
+    return state->stmtsCount - 1;
+}
+
+static bool IsKilled(CseState* state, const TreeNode* expr, const TreeNode* stmt)
+{
+    assert(state);
+
+    if (expr == nullptr)
+        return false;
+
+    if (IS_NAME(expr))
+        return TreeIsAssigned(state->tree, stmt, TreeGetNameId(state->tree, expr));
+
+    return IsKilled(state, expr->left, stmt) || IsKilled(state, expr->right, stmt);
+}
+
+//---------------------------------------------------------------------------------------
+
+static size_t CseTableGetId(CseState* state, uint64_t key0, uint64_t key1,
+                            uint64_t key2, uint64_t key3)
+{
+    assert(state);
+
+    if (2 * (state->entriesCount + 1) > state->capacity)
+        CseTableRehash(state);
+
+    uint64_t key[4] = { key0, key1, key2, key3 };
+    HashType hash   = NameTableMurmurHash(key, sizeof(key));
+
+    size_t mask = state->capacity - 1;
+    for (size_t pos = hash & mask; ; pos = (pos + 1) & mask)
+    {
+        CseEntry* entry = state->entries + pos;
+
+        if (entry->id == CseNoId)
+        {
+            entry->hash = hash;
+            entry->id   = state->entriesCount++;
+            for (size_t i = 0; i < 4; ++i)
+                entry->key[i] = key[i];
+
+            return entry->id;
+        }
+
+        if (entry->hash == hash && entry->key[0] == key0 && entry->key[1] == key1 &&
+                                   entry->key[2] == key2 && entry->key[3] == key3)
+            return entry->id;
+    }
+}
+
+static void CseTableClear(CseState* state)
+{
+    assert(state);
+
+    for (size_t i = 0; i < state->capacity; ++i)
+        state->entries[i].id = CseNoId;
+
+    state->entriesCount = 0;
+}
+
+static void CseTableRehash(CseState* state)
+{
+    assert(state);
+
+    size_t    oldCapacity = state->capacity;
+    CseEntry* oldEntries  = state->entries;
+
+    state->capacity = oldCapacity ? 2 * oldCapacity : 64;
+    state->entries  = (CseEntry*)calloc(state->capacity, sizeof(*state->entries));
+    assert(state->entries);
+
+    for (size_t i = 0; i < state->capacity; ++i)
+        state->entries[i].id = CseNoId;
+
+    size_t mask = state->capacity - 1;
+    for (size_t i = 0; i < oldCapacity; ++i)
+    {
+        if (oldEntries[i].id == CseNoId)
+            continue;
+
+        size_t pos = oldEntries[i].hash & mask;
+        while (state->entries[pos].id != CseNoId)
+            pos = (pos + 1) & mask;
+
+        state->entries[pos] = oldEntries[i];
+    }
+
+    free(oldEntries);
+}
+
+//---------------------------------------------------------------------------------------
+
+static void CseUsesPush(CseState* state, CseUse use)
+{
+    assert(state);
+
+    if (state->usesCount == state->usesCapacity)
+    {
+        state->usesCapacity = 2 * state->usesCapacity + 16;
+        state->uses = (CseUse*)realloc(state->uses, state->usesCapacity * sizeof(*state->uses));
+        assert(state->uses);
+    }
+
+    state->uses[state->usesCount++] = use;
+}
+
+static void CseStmtsPush(CseState* state, TreeNode** link)
+{
+    assert(state);
+    assert(link);
+
+    if (state->stmtsCount == state->stmtsCapacity)
+    {
+        state->stmtsCapacity = 2 * state->stmtsCapacity + 16;
+        state->stmts = (TreeNode***)realloc(state->stmts,
+                                            state->stmtsCapacity * sizeof(*state->stmts));
+        assert(state->stmts);
+    }
+
+    state->stmts[state->stmtsCount++] = link;
+}
+
+static CseState CseStateCtor(Tree* tree)
+{
+    assert(tree);
+
+    CseState state = {};
+    state.tree = tree;
+
+    CseTableRehash(&state);
+
+    return state;
+}
+
+static void CseStateDtor(CseState* state)
+{
+    assert(state);
+
+    free(state->entries);
+    free(state->uses);
+    free(state->stmts);
+
+    *state = {};
+}
+
+//---------------------------------------------------------------------------------------
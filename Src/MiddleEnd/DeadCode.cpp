@@ -0,0 +1,311 @@
+#include <assert.h>
+#include <stdlib.h>
+
+#include "MiddleEnd.h"
+#include "TreeUtils.h"
+#include "Tree/DSL.h"
+
+// Statements after RETURN in the same LINE_END chain are never executed. IF / WHILE with
+// condition folded to 0 are removed, IF with nonzero constant condition is replaced by its
+// body. Variables that are never read lose all their stores, if none of the stored values
+// calls functions or reads input - otherwise the variable stays declared for the calls.
+// Removing stores can make other variables unread, so it is repeated until nothing changes.
+
+struct DeadCodeVars
+{
+    InternId* data;
+    size_t    size;
+    size_t    capacity;
+};
+
+static size_t RemoveInFuncs      (TreeNode* node, const NameTableType* allNamesTable);
+static size_t RemoveUnreachable  (TreeNode** list);
+static size_t RemoveDeadStores   (TreeNode** list, const DeadCodeVars* readVars,
+                                  const DeadCodeVars* keptVars,
+                                  const NameTableType* allNamesTable);
+
+static void   CollectVars        (const TreeNode* node, DeadCodeVars* readVars,
+                                  DeadCodeVars* keptVars, const NameTableType* allNamesTable);
+
+static size_t RemoveLink         (TreeNode** link);
+static bool   IsDeadStore        (const TreeNode* stmt, const DeadCodeVars* readVars,
+                                  const DeadCodeVars* keptVars,
+                                  const NameTableType* allNamesTable);
+static const TreeNode* GetStore  (const TreeNode* stmt);
+
+static void   DeadCodeVarsPush   (DeadCodeVars* vars, InternId var);
+static bool   DeadCodeVarsHas    (const DeadCodeVars* vars, InternId var);
+
+
+//---------------------------------------------------------------------------------------
+
+size_t TreeRemoveDeadCode(Tree* tree)
+{
+    assert(tree);
+
+    return RemoveInFuncs(tree->root, tree->allNamesTable);
+}
+
+static size_t RemoveInFuncs(TreeNode* node, const NameTableType* allNamesTable)
+{
+    assert(allNamesTable);
+
+    if (node == nullptr || !IS_OP(node))
+        return 0;
+
+    if (node->value.operation != TreeOperationId::FUNC)
+        return RemoveInFuncs(node->left,  allNamesTable) +
+               RemoveInFuncs(node->right, allNamesTable);
+
+    assert(node->left && IS_NAME(node->left));
+
+    TreeNode** body = &node->left->right;
+
+    size_t removedNodes = RemoveUnreachable(body);
+
+    size_t removedStores = 0;
+    do
+    {
+        DeadCodeVars readVars = {};
+        DeadCodeVars keptVars = {};
+        CollectVars(*body, &readVars, &keptVars, allNamesTable);
+
+        removedStores = RemoveDeadStores(body, &readVars, &keptVars, allNamesTable);
+        removedNodes += removedStores;
+
+        free(readVars.data);
+        free(keptVars.data);
+    } while (removedStores != 0);
+
+    return removedNodes;
+}
+
+//---------------------------------------------------------------------------------------
+
+static size_t RemoveUnreachable(TreeNode** list)
+{
+    assert(list);
+
+    size_t removedNodes = 0;
+
+    TreeNode** link = list;
+    while (*link)
+    {
+        assert(TreeIsOp(*link, TreeOperationId::LINE_END));
+
+        TreeNode* stmt = (*link)->left;
+
+        bool isIf    = TreeIsOp(stmt, TreeOperationId::IF);
+        bool isWhile = TreeIsOp(stmt, TreeOperationId::WHILE);
+
+        if ((isIf || isWhile) && IS_NUM(stmt->left) && stmt->left->value.num == 0)
+        {
+            removedNodes += RemoveLink(link);
+            continue;
+        }
+
+        if (isIf || isWhile)
+            removedNodes += RemoveUnreachable(&stmt->right);
+
+        // body is pasted instead of the IF and checked again with the rest of the chain
+        if (isIf && IS_NUM(stmt->left))
+        {
+            TreeNode* body = stmt->right;
+            TreeNode* rest = (*link)->right;
+
+            stmt->right    = nullptr;
+            (*link)->right = nullptr;
+            removedNodes  += RemoveLink(link);
+
+            if (body)
+            {
+                TreeNode* bodyEnd = body;
+                while (bodyEnd->right)
+                    bodyEnd = bodyEnd->right;
+
+                bodyEnd->right = rest;
+                rest = body;
+            }
+
+            *link = rest;
+            continue;
+        }
+
+        if (TreeIsOp(stmt, TreeOperationId::RETURN) && (*link)->right)
+        {
+            removedNodes += TreeCountNodes((*link)->right);
+            TreeNodeDeepDtor((*link)->right);
+            (*link)->right = nullptr;
+        }
+
+        link = &(*link)->right;
+    }
+
+    return removedNodes;
+}
+
+static size_t RemoveDeadStores(TreeNode** list, const DeadCodeVars* readVars,
+                               const DeadCodeVars* keptVars,
+                               const NameTableType* allNamesTable)
+{
+    assert(list);
+    assert(readVars);
+    assert(keptVars);
+    assert(allNamesTable);
+
+    size_t removedNodes = 0;
+
+    TreeNode** link = list;
+    while (*link)
+    {
+        TreeNode* stmt = (*link)->left;
+
+        if (IsDeadStore(stmt, readVars, keptVars, allNamesTable))
+        {
+            removedNodes += RemoveLink(link);
+            continue;
+        }
+
+        if (TreeIsOp(stmt, TreeOperationId::IF) || TreeIsOp(stmt, TreeOperationId::WHILE))
+        {
+            removedNodes += RemoveDeadStores(&stmt->right, readVars, keptVars, allNamesTable);
+
+            // empty while is kept - it may never end
+            if (TreeIsOp(stmt, TreeOperationId::IF) && stmt->right == nullptr &&
+                !TreeHasCalls(stmt->left))
+            {
+                removedNodes += RemoveLink(link);
+                continue;
+            }
+        }
+
+        link = &(*link)->right;
+    }
+
+    return removedNodes;
+}
+
+//---------------------------------------------------------------------------------------
+
+/// @brief readVars - variables used as values, keptVars - variables with stores
+///        that call functions or read input
+static void CollectVars(const TreeNode* node, DeadCodeVars* readVars,
+                        DeadCodeVars* keptVars, const NameTableType* allNamesTable)
+{
+    assert(readVars);
+    assert(keptVars);
+    assert(allNamesTable);
+
+    if (node == nullptr)
+        return;
+
+    if (IS_NAME(node))
+    {
+        DeadCodeVarsPush(readVars, NameTableGetNameId(allNamesTable, node->value.nameId));
+        return;
+    }
+
+    if (TreeIsOp(node, TreeOperationId::FUNC_CALL))
+    {
+        CollectVars(node->left->left, readVars, keptVars, allNamesTable);
+        return;
+    }
+
+    if (TreeIsOp(node, TreeOperationId::ASSIGN))
+    {
+        assert(node->left && IS_NAME(node->left));
+
+        if (TreeHasCalls(node->right))
+            DeadCodeVarsPush(keptVars, NameTableGetNameId(allNamesTable,
+                                                          node->left->value.nameId));
+
+        CollectVars(node->right, readVars, keptVars, allNamesTable);
+        return;
+    }
+
+    CollectVars(node->left,  readVars, keptVars, allNamesTable);
+    CollectVars(node->right, readVars, keptVars, allNamesTable);
+}
+
+static bool IsDeadStore(const TreeNode* stmt, const DeadCodeVars* readVars,
+                        const DeadCodeVars* keptVars, const NameTableType* allNamesTable)
+{
+    assert(readVars);
+    assert(keptVars);
+    assert(allNamesTable);
+
+    const TreeNode* store = GetStore(stmt);
+
+    if (store == nullptr)
+        return false;
+
+    InternId var = NameTableGetNameId(allNamesTable, store->left->value.nameId);
+
+    return !DeadCodeVarsHas(readVars, var) && !DeadCodeVarsHas(keptVars, var);
+}
+
+/// @return ASSIGN of the assignment or the declaration statement
+static const TreeNode* GetStore(const TreeNode* stmt)
+{
+    if (TreeIsOp(stmt, TreeOperationId::TYPE))
+        stmt = stmt->right;
+
+    if (!TreeIsOp(stmt, TreeOperationId::ASSIGN))
+        return nullptr;
+
+    assert(stmt->left && IS_NAME(stmt->left));
+
+    return stmt;
+}
+
+/// @return number of removed nodes: statement and its LINE_END
+static size_t RemoveLink(TreeNode** link)
+{
+    assert(link);
+    assert(*link);
+
+    TreeNode* removedLink = *link;
+    size_t removedNodes = 1 + TreeCountNodes(removedLink->left);
+
+    *link = removedLink->right;
+
+    if (removedLink->left)
+        TreeNodeDeepDtor(removedLink->left);
+    TreeNodeDtor(removedLink);
+
+    return removedNodes;
+}
+
+//---------------------------------------------------------------------------------------
+
+static void DeadCodeVarsPush(DeadCodeVars* vars, InternId var)
+{
+    assert(vars);
+
+    if (DeadCodeVarsHas(vars, var))
+        return;
+
+    if (vars->size == vars->capacity)
+    {
+        vars->capacity = 2 * vars->capacity + 8;
+        vars->data = (InternId*)realloc(vars->data, vars->capacity * sizeof(*vars->data));
+        assert(vars->data);
+    }
+
+    vars->data[vars->size++] = var;
+}
+
+static bool DeadCodeVarsHas(const DeadCodeVars* vars, InternId var)
+{
+    assert(vars);
+
+    for (size_t i = 0; i < vars->size; ++i)
+    {
+        if (vars->data[i] == var)
+            return true;
+    }
+
+    return false;
+}
+
+//---------------------------------------------------------------------------------------
@@ -0,0 +1,762 @@
+#include <assert.h>
+#include <stdlib.h>
+
+#include "MiddleEnd.h"
+#include "TreeUtils.h"
+#include "Tree/DSL.h"
+
+// Calls of small functions are replaced by copies of the callee body, so constant folding
+// works across the former call boundary. Callee locals and params get fresh names.
+// Body that is a single pure RETURN is substituted right into the expression. Other bodies
+// are pasted before the statement, whose whole right side (or returned value) is the call.
+// Early RETURNs of the pasted body store result and "done" flag, statements after them
+// are guarded with IF(done == 0).
+// Callees are processed before callers, pasted code is not scanned again, so recursive
+// function is unrolled at most once into its callers and never into itself.
+
+static const size_t InlineMaxNodes = 64; ///< max nodes in callee body
+
+enum class InlineFuncState
+{
+    NOT_VISITED,
+    IN_PROGRESS,
+    DONE,
+};
+
+struct InlineFunc
+{
+    InternId  name;
+
+    TreeNode* params;
+    TreeNode* body;
+
+    size_t    paramsCount;
+
+    InlineFuncState state;
+};
+
+struct InlineRename
+{
+    InternId  from;
+    TreeNode* to;       ///< copied instead of the name
+};
+
+struct InlineState
+{
+    Tree* tree;
+
+    InlineFunc* funcs;
+    size_t      funcsCount;
+    size_t      funcsCapacity;
+
+    InlineRename* renames;
+    size_t        renamesCount;
+    size_t        renamesCapacity;
+
+    const InlineFunc* caller;
+
+    size_t namesCount;  ///< suffix for fresh names
+
+    TreeNode* resultVar;
+    TreeNode* doneVar;
+};
+
+static InlineState InlineStateCtor(Tree* tree);
+static void        InlineStateDtor(InlineState* state);
+
+static void InlineFuncCollect(InlineState* state, TreeNode* node);
+static void InlineFuncPush   (InlineState* state, TreeNode* funcNode);
+static InlineFunc* InlineFuncFind(InlineState* state, InternId name);
+
+static void      InlineInFunc       (InlineState* state, InlineFunc* func);
+static void      InlineStatements   (InlineState* state, TreeNode* list);
+static TreeNode* InlineStatement    (InlineState* state, TreeNode* link);
+static void      InlineExpr         (InlineState* state, TreeNode** node);
+static TreeNode* InlineExprCall     (InlineState* state, TreeNode* call, InlineFunc* callee);
+static TreeNode* InlineStatementCall(InlineState* state, TreeNode* link, TreeNode** site,
+                                     InlineFunc* callee);
+
+static InlineFunc* GetCallee(InlineState* state, const TreeNode* call);
+static bool CanInlineExpr     (InlineState* state, const TreeNode* call,
+                               const InlineFunc* callee);
+static bool CanInlineStatement(const InlineFunc* callee);
+static bool CanGuardReturns   (const TreeNode* node);
+static bool IsLastReturnOnly  (const TreeNode* body);
+
+static TreeNode* GuardReturns(InlineState* state, TreeNode* list);
+
+static void      RenamesPush  (InlineState* state, InternId from, TreeNode* to);
+static void      RenameLocals (InlineState* state, const TreeNode* node);
+static TreeNode* CopyTree     (InlineState* state, const TreeNode* node, bool rename);
+static TreeNode* CreateVar    (InlineState* state, const TreeNode* nameNode);
+static TreeNode* CreateDecl   (InlineState* state, TreeNode* var, TreeNode* value);
+static TreeNode* CreateNotDone(InlineState* state);
+
+static TreeNode** ListToArray  (TreeNode* list, size_t* outCount);
+static void       ListToArray  (TreeNode* list, TreeNode** array, size_t* pos);
+static size_t     CountListSize(const TreeNode* list);
+static size_t     CountNameUses(InlineState* state, const TreeNode* node, InternId name);
+static bool       IsBoolExpr   (const TreeNode* node);
+
+
+//---------------------------------------------------------------------------------------
+
+void TreeInline(Tree* tree)
+{
+    assert(tree);
+
+    InlineState state = InlineStateCtor(tree);
+
+    InlineFuncCollect(&state, tree->root);
+
+    for (size_t i = 0; i < state.funcsCount; ++i)
+    {
+        if (state.funcs[i].state == InlineFuncState::NOT_VISITED)
+            InlineInFunc(&state, state.funcs + i);
+    }
+
+    InlineStateDtor(&state);
+}
+
+//---------------------------------------------------------------------------------------
+
+static void InlineInFunc(InlineState* state, InlineFunc* func)
+{
+    assert(state);
+    assert(func);
+
+    const InlineFunc* prevCaller = state->caller;
+
+    func->state   = InlineFuncState::IN_PROGRESS;
+    state->caller = func;
+
+    InlineStatements(state, func->body);
+
+    func->state   = InlineFuncState::DONE;
+    state->caller = prevCaller;
+}
+
+static void InlineStatements(InlineState* state, TreeNode* list)
+{
+    assert(state);
+
+    for (TreeNode* link = list; link; link = link->right)
+    {
+        assert(TreeIsOp(link, TreeOperationId::LINE_END));
+
+        link = InlineStatement(state, link);
+    }
+}
+
+/// @return LINE_END holding the statement after pasting callee body before it
+static TreeNode* InlineStatement(InlineState* state, TreeNode* link)
+{
+    assert(state);
+    assert(link);
+
+    TreeNode*  stmt = link->left;
+    TreeNode** site = nullptr;
+
+    if (stmt == nullptr || !IS_OP(stmt))
+        return link;
+
+    switch (stmt->value.operation)
+    {
+        case TreeOperationId::TYPE:
+            if (TreeIsOp(stmt->right, TreeOperationId::ASSIGN))
+                site = &stmt->right->right;
+            break;
+
+        case TreeOperationId::ASSIGN:
+            site = &stmt->right;
+            break;
+
+        case TreeOperationId::RETURN:
+            site = &stmt->left;
+            break;
+
+        case TreeOperationId::IF:
+        case TreeOperationId::WHILE:
+            InlineExpr(state, &stmt->left);
+            InlineStatements(state, stmt->right);
+            break;
+
+        default:
+            InlineExpr(state, &stmt->left);
+            InlineExpr(state, &stmt->right);
+            break;
+    }
+
+    if (site == nullptr || *site == nullptr)
+        return link;
+
+    if (!TreeIsOp(*site, TreeOperationId::FUNC_CALL))
+    {
+        InlineExpr(state, site);
+        return link;
+    }
+
+    InlineExpr(state, &(*site)->left->left);
+
+    InlineFunc* callee = GetCallee(state, *site);
+
+    if (callee == nullptr)
+        return link;
+
+    if (CanInlineExpr(state, *site, callee))
+    {
+        *site = InlineExprCall(state, *site, callee);
+        return link;
+    }
+
+    if (CanInlineStatement(callee))
+        return InlineStatementCall(state, link, site, callee);
+
+    return link;
+}
+
+static void InlineExpr(InlineState* state, TreeNode** node)
+{
+    assert(state);
+    assert(node);
+
+    if (*node == nullptr)
+        return;
+
+    InlineExpr(state, &(*node)->left);
+    InlineExpr(state, &(*node)->right);
+
+    if (!TreeIsOp(*node, TreeOperationId::FUNC_CALL))
+        return;
+
+    InlineFunc* callee = GetCallee(state, *node);
+
+    if (callee && CanInlineExpr(state, *node, callee))
+        *node = InlineExprCall(state, *node, callee);
+}
+
+static TreeNode* InlineExprCall(InlineState* state, TreeNode* call, InlineFunc* callee)
+{
+    assert(state);
+    assert(call);
+    assert(callee);
+
+    size_t paramsCount = 0;
+    size_t argsCount   = 0;
+    TreeNode** params = ListToArray(callee->params,  &paramsCount);
+    TreeNode** args   = ListToArray(call->left->left, &argsCount);
+
+    assert(paramsCount == argsCount);
+
+    state->renamesCount = 0;
+    for (size_t i = 0; i < paramsCount; ++i)
+        RenamesPush(state, TreeGetNameId(state->tree, params[i]->right), args[i]);
+
+    TreeNode* expr = CopyTree(state, callee->body->left->left, true);
+
+    free(params);
+    free(args);
+
+    return expr;
+}
+
+static TreeNode* InlineStatementCall(InlineState* state, TreeNode* link, TreeNode** site,
+                                     InlineFunc* callee)
+{
+    assert(state);
+    assert(link);
+    assert(site);
+    assert(callee);
+
+    TreeNode*  pasted = nullptr;
+    TreeNode** tail   = &pasted;
+
+#define PASTE(STMT)                                     \
+    do                                                  \
+    {                                                   \
+        *tail = CREATE_LINE_END_NODE(state->tree, (STMT), nullptr);  \
+        tail  = &(*tail)->right;                        \
+    } while (0)
+
+    size_t paramsCount = 0;
+    size_t argsCount   = 0;
+    TreeNode** params = ListToArray(callee->params,   &paramsCount);
+    TreeNode** args   = ListToArray((*site)->left->left, &argsCount);
+
+    assert(paramsCount == argsCount);
+
+    state->renamesCount = 0;
+    for (size_t i = 0; i < paramsCount; ++i)
+    {
+        TreeNode* paramName = params[i]->right;
+        InternId  paramId   = TreeGetNameId(state->tree, paramName);
+
+        if ((IS_NUM(args[i]) || IS_NAME(args[i])) &&
+            !TreeIsAssigned(state->tree, callee->body, paramId))
+        {
+            RenamesPush(state, paramId, args[i]);
+            continue;
+        }
+
+        TreeNode* var = CreateVar(state, paramName);
+        RenamesPush(state, paramId, var);
+        PASTE(CreateDecl(state, CopyTree(state, var, false), args[i]));
+    }
+
+    free(params);
+    free(args);
+
+    RenameLocals(state, callee->body);
+
+    if (IsLastReturnOnly(callee->body))
+    {
+        const TreeNode* stmtLink = callee->body;
+        for (; stmtLink->right; stmtLink = stmtLink->right)
+            PASTE(CopyTree(state, stmtLink->left, true));
+
+        *site = CopyTree(state, stmtLink->left->left, true);
+    }
+    else
+    {
+        state->resultVar = CreateVar(state, nullptr);
+        state->doneVar   = CreateVar(state, nullptr);
+
+        PASTE(CreateDecl(state, CopyTree(state, state->resultVar, false),
+                         CREATE_NUM(state->tree, 0)));
+        PASTE(CreateDecl(state, CopyTree(state, state->doneVar,   false),
+                         CREATE_NUM(state->tree, 0)));
+
+        *tail = GuardReturns(state, CopyTree(state, callee->body, true));
+        while (*tail)
+            tail = &(*tail)->right;
+
+        *site = CopyTree(state, state->resultVar, false);
+    }
+
+#undef PASTE
+
+    if (pasted == nullptr)
+        return link;
+
+    *tail = CREATE_LINE_END_NODE(state->tree, link->left, link->right);
+
+    TreeNode* stmtLink = *tail;
+
+    link->left  = pasted->left;
+    link->right = pasted->right;
+    TreeNodeDtor(pasted);
+
+    return stmtLink;
+}
+
+//---------------------------------------------------------------------------------------
+
+/// @brief RETURN x becomes result = x, done = 1; statements after the ones containing
+///        RETURN run under IF(done == 0), loops containing RETURN check done too
+static TreeNode* GuardReturns(InlineState* state, TreeNode* list)
+{
+    assert(state);
+
+    if (list == nullptr)
+        return nullptr;
+
+    assert(TreeIsOp(list, TreeOperationId::LINE_END));
+
+    TreeNode* stmt = list->left;
+
+    if (TreeIsOp(stmt, TreeOperationId::RETURN))
+    {
+        list->left  = CREATE_ASSIGN_NODE(state->tree, CopyTree(state, state->resultVar, false),
+                                         stmt->left);
+        list->right = CREATE_LINE_END_NODE(state->tree, 
+                        CREATE_ASSIGN_NODE(state->tree, CopyTree(state, state->doneVar, false),
+                                           CREATE_NUM(state->tree, 1)), nullptr);
+        return list;
+    }
+
+    if (!TreeHasReturn(stmt))
+    {
+        list->right = GuardReturns(state, list->right);
+        return list;
+    }
+
+    stmt->right = GuardReturns(state, stmt->right);
+
+    if (TreeIsOp(stmt, TreeOperationId::WHILE))
+    {
+        TreeNode* cond = stmt->left;
+        if (!IsBoolExpr(cond))
+            cond = CREATE_NOT_EQ_NODE(state->tree, cond, CREATE_NUM(state->tree, 0));
+
+        stmt->left = CREATE_AND_NODE(state->tree, CreateNotDone(state), cond);
+    }
+
+    TreeNode* rest = GuardReturns(state, list->right);
+    list->right = rest ? CREATE_LINE_END_NODE(state->tree,
+                                              CREATE_IF_NODE(state->tree, CreateNotDone(state),
+                                                             rest),
+                                              nullptr)
+                       : nullptr;
+
+    return list;
+}
+
+static TreeNode* CreateNotDone(InlineState* state)
+{
+    assert(state);
+
+    return CREATE_EQ_NODE(state->tree, CopyTree(state, state->doneVar, false),
+                          CREATE_NUM(state->tree, 0));
+}
+
+//---------------------------------------------------------------------------------------
+
+static InlineFunc* GetCallee(InlineState* state, const TreeNode* call)
+{
+    assert(state);
+    assert(call);
+    assert(IS_NAME(call->left));
+
+    InternId name = TreeGetNameId(state->tree, call->left);
+
+    if (state->caller && state->caller->name == name)
+        return nullptr;
+
+    InlineFunc* callee = InlineFuncFind(state, name);
+
+    if (callee == nullptr)
+        return nullptr;
+
+    if (callee->state == InlineFuncState::NOT_VISITED)
+        InlineInFunc(state, callee);
+
+    if (callee->body == nullptr || TreeCountNodes(callee->body) > InlineMaxNodes ||
+        CountListSize(call->left->left) != callee->paramsCount)
+        return nullptr;
+
+    return callee;
+}
+
+static bool CanInlineExpr(InlineState* state, const TreeNode* call,
+                          const InlineFunc* callee)
+{
+    assert(state);
+    assert(call);
+    assert(callee);
+
+    const TreeNode* body = callee->body;
+
+    if (body->right != nullptr || !TreeIsOp(body->left, TreeOperationId::RETURN) ||
+        TreeHasCalls(body->left->left))
+        return false;
+
+    size_t paramsCount = 0;
+    size_t argsCount   = 0;
+    TreeNode** params = ListToArray(callee->params,   &paramsCount);
+    TreeNode** args   = ListToArray(call->left->left, &argsCount);
+
+    bool canInline = true;
+    for (size_t i = 0; i < paramsCount && canInline; ++i)
+    {
+        if (TreeHasCalls(args[i]))
+            canInline = false;
+        else if (!IS_NUM(args[i]) && !IS_NAME(args[i]))
+            canInline = CountNameUses(state, body,
+                                      TreeGetNameId(state->tree, params[i]->right)) <= 1;
+    }
+
+    free(params);
+    free(args);
+
+    return canInline;
+}
+
+static bool CanInlineStatement(const InlineFunc* callee)
+{
+    assert(callee);
+
+    if (!TreeIsOp(callee->body, TreeOperationId::LINE_END))
+        return false;
+
+    return IsLastReturnOnly(callee->body) || CanGuardReturns(callee->body);
+}
+
+static bool IsLastReturnOnly(const TreeNode* body)
+{
+    assert(body);
+
+    for (; body->right; body = body->right)
+    {
+        if (TreeHasReturn(body->left))
+            return false;
+    }
+
+    return TreeIsOp(body->left, TreeOperationId::RETURN);
+}
+
+/// @brief loop conditions are checked once more after RETURN in the loop body,
+///        so they must not have side effects
+static bool CanGuardReturns(const TreeNode* node)
+{
+    if (node == nullptr)
+        return true;
+
+    if (TreeIsOp(node, TreeOperationId::WHILE) && TreeHasReturn(node->right) &&
+        TreeHasCalls(node->left))
+        return false;
+
+    return CanGuardReturns(node->left) && CanGuardReturns(node->right);
+}
+
+//---------------------------------------------------------------------------------------
+
+static void RenamesPush(InlineState* state, InternId from, TreeNode* to)
+{
+    assert(state);
+    assert(to);
+
+    if (state->renamesCount == state->renamesCapacity)
+    {
+        state->renamesCapacity = 2 * state->renamesCapacity + 8;
+        state->renames = (InlineRename*)realloc(state->renames,
+                                                state->renamesCapacity * sizeof(*state->renames));
+        assert(state->renames);
+    }
+
+    state->renames[state->renamesCount++] = { from, to };
+}
+
+static void RenameLocals(InlineState* state, const TreeNode* node)
+{
+    assert(state);
+
+    if (node == nullptr)
+        return;
+
+    if (TreeIsOp(node, TreeOperationId::TYPE) &&
+        TreeIsOp(node->right, TreeOperationId::ASSIGN))
+    {
+        const TreeNode* nameNode = node->right->left;
+        RenamesPush(state, TreeGetNameId(state->tree, nameNode),
+                    CreateVar(state, nameNode));
+    }
+
+    RenameLocals(state, node->left);
+    RenameLocals(state, node->right);
+}
+
+static TreeNode* CopyTree(InlineState* state, const TreeNode* node, bool rename)
+{
+    assert(state);
+
+    if (node == nullptr)
+        return nullptr;
+
+    if (rename && IS_NAME(node))
+    {
+        InternId name = TreeGetNameId(state->tree, node);
+
+        for (size_t i = 0; i < state->renamesCount; ++i)
+        {
+            if (state->renames[i].from == name)
+                return CopyTree(state, state->renames[i].to, false);
+        }
+    }
+
+    if (TreeIsOp(node, TreeOperationId::FUNC_CALL))
+    {
+        TreeNode* funcName = TreeNodeCreate(state->tree, node->left->value,
+                                            node->left->valueType,
+                                            CopyTree(state, node->left->left, rename));
+
+        return TreeNodeCreate(state->tree, node->value, node->valueType, funcName);
+    }
+
+    return TreeNodeCreate(state->tree, node->value, node->valueType,
+                          CopyTree(state, node->left,  rename),
+                          CopyTree(state, node->right, rename));
+}
+
+/// @brief fresh variable "name.N", unnamed temporaries are "inline.N"
+static TreeNode* CreateVar(InlineState* state, const TreeNode* nameNode)
+{
+    assert(state);
+
+    const char* baseName = nameNode ?
+                           NameTableGetName(state->tree->allNamesTable, nameNode->value.nameId) :
+                           "inline";
+
+    return TreeCreateTempVar(state->tree, baseName, &state->namesCount);
+}
+
+static TreeNode* CreateDecl(InlineState* state, TreeNode* var, TreeNode* value)
+{
+    assert(state);
+    assert(var);
+    assert(value);
+
+    return CREATE_TYPE_NODE(state->tree, CREATE_TYPE_INT_NODE(state->tree, nullptr),
+                            CREATE_ASSIGN_NODE(state->tree, var, value));
+}
+
+//---------------------------------------------------------------------------------------
+
+static void InlineFuncCollect(InlineState* state, TreeNode* node)
+{
+    assert(state);
+
+    if (node == nullptr || !IS_OP(node))
+        return;
+
+    if (node->value.operation == TreeOperationId::FUNC)
+    {
+        InlineFuncPush(state, node);
+        return;
+    }
+
+    InlineFuncCollect(state, node->left);
+    InlineFuncCollect(state, node->right);
+}
+
+static void InlineFuncPush(InlineState* state, TreeNode* funcNode)
+{
+    assert(state);
+    assert(funcNode);
+    assert(funcNode->left && IS_NAME(funcNode->left));
+
+    if (state->funcsCount == state->funcsCapacity)
+    {
+        state->funcsCapacity = 2 * state->funcsCapacity + 8;
+        state->funcs = (InlineFunc*)realloc(state->funcs,
+                                            state->funcsCapacity * sizeof(*state->funcs));
+        assert(state->funcs);
+    }
+
+    TreeNode* funcName = funcNode->left;
+
+    state->funcs[state->funcsCount++] = { TreeGetNameId(state->tree, funcName),
+                                          funcName->left, funcName->right,
+                                          CountListSize(funcName->left),
+                                          InlineFuncState::NOT_VISITED };
+}
+
+static InlineFunc* InlineFuncFind(InlineState* state, InternId name)
+{
+    assert(state);
+
+    for (size_t i = 0; i < state->funcsCount; ++i)
+    {
+        if (state->funcs[i].name == name)
+            return state->funcs + i;
+    }
+
+    return nullptr;
+}
+
+//---------------------------------------------------------------------------------------
+
+static InlineState InlineStateCtor(Tree* tree)
+{
+    assert(tree);
+
+    InlineState state = {};
+    state.tree = tree;
+
+    return state;
+}
+
+static void InlineStateDtor(InlineState* state)
+{
+    assert(state);
+
+    free(state->funcs);
+    free(state->renames);
+
+    *state = {};
+}
+
+//---------------------------------------------------------------------------------------
+
+/// @brief COMMA list of params or args to array in source order
+static TreeNode** ListToArray(TreeNode* list, size_t* outCount)
+{
+    assert(outCount);
+
+    size_t count = CountListSize(list);
+    TreeNode** array = (TreeNode**)calloc(count + 1, sizeof(*array));
+    assert(array);
+
+    *outCount = 0;
+    ListToArray(list, array, outCount);
+
+    assert(*outCount == count);
+    return array;
+}
+
+static void ListToArray(TreeNode* list, TreeNode** array, size_t* pos)
+{
+    assert(array);
+    assert(pos);
+
+    if (list == nullptr)
+        return;
+
+    if (!TreeIsOp(list, TreeOperationId::COMMA))
+    {
+        array[(*pos)++] = list;
+        return;
+    }
+
+    ListToArray(list->left,  array, pos);
+    ListToArray(list->right, array, pos);
+}
+
+static size_t CountListSize(const TreeNode* list)
+{
+    if (list == nullptr)
+        return 0;
+
+    if (!TreeIsOp(list, TreeOperationId::COMMA))
+        return 1;
+
+    return CountListSize(list->left) + CountListSize(list->right);
+}
+
+static size_t CountNameUses(InlineState* state, const TreeNode* node, InternId name)
+{
+    assert(state);
+
+    if (node == nullptr)
+        return 0;
+
+    if (IS_NAME(node) && TreeGetNameId(state->tree, node) == name)
+        return 1;
+
+    return CountNameUses(state, node->left, name) + CountNameUses(state, node->right, name);
+}
+
+static bool IsBoolExpr(const TreeNode* node)
+{
+    assert(node);
+
+    if (!IS_OP(node))
+        return false;
+
+    switch (node->value.operation)
+    {
+        case TreeOperationId::LESS:
+        case TreeOperationId::GREATER:
+        case TreeOperationId::LESS_EQ:
+        case TreeOperationId::GREATER_EQ:
+        case TreeOperationId::EQ:
+        case TreeOperationId::NOT_EQ:
+            return true;
+
+        case TreeOperationId::AND:
+        case TreeOperationId::OR:
+            return IsBoolExpr(node->left) && IsBoolExpr(node->right);
+
+        default:
+            return false;
+    }
+}
@@ -0,0 +1,441 @@
+#include <assert.h>
+#include <stdlib.h>
+
+#include "MiddleEnd.h"
+#include "TreeUtils.h"
+#include "Tree/DSL.h"
+
+// Calls of pure functions with constant arguments are run by the AST interpreter at
+// compile time and replaced with the result. Values are ints, every operation goes through
+// TreeCalculateOperation, so the result is the same as the program computes in doubles -
+// otherwise the call is left as is. Interpretation gives up after EvalMaxSteps statements
+// and expressions or EvalMaxDepth nested calls, on reading a variable without value and
+// on a function ending without RETURN. Calls inside the functions are replaced first,
+// so arguments folded to constants make outer calls constant too.
+
+static const size_t EvalMaxSteps = 1 << 20;
+static const size_t EvalMaxDepth = 128;
+
+enum class EvalStatus
+{
+    NEXT,
+    RETURNED,
+    FAILED,
+};
+
+struct EvalVar
+{
+    InternId name;
+    int      value;
+};
+
+struct EvalFrame
+{
+    EvalVar* vars;
+    size_t   varsCount;
+    size_t   varsCapacity;
+};
+
+struct EvalState
+{
+    Tree* tree;
+
+    FuncsPurity purity;
+
+    size_t steps;
+    size_t depth;
+};
+
+static size_t EvalInTree(EvalState* state, TreeNode** node, bool isStmt);
+
+static bool       EvalCall(EvalState* state, const TreeNode* call, const EvalFrame* frame,
+                           int* result);
+static bool       EvalFunc(EvalState* state, const FuncPurity* func, const int* args,
+                           size_t argsCount, int* result);
+static EvalStatus EvalList(EvalState* state, EvalFrame* frame, const TreeNode* list,
+                           int* result);
+static EvalStatus EvalStmt(EvalState* state, EvalFrame* frame, const TreeNode* stmt,
+                           int* result);
+static bool       EvalExpr(EvalState* state, const EvalFrame* frame, const TreeNode* node,
+                           int* value);
+
+static bool EvalArgs  (EvalState* state, const EvalFrame* frame, const TreeNode* node,
+                       int* args, size_t argsCapacity, size_t* argsCount);
+static bool BindParams(EvalState* state, EvalFrame* frame, const TreeNode* node,
+                       const int* args, size_t argsCount, size_t* pos);
+
+static bool EvalStep  (EvalState* state);
+
+static void           EvalFrameSet(EvalFrame* frame, InternId name, int value);
+static const EvalVar* EvalFrameGet(const EvalFrame* frame, InternId name);
+
+static size_t CountArgs     (const TreeNode* node);
+static bool   HasConstArgs  (const TreeNode* node);
+
+
+//---------------------------------------------------------------------------------------
+
+size_t TreeEvaluatePureCalls(Tree* tree)
+{
+    assert(tree);
+
+    EvalState state = {};
+    state.tree   = tree;
+    state.purity = FuncsPurityCtor(tree);
+
+    size_t replacedCalls = EvalInTree(&state, &tree->root, false);
+
+    FuncsPurityDtor(&state.purity);
+
+    return replacedCalls;
+}
+
+/// @return number of replaced calls
+static size_t EvalInTree(EvalState* state, TreeNode** node, bool isStmt)
+{
+    assert(state);
+    assert(node);
+
+    if (*node == nullptr)
+        return 0;
+
+    bool isLineEnd = TreeIsOp(*node, TreeOperationId::LINE_END);
+
+    size_t replacedCalls = EvalInTree(state, &(*node)->left,  isLineEnd) +
+                           EvalInTree(state, &(*node)->right, false);
+
+    // call as a statement is kept, its value is not used
+    if (isStmt || !TreeIsOp(*node, TreeOperationId::FUNC_CALL))
+        return replacedCalls;
+
+    TreeNode* call = *node;
+    assert(call->left && IS_NAME(call->left));
+
+    if (!HasConstArgs(call->left->left) ||
+        !FuncsPurityIsPureFunc(&state->purity, TreeGetNameId(state->tree, call->left)))
+        return replacedCalls;
+
+    EvalFrame frame = {};
+    int result      = 0;
+
+    state->steps = 0;
+    state->depth = 0;
+
+    if (!EvalCall(state, call, &frame, &result))
+        return replacedCalls;
+
+    TreeNodeDeepDtor(call);
+    *node = CREATE_NUM(state->tree, result);
+
+    return replacedCalls + 1;
+}
+
+//---------------------------------------------------------------------------------------
+
+static bool EvalCall(EvalState* state, const TreeNode* call, const EvalFrame* frame,
+                     int* result)
+{
+    assert(state);
+    assert(call);
+    assert(frame);
+    assert(result);
+    assert(call->left && IS_NAME(call->left));
+
+    const FuncPurity* func = FuncsPurityFind(&state->purity,
+                                             TreeGetNameId(state->tree, call->left));
+
+    if (func == nullptr || !func->isPure)
+        return false;
+
+    size_t argsCount = CountArgs(call->left->left);
+    int*   args      = (int*)calloc(argsCount + 1, sizeof(*args));
+    assert(args);
+
+    size_t pos = 0;
+    bool calculated = EvalArgs(state, frame, call->left->left, args, argsCount, &pos) &&
+                      EvalFunc(state, func, args, argsCount, result);
+
+    free(args);
+
+    return calculated;
+}
+
+static bool EvalFunc(EvalState* state, const FuncPurity* func, const int* args,
+                     size_t argsCount, int* result)
+{
+    assert(state);
+    assert(func);
+    assert(args);
+    assert(result);
+
+    if (state->depth >= EvalMaxDepth)
+        return false;
+
+    EvalFrame frame = {};
+
+    size_t pos = 0;
+    bool bound = BindParams(state, &frame, func->params, args, argsCount, &pos) &&
+                 pos == argsCount;
+
+    EvalStatus status = EvalStatus::FAILED;
+    if (bound)
+    {
+        state->depth++;
+        status = EvalList(state, &frame, func->body, result);
+        state->depth--;
+    }
+
+    free(frame.vars);
+
+    return status == EvalStatus::RETURNED;
+}
+
+static EvalStatus EvalList(EvalState* state, EvalFrame* frame, const TreeNode* list,
+                           int* result)
+{
+    assert(state);
+    assert(frame);
+    assert(result);
+
+    for (; list; list = list->right)
+    {
+        assert(TreeIsOp(list, TreeOperationId::LINE_END));
+
+        EvalStatus status = EvalStmt(state, frame, list->left, result);
+
+        if (status != EvalStatus::NEXT)
+            return status;
+    }
+
+    return EvalStatus::NEXT;
+}
+
+static EvalStatus EvalStmt(EvalState* state, EvalFrame* frame, const TreeNode* stmt,
+                           int* result)
+{
+    assert(state);
+    assert(frame);
+    assert(result);
+
+    if (!EvalStep(state) || stmt == nullptr || !IS_OP(stmt))
+        return EvalStatus::FAILED;
+
+    switch (stmt->value.operation)
+    {
+        case TreeOperationId::TYPE:
+            return EvalStmt(state, frame, stmt->right, result);
+
+        case TreeOperationId::ASSIGN:
+        {
+            assert(stmt->left && IS_NAME(stmt->left));
+
+            int value = 0;
+            if (!EvalExpr(state, frame, stmt->right, &value))
+                return EvalStatus::FAILED;
+
+            EvalFrameSet(frame, TreeGetNameId(state->tree, stmt->left), value);
+            return EvalStatus::NEXT;
+        }
+
+        case TreeOperationId::IF:
+        {
+            int cond = 0;
+            if (!EvalExpr(state, frame, stmt->left, &cond))
+                return EvalStatus::FAILED;
+
+            return cond != 0 ? EvalList(state, frame, stmt->right, result) : EvalStatus::NEXT;
+        }
+
+        case TreeOperationId::WHILE:
+        {
+            while (true)
+            {
+                int cond = 0;
+                if (!EvalStep(state) || !EvalExpr(state, frame, stmt->left, &cond))
+                    return EvalStatus::FAILED;
+
+                if (cond == 0)
+                    return EvalStatus::NEXT;
+
+                EvalStatus status = EvalList(state, frame, stmt->right, result);
+                if (status != EvalStatus::NEXT)
+                    return status;
+            }
+        }
+
+        case TreeOperationId::RETURN:
+            return EvalExpr(state, frame, stmt->left, result) ? EvalStatus::RETURNED :
+                                                                EvalStatus::FAILED;
+
+        case TreeOperationId::FUNC_CALL:
+        {
+            int value = 0;
+            return EvalCall(state, stmt, frame, &value) ? EvalStatus::NEXT :
+                                                          EvalStatus::FAILED;
+        }
+
+        default:
+            return EvalStatus::FAILED;
+    }
+}
+
+static bool EvalExpr(EvalState* state, const EvalFrame* frame, const TreeNode* node,
+                     int* value)
+{
+    assert(state);
+    assert(frame);
+    assert(value);
+
+    if (node == nullptr || !EvalStep(state))
+        return false;
+
+    if (IS_NUM(node))
+    {
+        *value = node->value.num;
+        return true;
+    }
+
+    if (IS_NAME(node))
+    {
+        const EvalVar* var = EvalFrameGet(frame, TreeGetNameId(state->tree, node));
+        if (var == nullptr)
+            return false;
+
+        *value = var->value;
+        return true;
+    }
+
+    if (!IS_OP(node))
+        return false;
+
+    if (node->value.operation == TreeOperationId::FUNC_CALL)
+        return EvalCall(state, node, frame, value);
+
+    int val1 = 0;
+    int val2 = 0;
+
+    if (!EvalExpr(state, frame, node->left, &val1))
+        return false;
+
+    if (node->right && !EvalExpr(state, frame, node->right, &val2))
+        return false;
+
+    return TreeCalculateOperation(node->value.operation, val1, val2, value);
+}
+
+//---------------------------------------------------------------------------------------
+
+/// @brief args are left nested COMMA list
+static bool EvalArgs(EvalState* state, const EvalFrame* frame, const TreeNode* node,
+                     int* args, size_t argsCapacity, size_t* argsCount)
+{
+    assert(state);
+    assert(frame);
+    assert(args);
+    assert(argsCount);
+
+    if (node == nullptr)
+        return true;
+
+    if (TreeIsOp(node, TreeOperationId::COMMA))
+        return EvalArgs(state, frame, node->left,  args, argsCapacity, argsCount) &&
+               EvalArgs(state, frame, node->right, args, argsCapacity, argsCount);
+
+    assert(*argsCount < argsCapacity);
+
+    return EvalExpr(state, frame, node, args + (*argsCount)++);
+}
+
+/// @brief params are left nested COMMA list of TYPE(TYPE_INT, name)
+static bool BindParams(EvalState* state, EvalFrame* frame, const TreeNode* node,
+                       const int* args, size_t argsCount, size_t* pos)
+{
+    assert(state);
+    assert(frame);
+    assert(args);
+    assert(pos);
+
+    if (node == nullptr)
+        return true;
+
+    if (TreeIsOp(node, TreeOperationId::COMMA))
+        return BindParams(state, frame, node->left,  args, argsCount, pos) &&
+               BindParams(state, frame, node->right, args, argsCount, pos);
+
+    if (!TreeIsOp(node, TreeOperationId::TYPE) || node->right == nullptr ||
+        !IS_NAME(node->right) || *pos >= argsCount)
+        return false;
+
+    EvalFrameSet(frame, TreeGetNameId(state->tree, node->right), args[(*pos)++]);
+
+    return true;
+}
+
+static bool EvalStep(EvalState* state)
+{
+    assert(state);
+
+    return ++state->steps <= EvalMaxSteps;
+}
+
+//---------------------------------------------------------------------------------------
+
+static void EvalFrameSet(EvalFrame* frame, InternId name, int value)
+{
+    assert(frame);
+
+    for (size_t i = 0; i < frame->varsCount; ++i)
+    {
+        if (frame->vars[i].name == name)
+        {
+            frame->vars[i].value = value;
+            return;
+        }
+    }
+
+    if (frame->varsCount == frame->varsCapacity)
+    {
+        frame->varsCapacity = 2 * frame->varsCapacity + 8;
+        frame->vars = (EvalVar*)realloc(frame->vars, frame->varsCapacity * sizeof(*frame->vars));
+        assert(frame->vars);
+    }
+
+    frame->vars[frame->varsCount++] = { name, value };
+}
+
+static const EvalVar* EvalFrameGet(const EvalFrame* frame, InternId name)
+{
+    assert(frame);
+
+    for (size_t i = 0; i < frame->varsCount; ++i)
+    {
+        if (frame->vars[i].name == name)
+            return frame->vars + i;
+    }
+
+    return nullptr;
+}
+
+//---------------------------------------------------------------------------------------
+
+static size_t CountArgs(const TreeNode* node)
+{
+    if (node == nullptr)
+        return 0;
+
+    if (TreeIsOp(node, TreeOperationId::COMMA))
+        return CountArgs(node->left) + CountArgs(node->right);
+
+    return 1;
+}
+
+static bool HasConstArgs(const TreeNode* node)
+{
+    if (node == nullptr)
+        return true;
+
+    if (TreeIsOp(node, TreeOperationId::COMMA))
+        return HasConstArgs(node->left) && HasConstArgs(node->right);
+
+    return IS_NUM(node);
+}
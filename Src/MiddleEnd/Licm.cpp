@@ -0,0 +1,367 @@
+#include <assert.h>
+#include <stdlib.h>
+
+#include "MiddleEnd.h"
+#include "TreeUtils.h"
+#include "Tree/DSL.h"
+
+// Expression is invariant in WHILE if none of its variables is assigned in the loop and
+// it calls only pure functions. Largest invariant subexpressions are moved to fresh
+// "licm.N" variables computed before the loop:
+//     IF (cond) { licm.0 = ...; WHILE (cond) { ... licm.0 ... } }
+// Condition is checked twice on entry, so the loop must have a pure condition, and
+// nothing is computed if the loop runs zero times. Calls may not end, so they are moved
+// only from the condition and from the loop body statements before the first RETURN,
+// which run on the first iteration anyway. Expressions without calls are moved from
+// anywhere in the loop. Inner loops are processed first.
+
+struct LicmHoisted
+{
+    TreeNode* var;
+    TreeNode* value;
+};
+
+struct LicmState
+{
+    Tree* tree;
+
+    FuncsPurity purity;
+
+    const TreeNode* loop;
+
+    LicmHoisted* hoisted;
+    size_t       hoistedCount;
+    size_t       hoistedCapacity;
+
+    size_t namesCount;  ///< suffix for fresh names
+};
+
+static LicmState LicmStateCtor(Tree* tree);
+static void      LicmStateDtor(LicmState* state);
+
+static void LicmInFuncs(LicmState* state, TreeNode* node);
+static void LicmInList (LicmState* state, TreeNode* list);
+static void LicmLoop   (LicmState* state, TreeNode* link);
+
+static void HoistInList(LicmState* state, TreeNode*  list, bool callsAllowed);
+static void HoistInStmt(LicmState* state, TreeNode** stmt, bool callsAllowed);
+static void HoistInExpr(LicmState* state, TreeNode** node, bool callsAllowed);
+
+static TreeNode* HoistExpr  (LicmState* state, TreeNode* expr);
+static bool      IsInvariant(LicmState* state, const TreeNode* node, bool callsAllowed);
+
+static bool      IsEqual   (LicmState* state, const TreeNode* first, const TreeNode* second);
+
+
+//---------------------------------------------------------------------------------------
+
+void TreeHoistLoopInvariants(Tree* tree)
+{
+    assert(tree);
+
+    LicmState state = LicmStateCtor(tree);
+
+    LicmInFuncs(&state, tree->root);
+
+    LicmStateDtor(&state);
+}
+
+static void LicmInFuncs(LicmState* state, TreeNode* node)
+{
+    assert(state);
+
+    if (node == nullptr || !IS_OP(node))
+        return;
+
+    if (node->value.operation != TreeOperationId::FUNC)
+    {
+        LicmInFuncs(state, node->left);
+        LicmInFuncs(state, node->right);
+        return;
+    }
+
+    assert(node->left && IS_NAME(node->left));
+
+    LicmInList(state, node->left->right);
+}
+
+static void LicmInList(LicmState* state, TreeNode* list)
+{
+    assert(state);
+
+    for (; list; list = list->right)
+    {
+        assert(TreeIsOp(list, TreeOperationId::LINE_END));
+
+        TreeNode* stmt = list->left;
+
+        if (TreeIsOp(stmt, TreeOperationId::IF))
+            LicmInList(state, stmt->right);
+
+        if (TreeIsOp(stmt, TreeOperationId::WHILE))
+        {
+            LicmInList(state, stmt->right);
+            LicmLoop(state, list);
+        }
+    }
+}
+
+/// @brief link - LINE_END with the WHILE, WHILE is replaced with IF if something is moved
+static void LicmLoop(LicmState* state, TreeNode* link)
+{
+    assert(state);
+    assert(link);
+
+    TreeNode* loop = link->left;
+    assert(TreeIsOp(loop, TreeOperationId::WHILE));
+
+    if (!FuncsPurityIsPure(&state->purity, loop->left))
+        return;
+
+    state->loop         = loop;
+    state->hoistedCount = 0;
+
+    TreeNode* guardCond = TreeCopySubtree(state->tree, loop->left);
+
+    HoistInExpr(state, &loop->left, true);
+
+    bool callsAllowed = true;
+    for (TreeNode* body = loop->right; body; body = body->right)
+    {
+        HoistInStmt(state, &body->left, callsAllowed);
+
+        if (TreeHasReturn(body->left))
+            callsAllowed = false;
+    }
+
+    state->loop = nullptr;
+
+    if (state->hoistedCount == 0)
+    {
+        TreeNodeDeepDtor(guardCond);
+        return;
+    }
+
+    TreeNode* preheader = CREATE_LINE_END_NODE(state->tree, loop, nullptr);
+    for (size_t i = state->hoistedCount; i > 0; --i)
+    {
+        const LicmHoisted* hoisted = state->hoisted + i - 1;
+
+        TreeNode* assign = CREATE_ASSIGN_NODE(state->tree, hoisted->var, hoisted->value);
+        TreeNode* decl   = CREATE_TYPE_NODE(state->tree, CREATE_TYPE_INT_NODE(state->tree, nullptr),
+                                            assign);
+
+        preheader = CREATE_LINE_END_NODE(state->tree, decl, preheader);
+    }
+
+    link->left = CREATE_IF_NODE(state->tree, guardCond, preheader);
+}
+
+//---------------------------------------------------------------------------------------
+
+static void HoistInList(LicmState* state, TreeNode* list, bool callsAllowed)
+{
+    assert(state);
+
+    for (; list; list = list->right)
+        HoistInStmt(state, &list->left, callsAllowed);
+}
+
+static void HoistInStmt(LicmState* state, TreeNode** stmt, bool callsAllowed)
+{
+    assert(state);
+    assert(stmt);
+
+    TreeNode* node = *stmt;
+
+    if (node == nullptr || !IS_OP(node))
+        return;
+
+    switch (node->value.operation)
+    {
+        case TreeOperationId::TYPE:
+            HoistInStmt(state, &node->right, callsAllowed);
+            break;
+
+        case TreeOperationId::ASSIGN:
+            HoistInExpr(state, &node->right, callsAllowed);
+            break;
+
+        case TreeOperationId::IF:
+            HoistInExpr(state, &node->left, callsAllowed);
+            HoistInList(state, node->right, false);
+            break;
+
+        case TreeOperationId::WHILE:
+            HoistInExpr(state, &node->left, false);
+            HoistInList(state, node->right, false);
+            break;
+
+        case TreeOperationId::FUNC_CALL:
+            assert(node->left && IS_NAME(node->left));
+            HoistInExpr(state, &node->left->left, callsAllowed);
+            break;
+
+        default:
+            HoistInExpr(state, &node->left,  callsAllowed);
+            HoistInExpr(state, &node->right, callsAllowed);
+            break;
+    }
+}
+
+static void HoistInExpr(LicmState* state, TreeNode** node, bool callsAllowed)
+{
+    assert(state);
+    assert(node);
+
+    if (*node == nullptr || !IS_OP((*node)))
+        return;
+
+    TreeOperationId operation = (*node)->value.operation;
+
+    if ((TreeOpIsPure(operation) || operation == TreeOperationId::FUNC_CALL) &&
+        IsInvariant(state, *node, callsAllowed))
+    {
+        *node = HoistExpr(state, *node);
+        return;
+    }
+
+    if (operation == TreeOperationId::FUNC_CALL)
+    {
+        assert((*node)->left && IS_NAME((*node)->left));
+        HoistInExpr(state, &(*node)->left->left, callsAllowed);
+        return;
+    }
+
+    HoistInExpr(state, &(*node)->left,  callsAllowed);
+    HoistInExpr(state, &(*node)->right, callsAllowed);
+}
+
+/// @return variable to use instead of the expr, equal expressions share one variable
+static TreeNode* HoistExpr(LicmState* state, TreeNode* expr)
+{
+    assert(state);
+    assert(expr);
+
+    for (size_t i = 0; i < state->hoistedCount; ++i)
+    {
+        if (IsEqual(state, state->hoisted[i].value, expr))
+        {
+            TreeNodeDeepDtor(expr);
+            return CREATE_VAR(state->tree, state->hoisted[i].var->value.nameId);
+        }
+    }
+
+    if (state->hoistedCount == state->hoistedCapacity)
+    {
+        state->hoistedCapacity = 2 * state->hoistedCapacity + 8;
+        state->hoisted = (LicmHoisted*)realloc(state->hoisted,
+                                               state->hoistedCapacity * sizeof(*state->hoisted));
+        assert(state->hoisted);
+    }
+
+    TreeNode* var = TreeCreateTempVar(state->tree, "licm", &state->namesCount);
+    state->hoisted[state->hoistedCount++] = { var, expr };
+
+    return CREATE_VAR(state->tree, var->value.nameId);
+}
+
+//---------------------------------------------------------------------------------------
+
+static bool IsInvariant(LicmState* state, const TreeNode* node, bool callsAllowed)
+{
+    assert(state);
+    assert(state->loop);
+
+    if (node == nullptr || IS_NUM(node))
+        return true;
+
+    if (IS_NAME(node))
+        return !TreeIsAssigned(state->tree, state->loop->right,
+                               TreeGetNameId(state->tree, node));
+
+    if (!IS_OP(node))
+        return false;
+
+    switch (node->value.operation)
+    {
+        case TreeOperationId::FUNC_CALL:
+            assert(node->left && IS_NAME(node->left));
+
+            return callsAllowed &&
+                   FuncsPurityIsPureFunc(&state->purity,
+                                         TreeGetNameId(state->tree, node->left)) &&
+                   IsInvariant(state, node->left->left, callsAllowed);
+
+        case TreeOperationId::COMMA:
+            break;
+
+        default:
+            if (!TreeOpIsPure(node->value.operation))
+                return false;
+            break;
+    }
+
+    return IsInvariant(state, node->left,  callsAllowed) &&
+           IsInvariant(state, node->right, callsAllowed);
+}
+
+//---------------------------------------------------------------------------------------
+
+static LicmState LicmStateCtor(Tree* tree)
+{
+    assert(tree);
+
+    LicmState state = {};
+    state.tree   = tree;
+    state.purity = FuncsPurityCtor(tree);
+
+    return state;
+}
+
+static void LicmStateDtor(LicmState* state)
+{
+    assert(state);
+
+    FuncsPurityDtor(&state->purity);
+    free(state->hoisted);
+
+    *state = {};
+}
+
+//---------------------------------------------------------------------------------------
+
+static bool IsEqual(LicmState* state, const TreeNode* first, const TreeNode* second)
+{
+    assert(state);
+
+    if (first == nullptr || second == nullptr)
+        return first == second;
+
+    if (first->valueType != second->valueType)
+        return false;
+
+    switch (first->valueType)
+    {
+        case TreeNodeValueType::NUM:
+            if (first->value.num != second->value.num)
+                return false;
+            break;
+
+        case TreeNodeValueType::NAME:
+            if (TreeGetNameId(state->tree, first) != TreeGetNameId(state->tree, second))
+                return false;
+            break;
+
+        case TreeNodeValueType::OPERATION:
+            if (first->value.operation != second->value.operation)
+                return false;
+            break;
+
+        default:
+            return false;
+    }
+
+    return IsEqual(state, first->left,  second->left) &&
+           IsEqual(state, first->right, second->right);
+}
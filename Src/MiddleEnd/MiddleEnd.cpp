@@ -1,10 +1,13 @@
 #include <assert.h>
+#include <limits.h>
 #include <math.h>
+#include <stdlib.h>
 
 #include "Tree/Tree.h"
 #include "Common/DoubleFuncs.h"
 #include "Tree/DSL.h"
 #include "Common/Log.h"
+#include "MiddleEnd.h"
 
 //---------------Calculation-------------------
 
@@ -15,21 +18,78 @@ static int CalculateUsingOperation(const TreeOperationId operation,
 
 //--------------------------------Simplify-------------------------------------------
 
-static TreeNode* TreeSimplifyConstants          (TreeNode* node, int* simplifiesCount);
-static TreeNode* TreeSimplifyNeutralNodes       (TreeNode* node, int* simplifiesCount);
-static inline TreeNode* TreeSimplifyAdd         (TreeNode* node, int* simplifiesCount);
-static inline TreeNode* TreeSimplifySub         (TreeNode* node, int* simplifiesCount);
-static inline TreeNode* TreeSimplifyMul         (TreeNode* node, int* simplifiesCount);
-static inline TreeNode* TreeSimplifyDiv         (TreeNode* node, int* simplifiesCount);
-static inline TreeNode* TreeSimplifyPow         (TreeNode* node, int* simplifiesCount);
+struct TreeSimplifyStackElem
+{
+    TreeNode** node;        ///< place of the node in its parent
+    bool       childrenDone;
+    bool       underName;   ///< in function params / body or call args
+};
+
+static void      TreeSimplify                   (TreeNode** root, bool underName);
+static TreeNode* TreeSimplifyNode               (TreeNode* node, bool underName);
+static TreeNode* TreeSimplifyNeutralNodes       (TreeNode* node);
+static inline TreeNode* TreeSimplifyAdd         (TreeNode* node);
+static inline TreeNode* TreeSimplifySub         (TreeNode* node);
+static inline TreeNode* TreeSimplifyMul         (TreeNode* node);
+static inline TreeNode* TreeSimplifyDiv         (TreeNode* node);
+static inline TreeNode* TreeSimplifyPow         (TreeNode* node);
 
 static inline TreeNode* TreeSimplifyReturnLeftNode (TreeNode* node);
 static inline TreeNode* TreeSimplifyReturnRightNode(TreeNode* node);
 static inline TreeNode* TreeSimplifyReturnNumNode(TreeNode* node, int val);
 
+//--------------------------------Propagation----------------------------------------
+
+enum class VarFactType
+{
+    CONST,
+    COPY,
+};
+
+/// @brief what is known about variable at the current point of the function
+struct VarFact
+{
+    InternId    var;
+    VarFactType type;
+
+    int         value;      ///< CONST value
+    InternId    source;     ///< COPY source variable
+    size_t      sourceId;   ///< COPY source name pos in all names table
+};
+
+struct VarFacts
+{
+    VarFact* data;
+    size_t   size;
+    size_t   capacity;
+};
+
+static void PropagateInFuncs     (TreeNode* node, const NameTableType* allNamesTable);
+static void PropagateStatements  (TreeNode* list, VarFacts* facts,
+                                  const NameTableType* allNamesTable);
+static void PropagateAssign      (TreeNode* assign, VarFacts* facts,
+                                  const NameTableType* allNamesTable);
+static void PropagateExpr        (TreeNode** node, const VarFacts* facts,
+                                  const NameTableType* allNamesTable);
+static void PropagateReplaceNames(TreeNode** node, const VarFacts* facts,
+                                  const NameTableType* allNamesTable);
+static void PropagateKillAssigned(const TreeNode* node, VarFacts* facts,
+                                  const NameTableType* allNamesTable);
+
+static VarFacts       VarFactsCtor ();
+static void           VarFactsDtor (VarFacts* facts);
+static VarFacts       VarFactsCopy (const VarFacts* facts);
+static void           VarFactsMerge(VarFacts* facts, const VarFacts* otherFacts);
+static void           VarFactsKill (VarFacts* facts, InternId var);
+static void           VarFactsPush (VarFacts* facts, VarFact fact);
+static const VarFact* VarFactsFind (const VarFacts* facts, InternId var);
+
 //---------------------------------------------------------------------------------------
 
 static bool TreeNodeCanBeCalculated(const TreeNode* node);
+static bool OperationCanBeCalculated(const TreeOperationId operation);
+static bool CalculationIsExact(const TreeOperationId operation, const int val1, const int val2);
+static inline bool IsIntRange(const long long val);
 
 //---------------------------------------------------------------------------------------
 
@@ -89,66 +149,100 @@ static int CalculateUsingOperation(const TreeOperationId operation,
 
 //---------------------------------------------------------------------------------------
 
+/// @brief Single post-order walk: node is rewritten right after its children, so
+///        constant subtree is already folded to one NUM node when its parent is visited
+///        and the result of a rewrite is final - only parents need to look at it again.
+///        Neutral nodes are not removed under names (that is, in function bodies and
+///        call args) - earlier fixed point iteration never went there and removing
+///        f(x) * 0 would lose side effects of the call.
 void TreeSimplify(Tree* tree)
 {
     assert(tree);
 
-    int simplifiesCount = 0;
+    TreeSimplify(&tree->root, false);
+}
+
+static void TreeSimplify(TreeNode** root, bool underName)
+{
+    assert(root);
+
+    if (*root == nullptr)
+        return;
 
-    do
+    size_t stackCapacity = 64;
+    size_t stackSize     = 0;
+    TreeSimplifyStackElem* stack = (TreeSimplifyStackElem*)calloc(stackCapacity, 
+                                                                  sizeof(*stack));
+    assert(stack);
+
+    stack[stackSize++] = { root, false, underName };
+
+    while (stackSize > 0)
     {
-        simplifiesCount = 0;
-        tree->root = TreeSimplifyConstants   (tree->root, &simplifiesCount);
-        tree->root = TreeSimplifyNeutralNodes(tree->root, &simplifiesCount);
-    
-    } while (simplifiesCount != 0);
+        TreeSimplifyStackElem* top  = stack + stackSize - 1;
+        TreeNode**             node = top->node;
+        underName                   = top->underName;
+
+        if (top->childrenDone)
+        {
+            stackSize--;
+
+            TreeNode* simplified = TreeSimplifyNode(*node, underName);
+            if (simplified != *node)
+            {
+                TreeNodeDtor(*node);
+                *node = simplified;
+            }
+
+            continue;
+        }
+
+        top->childrenDone = true;
+
+        if (stackSize + 2 > stackCapacity)
+        {
+            stackCapacity *= 2;
+            stack = (TreeSimplifyStackElem*)realloc(stack, stackCapacity * sizeof(*stack));
+            assert(stack);
+        }
+
+        underName = underName || IS_NAME((*node));
+
+        if ((*node)->right)
+            stack[stackSize++] = { &(*node)->right, false, underName };
+        if ((*node)->left)
+            stack[stackSize++] = { &(*node)->left,  false, underName };
+    }
+
+    free(stack);
 }
 
-static TreeNode* TreeSimplifyConstants (TreeNode* node, int* simplifiesCount)
+static TreeNode* TreeSimplifyNode(TreeNode* node, bool underName)
 {
-    assert(simplifiesCount);
+    assert(node);
 
-    if (node == nullptr)
+    if (!IS_OP(node))
         return node;
 
-    if (TreeNodeCanBeCalculated(node) && !IS_NUM(node))
-    {
-        TreeNode* numNode = CREATE_NUM(TreeCalculate(node));
-        *simplifiesCount += 1;
-        TreeNodeDtor(node);
-        return numNode;
-    }
+    if (TreeNodeCanBeCalculated(node))
+        return TreeSimplifyReturnNumNode(node, TreeCalculate(node));
 
-    node->left  = TreeSimplifyConstants(L(node), simplifiesCount);
-    node->right = TreeSimplifyConstants(R(node), simplifiesCount);
+    if (underName)
+        return node;
 
-    return node;
+    return TreeSimplifyNeutralNodes(node);
 }
 
-static TreeNode* TreeSimplifyNeutralNodes(TreeNode* node, int* simplifiesCount)
+static TreeNode* TreeSimplifyNeutralNodes(TreeNode* node)
 {
-    if (node == nullptr || !IS_OP(node))
-        return node;
-    
-    TreeNode* left  = TreeSimplifyNeutralNodes(L(node), simplifiesCount);
-    TreeNode* right = TreeSimplifyNeutralNodes(R(node), simplifiesCount);
-    
-    if (L(node) != left)
-    {
-        TreeNodeDtor(L(node));
-        node->left = left;        
-    }
+    assert(node);
+    assert(IS_OP(node));
 
-    if (R(node) != right)
-    {
-        TreeNodeDtor(R(node));
-        node->right = right;
-    }
+    TreeNode* left  = L(node);
+    TreeNode* right = R(node);
 
     if (left == nullptr || right == nullptr)
         return node;
-    
-    assert(IS_OP(node));
 
     if (IS_NAME(right) && IS_NAME(left) && left->value.nameId == right->value.nameId && 
         node->value.operation == TreeOperationId::SUB)
@@ -157,21 +251,19 @@ static TreeNode* TreeSimplifyNeutralNodes(TreeNode* node, int* simplifiesCount)
     if (!IS_NUM(left) && !IS_NUM(right))
         return node;
 
-    assert(L(node) == left);
-    assert(R(node) == right);
     switch (node->value.operation)
     {
         case TreeOperationId::ADD:
-            return TreeSimplifyAdd(node, simplifiesCount);
+            return TreeSimplifyAdd(node);
         case TreeOperationId::SUB:
-            return TreeSimplifySub(node, simplifiesCount);
+            return TreeSimplifySub(node);
         case TreeOperationId::MUL:
-            return TreeSimplifyMul(node, simplifiesCount);
+            return TreeSimplifyMul(node);
         case TreeOperationId::DIV:
-            return TreeSimplifyDiv(node, simplifiesCount);
+            return TreeSimplifyDiv(node);
         
         case TreeOperationId::POW:
-            return TreeSimplifyPow(node, simplifiesCount);
+            return TreeSimplifyPow(node);
 
         default:
             break;
@@ -185,120 +277,106 @@ static TreeNode* TreeSimplifyNeutralNodes(TreeNode* node, int* simplifiesCount)
 #define CHECK()                 \
 do                              \
 {                               \
-    assert(simplifiesCount);    \
     assert(node);              \
     assert(L(node));           \
     assert(R(node));           \
 } while (0)
 
 
-static inline TreeNode* TreeSimplifyAdd(TreeNode* node, int* simplifiesCount)
+static inline TreeNode* TreeSimplifyAdd(TreeNode* node)
 {
     CHECK();
 
     if (R_IS_NUM(node) && DoubleEqual(R_NUM(node), 0))
     {
-        (*simplifiesCount)++;
         return TreeSimplifyReturnLeftNode(node);
     }
 
     if (L_IS_NUM(node) && DoubleEqual(L_NUM(node), 0))
     {
-        (*simplifiesCount)++;
         return TreeSimplifyReturnRightNode(node);
     }
 
     return node;
 }
 
-static inline TreeNode* TreeSimplifySub(TreeNode* node, int* simplifiesCount)
+static inline TreeNode* TreeSimplifySub(TreeNode* node)
 {
     CHECK();
 
     if (R_IS_NUM(node) && DoubleEqual(R_NUM(node), 0))
     {    
-        (*simplifiesCount)++;
         return TreeSimplifyReturnLeftNode(node);
     }
 
     return node;
 }
 
-static inline TreeNode* TreeSimplifyMul(TreeNode* node, int* simplifiesCount)
+static inline TreeNode* TreeSimplifyMul(TreeNode* node)
 {
     CHECK();
 
     if (R_IS_NUM(node) && DoubleEqual(R_NUM(node), 0))
     {
-        (*simplifiesCount)++;
         return TreeSimplifyReturnNumNode(node, 0);
     }
 
     if (L_IS_NUM(node) && DoubleEqual(L_NUM(node), 0))
     {
-        (*simplifiesCount)++;
         return TreeSimplifyReturnNumNode(node, 0);
     }
 
     if (R_IS_NUM(node) && DoubleEqual(R_NUM(node), 1))
     {
-        (*simplifiesCount)++;
         return TreeSimplifyReturnLeftNode(node);
     }
 
     if (L_IS_NUM(node) && DoubleEqual(L_NUM(node), 1))
     {
-        (*simplifiesCount)++;
         return TreeSimplifyReturnRightNode(node);
     }
 
     return node;
 }
 
-static inline TreeNode* TreeSimplifyDiv(TreeNode* node, int* simplifiesCount)
+static inline TreeNode* TreeSimplifyDiv(TreeNode* node)
 {
     CHECK();
 
     if (L_IS_NUM(node) && DoubleEqual(L_NUM(node), 0))
     {
-        (*simplifiesCount)++;
         return TreeSimplifyReturnNumNode(node, 0);
     }
 
     if (R_IS_NUM(node) && DoubleEqual(R_NUM(node), 1))
     {
-        (*simplifiesCount)++;
         return TreeSimplifyReturnLeftNode(node);
     }
 
     return node;
 }
 
-static inline TreeNode* TreeSimplifyPow(TreeNode* node, int* simplifiesCount)
+static inline TreeNode* TreeSimplifyPow(TreeNode* node)
 {
     CHECK();
 
     if (R_IS_NUM(node) && DoubleEqual(R_NUM(node), 0))
     {
-        (*simplifiesCount)++;
         return TreeSimplifyReturnNumNode(node, 1);
     }
 
     if (L_IS_NUM(node) && DoubleEqual(L_NUM(node), 0))
     {
-        (*simplifiesCount)++;
         return TreeSimplifyReturnNumNode(node, 0);
     }
 
     if (R_IS_NUM(node) && DoubleEqual(R_NUM(node), 1))
     {
-        (*simplifiesCount)++;
         return TreeSimplifyReturnLeftNode(node);
     }
 
     if (L_IS_NUM(node) && DoubleEqual(L_NUM(node), 1))
     {
-        (*simplifiesCount)++;
         return TreeSimplifyReturnNumNode(node, 1);
     }
 
@@ -339,22 +417,29 @@ static inline TreeNode* TreeSimplifyReturnRightNode(TreeNode* node)
 
 static inline TreeNode* TreeSimplifyReturnNumNode(TreeNode* node, int value)
 {
-    TreeNodeDtor(R(node));
-    TreeNodeDtor(L(node));
+    if (R(node))
+        TreeNodeDtor(R(node));
+    if (L(node))
+        TreeNodeDtor(L(node));
 
     node->left  = nullptr;
     node->right = nullptr;
 
-    return CREATE_NUM(value);
+    // operation node becomes the number, so nothing is allocated
+    node->valueType = TreeNodeValueType::NUM;
+    node->value     = TreeCreateNumVal(value);
+
+    return node;
 }
 
 //---------------------------------------------------------------------------------------
 
+/// @brief Children must be simplified already: constant subtree is folded to NUM then,
+///        so the check does not walk the subtree.
 static bool TreeNodeCanBeCalculated(const TreeNode* node)
 {
-    if (node == nullptr)
-        return true;
-    
+    assert(node);
+
     if (IS_NUM(node))
         return true;
     
@@ -364,7 +449,32 @@ static bool TreeNodeCanBeCalculated(const TreeNode* node)
     if (IS_STRING_LITERAL(node))
         return false;
 
-    switch (node->value.operation)
+    if (!OperationCanBeCalculated(node->value.operation))
+        return false;
+
+    if ((L(node) && !IS_NUM(L(node))) || (R(node) && !IS_NUM(R(node))))
+        return false;
+
+    return CalculationIsExact(node->value.operation, TreeCalculate(L(node)), 
+                                                     TreeCalculate(R(node)));
+}
+
+bool TreeCalculateOperation(const TreeOperationId operation, const int val1, const int val2,
+                            int* result)
+{
+    assert(result);
+
+    if (!OperationCanBeCalculated(operation) || !CalculationIsExact(operation, val1, val2))
+        return false;
+
+    *result = CalculateUsingOperation(operation, val1, val2);
+
+    return true;
+}
+
+static bool OperationCanBeCalculated(const TreeOperationId operation)
+{
+    switch (operation)
     {
         case TreeOperationId::ADD:
         case TreeOperationId::SUB:
@@ -372,19 +482,379 @@ static bool TreeNodeCanBeCalculated(const TreeNode* node)
         case TreeOperationId::DIV:
         case TreeOperationId::POW:
         case TreeOperationId::SQRT:
-            break;
+        case TreeOperationId::LESS:
+        case TreeOperationId::GREATER:
+        case TreeOperationId::LESS_EQ:
+        case TreeOperationId::GREATER_EQ:
+        case TreeOperationId::EQ:
+        case TreeOperationId::NOT_EQ:
+        case TreeOperationId::AND:
+        case TreeOperationId::OR:
+            return true;
         
         default:
             return false;
-            break;
     }
+}
 
-    bool canBeCalculated  = TreeNodeCanBeCalculated(L(node));
+/// @brief Tree values are integer, but program computes in doubles, so
+///        division and sqrt are folded only if the result is integer too and
+///        results out of int range are not folded at all.
+///        and / or are bitwise on doubles, the same as on ints only for 0 / 1.
+static bool CalculationIsExact(const TreeOperationId operation, const int val1, const int val2)
+{
+    switch (operation)
+    {
+        case TreeOperationId::ADD:
+            return IsIntRange((long long)val1 + val2);
 
-    if (!canBeCalculated)
-        return canBeCalculated;
-    
-    canBeCalculated = TreeNodeCanBeCalculated(R(node));
+        case TreeOperationId::SUB:
+            return IsIntRange((long long)val1 - val2);
+
+        case TreeOperationId::MUL:
+            return IsIntRange((long long)val1 * val2);
+
+        case TreeOperationId::DIV:
+            return val2 != 0 && val1 % val2 == 0 && !(val1 == INT_MIN && val2 == -1);
+
+        case TreeOperationId::POW:
+        {
+            // only 1 and -1 give integer with negative power
+            if (val2 < 0)
+                return val1 == 1 || val1 == -1;
+
+            double val = pow(val1, val2);
+
+            return INT_MIN <= val && val <= INT_MAX && DoubleEqual(val, floor(val));
+        }
+
+        case TreeOperationId::SQRT:
+        {
+            if (val1 <= 0)
+                return false;
+
+            int root = (int)sqrt(val1);
+
+            return root * root == val1;
+        }
+
+        case TreeOperationId::AND:
+        case TreeOperationId::OR:
+            return (val1 == 0 || val1 == 1) && (val2 == 0 || val2 == 1);
+
+        default:
+            return true;
+    }
+}
+
+static inline bool IsIntRange(const long long val)
+{
+    return INT_MIN <= val && val <= INT_MAX;
+}
+
+//---------------------------------------------------------------------------------------
+
+/// @brief Flow sensitive constant and copy propagation over function bodies. Uses of
+///        variables known to be constant or a copy of another variable are replaced and
+///        expressions are folded right away, so new facts appear. Facts after IF are the
+///        ones true on both paths, variables assigned in WHILE are unknown in the whole loop.
+void TreePropagateConstants(Tree* tree)
+{
+    assert(tree);
+
+    PropagateInFuncs(tree->root, tree->allNamesTable);
+}
+
+static void PropagateInFuncs(TreeNode* node, const NameTableType* allNamesTable)
+{
+    assert(allNamesTable);
+
+    if (node == nullptr || !IS_OP(node))
+        return;
+
+    if (node->value.operation != TreeOperationId::FUNC)
+    {
+        PropagateInFuncs(L(node), allNamesTable);
+        PropagateInFuncs(R(node), allNamesTable);
+        return;
+    }
+
+    assert(L(node) && IS_NAME(L(node)));
+
+    VarFacts facts = VarFactsCtor();
+
+    PropagateStatements(L(node)->right, &facts, allNamesTable);
+
+    VarFactsDtor(&facts);
+}
+
+static void PropagateStatements(TreeNode* list, VarFacts* facts,
+                                const NameTableType* allNamesTable)
+{
+    assert(facts);
+    assert(allNamesTable);
+
+    for (; list; list = R(list))
+    {
+        assert(IS_OP(list) && list->value.operation == TreeOperationId::LINE_END);
+
+        TreeNode* stmt = L(list);
+        if (stmt == nullptr || !IS_OP(stmt))
+            continue;
+
+        switch (stmt->value.operation)
+        {
+            case TreeOperationId::TYPE:
+                if (R(stmt) && IS_OP(R(stmt)) && R(stmt)->value.operation == TreeOperationId::ASSIGN)
+                    PropagateAssign(R(stmt), facts, allNamesTable);
+                break;
+
+            case TreeOperationId::ASSIGN:
+                PropagateAssign(stmt, facts, allNamesTable);
+                break;
+
+            case TreeOperationId::IF:
+            {
+                PropagateExpr(&stmt->left, facts, allNamesTable);
+
+                // constant condition - body is either always or never executed
+                if (IS_NUM(L(stmt)))
+                {
+                    if (L(stmt)->value.num != 0)
+                        PropagateStatements(R(stmt), facts, allNamesTable);
+                    break;
+                }
+
+                VarFacts bodyFacts = VarFactsCopy(facts);
+                PropagateStatements(R(stmt), &bodyFacts, allNamesTable);
+
+                VarFactsMerge(facts, &bodyFacts);
+                VarFactsDtor(&bodyFacts);
+                break;
+            }
+
+            case TreeOperationId::WHILE:
+            {
+                PropagateKillAssigned(R(stmt), facts, allNamesTable);
+                PropagateExpr(&stmt->left, facts, allNamesTable);
+
+                // constant condition - body is either always or never executed
+                if (IS_NUM(L(stmt)))
+                {
+                    if (L(stmt)->value.num != 0)
+                        PropagateStatements(R(stmt), facts, allNamesTable);
+                    break;
+                }
+
+                VarFacts bodyFacts = VarFactsCopy(facts);
+                PropagateStatements(R(stmt), &bodyFacts, allNamesTable);
+                VarFactsDtor(&bodyFacts);
+                break;
+            }
+
+            default:
+                PropagateExpr(&stmt->left,  facts, allNamesTable);
+                PropagateExpr(&stmt->right, facts, allNamesTable);
+                break;
+        }
+    }
+}
+
+static void PropagateAssign(TreeNode* assign, VarFacts* facts,
+                            const NameTableType* allNamesTable)
+{
+    assert(assign);
+    assert(facts);
+    assert(allNamesTable);
+    assert(L(assign) && IS_NAME(L(assign)));
+
+    PropagateExpr(&assign->right, facts, allNamesTable);
+
+    InternId var = NameTableGetNameId(allNamesTable, L(assign)->value.nameId);
+    VarFactsKill(facts, var);
+
+    TreeNode* value = R(assign);
+    if (IS_NUM(value))
+    {
+        VarFactsPush(facts, { var, VarFactType::CONST, value->value.num, NO_INTERN_ID, 0 });
+        return;
+    }
+
+    if (!IS_NAME(value))
+        return;
+
+    InternId source = NameTableGetNameId(allNamesTable, value->value.nameId);
+    if (source != var)
+        VarFactsPush(facts, { var, VarFactType::COPY, 0, source, value->value.nameId });
+}
+
+static void PropagateExpr(TreeNode** node, const VarFacts* facts,
+                          const NameTableType* allNamesTable)
+{
+    assert(node);
+    assert(facts);
+    assert(allNamesTable);
+
+    if (*node == nullptr)
+        return;
+
+    PropagateReplaceNames(node, facts, allNamesTable);
+    TreeSimplify(node, true);
+}
+
+static void PropagateReplaceNames(TreeNode** node, const VarFacts* facts,
+                                  const NameTableType* allNamesTable)
+{
+    assert(node);
+    assert(facts);
+    assert(allNamesTable);
+
+    if (*node == nullptr)
+        return;
+
+    if (IS_NAME((*node)))
+    {
+        const VarFact* fact = VarFactsFind(facts, 
+                                           NameTableGetNameId(allNamesTable, (*node)->value.nameId));
+        if (fact == nullptr)
+            return;
+
+        // name node has no children, it becomes the value in place
+        if (fact->type == VarFactType::CONST)
+        {
+            (*node)->valueType = TreeNodeValueType::NUM;
+            (*node)->value     = TreeCreateNumVal(fact->value);
+        }
+        else
+            (*node)->value     = TreeCreateNameVal(fact->sourceId);
+
+        return;
+    }
+
+    if (IS_OP((*node)) && (*node)->value.operation == TreeOperationId::FUNC_CALL)
+    {
+        assert((*node)->left && IS_NAME((*node)->left));
+
+        PropagateReplaceNames(&(*node)->left->left, facts, allNamesTable);
+        return;
+    }
+
+    PropagateReplaceNames(&(*node)->left,  facts, allNamesTable);
+    PropagateReplaceNames(&(*node)->right, facts, allNamesTable);
+}
+
+static void PropagateKillAssigned(const TreeNode* node, VarFacts* facts,
+                                  const NameTableType* allNamesTable)
+{
+    assert(facts);
+    assert(allNamesTable);
+
+    if (node == nullptr)
+        return;
+
+    if (IS_OP(node) && node->value.operation == TreeOperationId::ASSIGN)
+    {
+        assert(L(node) && IS_NAME(L(node)));
+
+        VarFactsKill(facts, NameTableGetNameId(allNamesTable, L(node)->value.nameId));
+    }
+
+    PropagateKillAssigned(L(node), facts, allNamesTable);
+    PropagateKillAssigned(R(node), facts, allNamesTable);
+}
+
+//---------------------------------------------------------------------------------------
+
+static VarFacts VarFactsCtor()
+{
+    return { nullptr, 0, 0 };
+}
+
+static void VarFactsDtor(VarFacts* facts)
+{
+    assert(facts);
+
+    free(facts->data);
+
+    *facts = {};
+}
+
+static VarFacts VarFactsCopy(const VarFacts* facts)
+{
+    assert(facts);
+
+    VarFacts copy = VarFactsCtor();
+
+    for (size_t i = 0; i < facts->size; ++i)
+        VarFactsPush(&copy, facts->data[i]);
+
+    return copy;
+}
+
+/// @brief leaves only facts that are true in otherFacts too
+static void VarFactsMerge(VarFacts* facts, const VarFacts* otherFacts)
+{
+    assert(facts);
+    assert(otherFacts);
+
+    size_t newSize = 0;
+    for (size_t i = 0; i < facts->size; ++i)
+    {
+        const VarFact* fact      = facts->data + i;
+        const VarFact* otherFact = VarFactsFind(otherFacts, fact->var);
+
+        if (otherFact == nullptr || otherFact->type != fact->type ||
+            otherFact->value != fact->value || otherFact->source != fact->source)
+            continue;
+
+        facts->data[newSize++] = *fact;
+    }
+
+    facts->size = newSize;
+}
+
+/// @brief variable is assigned: facts about it and copies of it are not true anymore
+static void VarFactsKill(VarFacts* facts, InternId var)
+{
+    assert(facts);
+
+    size_t newSize = 0;
+    for (size_t i = 0; i < facts->size; ++i)
+    {
+        const VarFact* fact = facts->data + i;
+
+        if (fact->var == var || (fact->type == VarFactType::COPY && fact->source == var))
+            continue;
+
+        facts->data[newSize++] = *fact;
+    }
+
+    facts->size = newSize;
+}
+
+static void VarFactsPush(VarFacts* facts, VarFact fact)
+{
+    assert(facts);
+
+    if (facts->size == facts->capacity)
+    {
+        facts->capacity = 2 * facts->capacity + 8;
+        facts->data = (VarFact*)realloc(facts->data, facts->capacity * sizeof(*facts->data));
+        assert(facts->data);
+    }
+
+    facts->data[facts->size++] = fact;
+}
+
+static const VarFact* VarFactsFind(const VarFacts* facts, InternId var)
+{
+    assert(facts);
+
+    for (size_t i = 0; i < facts->size; ++i)
+    {
+        if (facts->data[i].var == var)
+            return facts->data + i;
+    }
 
-    return canBeCalculated;
+    return nullptr;
 }
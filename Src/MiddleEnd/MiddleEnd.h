@@ -7,4 +7,65 @@ int TreeCalculate(const Tree* tree);
 
 void TreeSimplify(Tree* tree);
 
+/// @brief Calculates operation the same way as the program does in doubles.
+/// @return false if the operation can't be calculated or the result is not an exact int
+bool TreeCalculateOperation(const TreeOperationId operation, const int val1, const int val2,
+                            int* result);
+
+/// @brief Replaces variables with constants and copied variables where they are known
+///        and folds the expressions. Must be run before TreeSimplify.
+void TreePropagateConstants(Tree* tree);
+
+/// @brief Replaces calls of small non recursive functions with copies of their bodies.
+///        Must be run before TreeSimplify to let it fold constants passed as arguments.
+void TreeInline(Tree* tree);
+
+/// @brief Replaces calls of pure functions with constant arguments with their results,
+///        calculated by the interpreter. Must be run after TreeSimplify.
+/// @return number of replaced calls
+size_t TreeEvaluatePureCalls(Tree* tree);
+
+/// @brief Removes statements after RETURN, IF / WHILE with constant false condition
+///        and stores to variables that are never read. Must be run after TreeSimplify.
+/// @return number of removed nodes
+size_t TreeRemoveDeadCode(Tree* tree);
+
+/// @brief Computes pure subexpressions repeated in one statement chain once into new
+///        variables. Must be run after TreeSimplify.
+void TreeEliminateCommonExprs(Tree* tree);
+
+/// @brief Moves expressions and pure calls, that are the same on every iteration, out of
+///        WHILE loops into IF with the loop condition placed before the loop.
+///        Must be run after TreeRemoveDeadCode.
+void TreeHoistLoopInvariants(Tree* tree);
+
+struct FuncPurity
+{
+    InternId        name;
+    const TreeNode* params;
+    const TreeNode* body;
+
+    bool isPure;    ///< no PRINT / READ, calls only pure functions
+};
+
+struct FuncsPurity
+{
+    const NameTableType* allNamesTable;
+
+    FuncPurity* funcs;
+    size_t      funcsCount;
+    size_t      funcsCapacity;
+};
+
+FuncsPurity FuncsPurityCtor(const Tree* tree);
+void        FuncsPurityDtor(FuncsPurity* purity);
+
+/// @return function with the name, nullptr if it is not defined
+const FuncPurity* FuncsPurityFind(const FuncsPurity* purity, InternId name);
+
+bool FuncsPurityIsPureFunc(const FuncsPurity* purity, InternId name);
+
+/// @brief true if the subtree has no PRINT / READ and calls only pure functions
+bool FuncsPurityIsPure    (const FuncsPurity* purity, const TreeNode* node);
+
 #endif
\ No newline at end of file
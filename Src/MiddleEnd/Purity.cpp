@@ -0,0 +1,141 @@
+#include <assert.h>
+#include <stdlib.h>
+
+#include "MiddleEnd.h"
+#include "Tree/DSL.h"
+
+// Function is pure if it has no PRINT / READ and calls only pure functions. All functions
+// start as pure and lose it one by one until nothing changes, so recursive functions
+// stay pure if nothing else in them is impure. Calls of undefined functions are impure.
+// Functions can't change caller variables, so a pure call with the same arguments
+// always returns the same value.
+
+static void FuncsPurityCollect(FuncsPurity* purity, const TreeNode* node);
+static void FuncsPurityPush   (FuncsPurity* purity, InternId name, const TreeNode* params,
+                               const TreeNode* body);
+
+//---------------------------------------------------------------------------------------
+
+FuncsPurity FuncsPurityCtor(const Tree* tree)
+{
+    assert(tree);
+
+    FuncsPurity purity = {};
+    purity.allNamesTable = tree->allNamesTable;
+
+    FuncsPurityCollect(&purity, tree->root);
+
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+
+        for (size_t i = 0; i < purity.funcsCount; ++i)
+        {
+            FuncPurity* func = purity.funcs + i;
+
+            if (func->isPure && !FuncsPurityIsPure(&purity, func->body))
+            {
+                func->isPure = false;
+                changed      = true;
+            }
+        }
+    }
+
+    return purity;
+}
+
+void FuncsPurityDtor(FuncsPurity* purity)
+{
+    assert(purity);
+
+    free(purity->funcs);
+
+    *purity = {};
+}
+
+const FuncPurity* FuncsPurityFind(const FuncsPurity* purity, InternId name)
+{
+    assert(purity);
+
+    for (size_t i = 0; i < purity->funcsCount; ++i)
+    {
+        if (purity->funcs[i].name == name)
+            return purity->funcs + i;
+    }
+
+    return nullptr;
+}
+
+bool FuncsPurityIsPureFunc(const FuncsPurity* purity, InternId name)
+{
+    assert(purity);
+
+    const FuncPurity* func = FuncsPurityFind(purity, name);
+
+    return func && func->isPure;
+}
+
+bool FuncsPurityIsPure(const FuncsPurity* purity, const TreeNode* node)
+{
+    assert(purity);
+
+    if (node == nullptr || !IS_OP(node))
+        return true;
+
+    switch (node->value.operation)
+    {
+        case TreeOperationId::PRINT:
+        case TreeOperationId::READ:
+            return false;
+
+        case TreeOperationId::FUNC_CALL:
+            assert(node->left && IS_NAME(node->left));
+
+            return FuncsPurityIsPureFunc(purity,
+                        NameTableGetNameId(purity->allNamesTable, node->left->value.nameId)) &&
+                   FuncsPurityIsPure(purity, node->left->left);
+
+        default:
+            return FuncsPurityIsPure(purity, node->left) &&
+                   FuncsPurityIsPure(purity, node->right);
+    }
+}
+
+//---------------------------------------------------------------------------------------
+
+static void FuncsPurityCollect(FuncsPurity* purity, const TreeNode* node)
+{
+    assert(purity);
+
+    if (node == nullptr || !IS_OP(node))
+        return;
+
+    if (node->value.operation != TreeOperationId::FUNC)
+    {
+        FuncsPurityCollect(purity, node->left);
+        FuncsPurityCollect(purity, node->right);
+        return;
+    }
+
+    assert(node->left && IS_NAME(node->left));
+
+    FuncsPurityPush(purity, NameTableGetNameId(purity->allNamesTable, node->left->value.nameId),
+                    node->left->left, node->left->right);
+}
+
+static void FuncsPurityPush(FuncsPurity* purity, InternId name, const TreeNode* params,
+                            const TreeNode* body)
+{
+    assert(purity);
+
+    if (purity->funcsCount == purity->funcsCapacity)
+    {
+        purity->funcsCapacity = 2 * purity->funcsCapacity + 8;
+        purity->funcs = (FuncPurity*)realloc(purity->funcs,
+                                             purity->funcsCapacity * sizeof(*purity->funcs));
+        assert(purity->funcs);
+    }
+
+    purity->funcs[purity->funcsCount++] = { name, params, body, true };
+}
@@ -0,0 +1,122 @@
+#include <assert.h>
+#include <stdio.h>
+
+#include "TreeUtils.h"
+#include "Tree/DSL.h"
+
+bool TreeIsOp(const TreeNode* node, TreeOperationId operation)
+{
+    return node && IS_OP(node) && node->value.operation == operation;
+}
+
+InternId TreeGetNameId(const Tree* tree, const TreeNode* nameNode)
+{
+    assert(tree);
+    assert(nameNode);
+    assert(IS_NAME(nameNode));
+
+    return NameTableGetNameId(tree->allNamesTable, nameNode->value.nameId);
+}
+
+bool TreeOpIsPure(TreeOperationId operation)
+{
+    switch (operation)
+    {
+        case TreeOperationId::ADD:
+        case TreeOperationId::SUB:
+        case TreeOperationId::UNARY_SUB:
+        case TreeOperationId::MUL:
+        case TreeOperationId::DIV:
+        case TreeOperationId::POW:
+        case TreeOperationId::SQRT:
+        case TreeOperationId::SIN:
+        case TreeOperationId::COS:
+        case TreeOperationId::TAN:
+        case TreeOperationId::COT:
+        case TreeOperationId::LESS:
+        case TreeOperationId::GREATER:
+        case TreeOperationId::LESS_EQ:
+        case TreeOperationId::GREATER_EQ:
+        case TreeOperationId::EQ:
+        case TreeOperationId::NOT_EQ:
+        case TreeOperationId::AND:
+        case TreeOperationId::OR:
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+bool TreeIsAssigned(const Tree* tree, const TreeNode* node, InternId name)
+{
+    assert(tree);
+
+    if (node == nullptr)
+        return false;
+
+    if (TreeIsOp(node, TreeOperationId::ASSIGN) && TreeGetNameId(tree, node->left) == name)
+        return true;
+
+    return TreeIsAssigned(tree, node->left, name) || TreeIsAssigned(tree, node->right, name);
+}
+
+bool TreeHasCalls(const TreeNode* node)
+{
+    if (node == nullptr)
+        return false;
+
+    if (TreeIsOp(node, TreeOperationId::FUNC_CALL) || TreeIsOp(node, TreeOperationId::READ))
+        return true;
+
+    return TreeHasCalls(node->left) || TreeHasCalls(node->right);
+}
+
+bool TreeHasReturn(const TreeNode* node)
+{
+    if (node == nullptr)
+        return false;
+
+    if (TreeIsOp(node, TreeOperationId::RETURN))
+        return true;
+
+    return TreeHasReturn(node->left) || TreeHasReturn(node->right);
+}
+
+size_t TreeCountNodes(const TreeNode* node)
+{
+    if (node == nullptr)
+        return 0;
+
+    return 1 + TreeCountNodes(node->left) + TreeCountNodes(node->right);
+}
+
+TreeNode* TreeCopySubtree(Tree* tree, const TreeNode* node)
+{
+    assert(tree);
+
+    if (node == nullptr)
+        return nullptr;
+
+    return TreeNodeCreate(tree, node->value, node->valueType,
+                          TreeCopySubtree(tree, node->left),
+                          TreeCopySubtree(tree, node->right));
+}
+
+TreeNode* TreeCreateTempVar(Tree* tree, const char* prefix, size_t* counter)
+{
+    assert(tree);
+    assert(prefix);
+    assert(counter);
+
+    static const size_t maxNameLength = 128;
+    char nameStr[maxNameLength] = "";
+
+    snprintf(nameStr, maxNameLength, "%s.%zu", prefix, (*counter)++);
+
+    Name name = {};
+    NameCtor(&name, nameStr, nullptr, 0);
+    NameTablePush(tree->allNamesTable, name);
+
+    return CREATE_VAR(tree, tree->allNamesTable->size - 1);
+}
@@ -0,0 +1,31 @@
+#ifndef TREE_UTILS_H
+#define TREE_UTILS_H
+
+#include "Tree/Tree.h"
+
+// Helpers shared by the middle-end passes, not a part of the middle-end interface.
+
+bool      TreeIsOp       (const TreeNode* node, TreeOperationId operation);
+
+/// @brief intern id of the name node, equal for all nodes with the same name
+InternId  TreeGetNameId  (const Tree* tree, const TreeNode* nameNode);
+
+/// @brief operation without side effects, that depends only on its operands
+bool      TreeOpIsPure   (TreeOperationId operation);
+
+/// @brief true if the subtree contains assignment to the variable
+bool      TreeIsAssigned (const Tree* tree, const TreeNode* node, InternId name);
+
+/// @brief true if the subtree contains function calls or READ
+bool      TreeHasCalls   (const TreeNode* node);
+bool      TreeHasReturn  (const TreeNode* node);
+size_t    TreeCountNodes (const TreeNode* node);
+
+/// @brief copy is created in the arena of the tree
+TreeNode* TreeCopySubtree(Tree* tree, const TreeNode* node);
+
+/// @brief Adds fresh name "prefix.N" to the names table, N is taken from the counter.
+/// @return variable node with the new name
+TreeNode* TreeCreateTempVar(Tree* tree, const char* prefix, size_t* counter);
+
+#endif
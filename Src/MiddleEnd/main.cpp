@@ -4,9 +4,13 @@
 
 #include "MiddleEnd.h"
 #include "Common/Log.h"
+#include "Common/CommandLineArgsParser.h"
 
-int main(int argc, char* argv[])
+int main(int argc, const char* argv[])
 {
+    static const char* binaryOutputOption  = "-b";
+    static const char* deadCodeStatsOption = "-dce-stats";
+
     assert(argc > 2);
     LogOpen(argv[0]);
 
@@ -16,14 +20,33 @@ int main(int argc, char* argv[])
     Tree tree = {};
     TreeCtor(&tree);
     
-    TreeReadPrefixFormat(&tree, inStream);
+    TreeRead(&tree, inStream);
 
     TreeGraphicDump(&tree, true);
     
+    TreeInline(&tree);
+    TreePropagateConstants(&tree);
     TreeSimplify(&tree);
 
+    // results of calls can make args of other calls constant
+    while (TreeEvaluatePureCalls(&tree) > 0)
+    {
+        TreePropagateConstants(&tree);
+        TreeSimplify(&tree);
+    }
+
+    size_t deadNodes = TreeRemoveDeadCode(&tree);
+    if (GetCommandLineArgPos(argc, argv, deadCodeStatsOption) != NO_COMMAND_LINE_ARG)
+        printf("Dead code: removed nodes - %zu\n", deadNodes);
+
+    TreeHoistLoopInvariants(&tree);
+    TreeEliminateCommonExprs(&tree);
+
     TreeGraphicDump(&tree, true);
-    TreePrintPrefixFormat(&tree, outStream);
+    if (GetCommandLineArgPos(argc, argv, binaryOutputOption) != NO_COMMAND_LINE_ARG)
+        TreePrintBinaryFormat(&tree, outStream);
+    else
+        TreePrintPrefixFormat(&tree, outStream);
 
     TreeDtor(&tree);
     fclose(inStream);
@@ -3,12 +3,12 @@
 #include "Tree.h"
 
 
-#define GENERATE_OPERATION_CMD(NAME, ...)                                       \
-    TreeNode* CREATE_##NAME ##_NODE(TreeNode* left, TreeNode* right)            \
-    {                                                                           \
-        return TreeNodeCreate(TreeCreateOpVal(TreeOperationId::NAME),           \
-                              TreeNodeValueType::OPERATION,                     \
-                              left, right);                                     \
+#define GENERATE_OPERATION_CMD(NAME, ...)                                        \
+    TreeNode* CREATE_##NAME ##_NODE(Tree* tree, TreeNode* left, TreeNode* right) \
+    {                                                                            \
+        return TreeNodeCreate(tree, TreeCreateOpVal(TreeOperationId::NAME),      \
+                              TreeNodeValueType::OPERATION,                      \
+                              left, right);                                      \
     }
 
 #include "Operations.h"
@@ -20,12 +20,13 @@
 #define R_NUM(token) token->right->value.num
 
 
-#define CREATE_NUM(VALUE)         TreeNumNodeCreate(VALUE)
-#define CREATE_VAR(id)            TreeNameNodeCreate(id)
-#define CREATE_STRING_LITERAL(id) TreeStringLiteralNodeCreate(id);
+// Nodes are created in the arena of the tree
+#define CREATE_NUM(tree, VALUE)         TreeNumNodeCreate(tree, VALUE)
+#define CREATE_VAR(tree, id)            TreeNameNodeCreate(tree, id)
+#define CREATE_STRING_LITERAL(tree, id) TreeStringLiteralNodeCreate(tree, id);
 
-#define GENERATE_OPERATION_CMD(NAME, ...)                                               \
-    TreeNode* CREATE_##NAME ##_NODE(TreeNode* left, TreeNode* right = nullptr);  \
+#define GENERATE_OPERATION_CMD(NAME, ...)                                                  \
+    TreeNode* CREATE_##NAME ##_NODE(Tree* tree, TreeNode* left, TreeNode* right = nullptr); \
 
 #include "Operations.h"
 
@@ -20,6 +20,10 @@ static inline bool NameTableIsFull(NameTableType* nameTable);
 
 static inline bool NameTableIsTooBig(NameTableType* nameTable);
 
+static NameTableErrors NameTableHashIndexRebuild(NameTableType* nameTable, const size_t newCapacity);
+static void            NameTableHashIndexInsert (NameTableType* nameTable, const size_t namePos);
+static inline size_t   NameTableHashIndexStart  (const NameTableType* nameTable, InternId nameId);
+
 //--------CANARY PROTECTION----------
 
 #ifdef NAME_TABLE_CANARY_PROTECTION
@@ -80,6 +84,7 @@ static inline bool NameTableIsTooBig(NameTableType* nameTable);
 //--------------Consts-----------------
 
 static const size_t STANDARD_CAPACITY = 64;
+static const size_t STANDARD_HASH_INDEX_CAPACITY = 2 * STANDARD_CAPACITY;
 
 //---------------
 
@@ -147,7 +152,6 @@ NameTableErrors NameTableCtor(NameTableType* const nameTable, const size_t capac
     NameTableErrors errors = NameTableErrors::NO_ERR;
     nameTable->size = 0;
 
-    capacity = 1000; // CRUTCH
     if (capacity > 0) nameTable->capacity = capacity;
     else              nameTable->capacity = STANDARD_CAPACITY;
 
@@ -170,6 +174,9 @@ NameTableErrors NameTableCtor(NameTableType* const nameTable, const size_t capac
         nameTable->data = GetAfterFirstCanaryAdr(nameTable);
     )
 
+    errors = NameTableHashIndexRebuild(nameTable, STANDARD_HASH_INDEX_CAPACITY);
+    IF_ERR_RETURN(errors);
+
     ON_HASH
     (
         UpdateDataHash(nameTable);
@@ -198,7 +205,6 @@ NameTableErrors NameTableCtor(NameTableType** const outNameTable, size_t capacit
     NameTableErrors errors = NameTableErrors::NO_ERR;
     nameTable->size = 0;
 
-    capacity = 1000; // TODO: crutch
     if (capacity > 0) nameTable->capacity = capacity;
     else              nameTable->capacity = STANDARD_CAPACITY;
 
@@ -221,6 +227,9 @@ NameTableErrors NameTableCtor(NameTableType** const outNameTable, size_t capacit
         nameTable->data = GetAfterFirstCanaryAdr(nameTable);
     )
 
+    errors = NameTableHashIndexRebuild(nameTable, STANDARD_HASH_INDEX_CAPACITY);
+    IF_ERR_RETURN(errors);
+
     NAME_TABLE_CHECK(nameTable);
 
     *outNameTable = nameTable;
@@ -240,7 +249,6 @@ NameTableErrors NameTableDtor(NameTableType* const nameTable)
         if (nameTable->data[i].localNameTable)
             NameTableDtor((NameTableType*)nameTable->data[i].localNameTable);
 
-        free(nameTable->data[i].name);
         nameTable->data[i] = NAME_TABLE_POISON;
     }
 
@@ -252,6 +260,10 @@ NameTableErrors NameTableDtor(NameTableType* const nameTable)
     free(nameTable->data);
     nameTable->data = nullptr;
 
+    free(nameTable->hashIndex);
+    nameTable->hashIndex         = nullptr;
+    nameTable->hashIndexCapacity = 0;
+
     nameTable->size     = 0;
     nameTable->capacity = 0;
 
@@ -284,6 +296,15 @@ NameTableErrors NameTablePush(NameTableType* nameTable, const Name val)
 
     nameTable->data[nameTable->size++] = val;
 
+    if (2 * nameTable->size > nameTable->hashIndexCapacity)
+    {
+        NameTableErrors indexErr = NameTableHashIndexRebuild(nameTable, 
+                                                             2 * nameTable->hashIndexCapacity);
+        IF_ERR_RETURN(indexErr);
+    }
+    else
+        NameTableHashIndexInsert(nameTable, nameTable->size - 1);
+
     ON_HASH
     (
         UpdateDataHash(nameTable);
@@ -296,17 +317,34 @@ NameTableErrors NameTablePush(NameTableType* nameTable, const Name val)
 }
 
 NameTableErrors NameTableFind(const NameTableType* table, const char* name, Name** outName)
+{
+    assert(table);
+    assert(name);
+    assert(outName);
+
+    return NameTableFind(table, StringInternFind(name), outName);
+}
+
+NameTableErrors NameTableFind(const NameTableType* table, InternId nameId, Name** outName)
 {
     assert(table);
     assert(outName);
 
     NAME_TABLE_CHECK(table);
 
-    for (size_t i = 0; i < table->size; ++i)
+    *outName = nullptr;
+    if (nameId == NO_INTERN_ID)
+        return NameTableErrors::NO_ERR;
+
+    size_t mask = table->hashIndexCapacity - 1;
+    for (size_t cell = NameTableHashIndexStart(table, nameId); table->hashIndex[cell] != 0; 
+                                                              cell = (cell + 1) & mask)
     {
-        if (strcmp(table->data[i].name, name) == 0)
+        Name* tableName = table->data + table->hashIndex[cell] - 1;
+
+        if (tableName->id == nameId)
         {
-            *outName = table->data + i;
+            *outName = tableName;
             return NameTableErrors::NO_ERR;
         }
     }
@@ -350,6 +388,12 @@ NameTableErrors NameTableVerify(const NameTableType* nameTable)
         return NameTableErrors::SIZE_OUT_OF_RANGE;
     }
 
+    if (nameTable->hashIndex == nullptr || nameTable->size > nameTable->hashIndexCapacity)
+    {
+        NameTablePrintError(NameTableErrors::INVALID_HASH_INDEX);
+        return NameTableErrors::INVALID_HASH_INDEX;
+    }
+
     //-----------Canary checking----------
 
     ON_CANARY
@@ -484,9 +528,6 @@ void NameTableDump(const NameTableType* nameTable, const char* const fileName,
 
 NameTableErrors NameTableRealloc(NameTableType* nameTable, bool increase)
 {
-    assert(false && "UNREACHABLE");
-    return NameTableErrors::NO_ERR; // TODO: fix
-
     assert(nameTable);
 
     NAME_TABLE_CHECK(nameTable);
@@ -565,6 +606,61 @@ static inline bool NameTableIsTooBig(NameTableType* nameTable)
     return (nameTable->size * 4 <= nameTable->capacity) & (nameTable->capacity > STANDARD_CAPACITY);
 }
 
+//---------------
+
+// Rebuilding in order of data keeps the first pushed name for repeated names,
+// the same one that linear search used to find.
+static NameTableErrors NameTableHashIndexRebuild(NameTableType* nameTable, const size_t newCapacity)
+{
+    assert(nameTable);
+    assert((newCapacity & (newCapacity - 1)) == 0);
+
+    size_t* newIndex = (size_t*)calloc(newCapacity, sizeof(*newIndex));
+
+    if (newIndex == nullptr)
+    {
+        NameTablePrintError(NameTableErrors::MEMORY_ALLOCATION_ERROR);
+        return NameTableErrors::MEMORY_ALLOCATION_ERROR;
+    }
+
+    free(nameTable->hashIndex);
+    nameTable->hashIndex         = newIndex;
+    nameTable->hashIndexCapacity = newCapacity;
+
+    for (size_t i = 0; i < nameTable->size; ++i)
+        NameTableHashIndexInsert(nameTable, i);
+
+    return NameTableErrors::NO_ERR;
+}
+
+static void NameTableHashIndexInsert(NameTableType* nameTable, const size_t namePos)
+{
+    assert(nameTable);
+    assert(nameTable->hashIndex);
+    assert(namePos < nameTable->size);
+
+    InternId nameId = nameTable->data[namePos].id;
+    size_t   mask   = nameTable->hashIndexCapacity - 1;
+
+    size_t cell = NameTableHashIndexStart(nameTable, nameId);
+    while (nameTable->hashIndex[cell] != 0)
+    {
+        if (nameTable->data[nameTable->hashIndex[cell] - 1].id == nameId)
+            return;
+
+        cell = (cell + 1) & mask;
+    }
+
+    nameTable->hashIndex[cell] = namePos + 1;
+}
+
+static inline size_t NameTableHashIndexStart(const NameTableType* nameTable, InternId nameId)
+{
+    assert(nameTable);
+
+    return NameTableMurmurHash(&nameId, sizeof(nameId)) & (nameTable->hashIndexCapacity - 1);
+}
+
 static inline Name* MovePtr(Name* const data, const size_t moveSz, const int times)
 {
     assert(data);
@@ -647,6 +743,9 @@ void NameTablePrintError(NameTableErrors error)
             break;
         case NameTableErrors::INVALID_STRUCT_HASH:
             LOG_ERR("NameTable struct hash is invalid.\n");
+            break;
+        case NameTableErrors::INVALID_HASH_INDEX:
+            LOG_ERR("NameTable hash index is invalid.\n");
 
         case NameTableErrors::NO_ERR:
         default:
@@ -660,7 +759,8 @@ void NameTablePrintError(NameTableErrors error)
 void NameCtor(Name* name, const char* string, void* localNameTablePtr, 
               int memShift, IRRegister reg)
 {
-    name->name           = strdup(string);
+    name->id             = StringIntern(string);
+    name->name           = StringInternGet(name->id);
     name->localNameTable = localNameTablePtr;
     name->memShift       = memShift;
     name->reg          = reg;
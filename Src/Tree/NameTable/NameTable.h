@@ -66,6 +66,9 @@ struct NameTableType
 
     size_t capacity;     ///< REAL size of the data at this moment (calloced more than need at this moment).
 
+    size_t* hashIndex;          ///< open addressing index: (pos in data + 1) or 0 for empty cell.
+    size_t  hashIndexCapacity;  ///< power of two, at least twice bigger than size.
+
     ON_CANARY
     (
         CanaryType structCanaryRight; ///< right canary for the struct
@@ -85,6 +88,8 @@ enum class NameTableErrors
     INVALID_CANARY, 
     INVALID_DATA_HASH,
     INVALID_STRUCT_HASH,
+
+    INVALID_HASH_INDEX,
 };
 
 #ifdef NAME_TABLE_HASH_PROTECTION
@@ -115,6 +120,7 @@ NameTableErrors NameTableDtor(NameTableType* const stk);
 NameTableErrors NameTablePush(NameTableType* stk, const Name val);
 
 NameTableErrors NameTableFind(const NameTableType* table, const char* name, Name** outName);
+NameTableErrors NameTableFind(const NameTableType* table, InternId nameId, Name** outName);
 
 NameTableErrors NameTableGetPos(const NameTableType* table, Name* namePtr, size_t* outPos);
 
@@ -148,6 +154,11 @@ static inline const char* NameTableGetName(const NameTableType* table, size_t po
     return table->data[pos].name;
 }
 
+static inline InternId NameTableGetNameId(const NameTableType* table, size_t pos)
+{
+    return table->data[pos].id;
+}
+
 static inline void NameTableSetLocalTable(const NameTableType* table, size_t pos, 
                                           NameTableType* localTable)
 {
@@ -9,10 +9,12 @@
 #include <stdio.h>
 
 #include "BackEnd/IR/IRRegisters.h"
+#include "Common/StringIntern.h"
 
 struct Name
 {
-    char* name;
+    const char* name; /// < interned string, it is not owned by the name
+    InternId    id;   /// < names are equal if ids are equal
 
     void*  localNameTable;
 
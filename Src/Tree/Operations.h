@@ -71,7 +71,7 @@ GENERATE_OPERATION_CMD(POW,
     return pow(val1, val2);
 },
 {
-    assert(false);
+    BuildPow(node, info);
 })
 
 #undef  CALC_CHECK
@@ -158,11 +158,12 @@ GENERATE_OPERATION_CMD(ASSIGN,
 
     assert(varName);
 
-    Build(node->right, info);
+    // operand is taken before building the expression, varName dangles if localTable reallocs
+    IROperand varOperand = IROperandMemCreate(varName->memShift, varName->reg);
 
-    IR_PUSH(IRNodeCreate(OP(F_POP), IROperandRegCreate(IR_REG(XMM0))));
-    IR_PUSH(IRNodeCreate(OP(F_MOV), IROperandMemCreate(varName->memShift, varName->reg),
-                                    IROperandRegCreate(IR_REG(XMM0))));
+    BuildExpr(node->right, info);
+
+    IR_PUSH(IRNodeCreate(OP(F_MOV), varOperand, IROperandRegCreate(RegStackPop(info))));
 })
 
 GENERATE_OPERATION_CMD(LINE_END, 
@@ -172,8 +173,8 @@ GENERATE_OPERATION_CMD(LINE_END,
     return -1;
 },
 {
-    Build(node->left,  info);
-    Build(node->right, info);
+    BuildStatement(node->left,  info);
+    BuildStatement(node->right, info);
 })
 
 GENERATE_OPERATION_CMD(IF, 
@@ -187,28 +188,12 @@ GENERATE_OPERATION_CMD(IF,
     assert(info->allNamesTable);
     assert(info->ir);
 
-    // TODO: можно отдельную функцию, где иду в condition и там, основываясь сразу на сравнении,
-    // Делаю вывод о jump to if end / not jump (типо на стек не кладу, выгодно по времени)
-
     size_t id = info->labelId;
     info->labelId += 1;
 
-    static const size_t maxLabelLen = 64;
-    char ifEndLabel[maxLabelLen] = "";
-    snprintf(ifEndLabel, maxLabelLen, "END_IF_%zu", id);
-
-    Build(node->left, info);
-    
-
-    IR_PUSH(IRNodeCreate(OP(F_POP), IROperandRegCreate(IR_REG(XMM0))));
-    
-    IR_PUSH(IRNodeCreate(OP(F_XOR), IROperandRegCreate(IR_REG(XMM1)), 
-                                    IROperandRegCreate(IR_REG(XMM1))));
-
-    IR_PUSH(IRNodeCreate(OP(F_CMP), IROperandRegCreate(IR_REG(XMM0)), 
-                                    IROperandRegCreate(IR_REG(XMM1))));
+    IRLabelId ifEndLabel = IRLabelCreate(info->ir, IRLabelType::END_IF, id);
 
-    IR_PUSH(IRNodeCreate(OP(JE), IROperandLabelCreate(ifEndLabel), true));
+    BuildCondJump(node->left, false, ifEndLabel, info);
 
     Build(node->right, info);
 
@@ -229,25 +214,12 @@ GENERATE_OPERATION_CMD(WHILE,
     size_t id = info->labelId;
     info->labelId += 1;
 
-    static const size_t maxLabelLen = 64;
-    char whileBeginLabel[maxLabelLen] = "";
-    char whileEndLabel  [maxLabelLen] = "";
-    snprintf(whileBeginLabel, maxLabelLen, "WHILE_%zu",     id);
-    snprintf(whileEndLabel,   maxLabelLen, "END_WHILE_%zu", id);
+    IRLabelId whileBeginLabel = IRLabelCreate(info->ir, IRLabelType::WHILE,     id);
+    IRLabelId whileEndLabel   = IRLabelCreate(info->ir, IRLabelType::END_WHILE, id);
 
     IR_PUSH_LABEL(whileBeginLabel);
 
-    Build(node->left, info);
-
-    IR_PUSH(IRNodeCreate(OP(F_POP), IROperandRegCreate(IR_REG(XMM0))));
-    
-    IR_PUSH(IRNodeCreate(OP(F_XOR), IROperandRegCreate(IR_REG(XMM1)),
-                                    IROperandRegCreate(IR_REG(XMM1))));
-
-    IR_PUSH(IRNodeCreate(OP(F_CMP), IROperandRegCreate(IR_REG(XMM0)), 
-                                    IROperandRegCreate(IR_REG(XMM1))));
-                                               
-    IR_PUSH(IRNodeCreate(OP(JE), IROperandLabelCreate(whileEndLabel), true));
+    BuildCondJump(node->left, false, whileEndLabel, info);
 
     Build(node->right, info);
 
@@ -258,55 +230,55 @@ GENERATE_OPERATION_CMD(WHILE,
 
 GENERATE_OPERATION_CMD(LESS, 
 {
-
+    return val1 < val2;
 },
 {
-    BuildComparison(OP(JB), node, info);
+    BuildComparison(node, info);
 })
 
 GENERATE_OPERATION_CMD(GREATER, 
 {
-
+    return val1 > val2;
 },
 {
-    BuildComparison(OP(JA), node, info);
+    BuildComparison(node, info);
 })
 
 GENERATE_OPERATION_CMD(LESS_EQ, 
 {
-
+    return val1 <= val2;
 },
 {
-    BuildComparison(OP(JBE), node, info);
+    BuildComparison(node, info);
 })
 
 GENERATE_OPERATION_CMD(GREATER_EQ,
 {
-
+    return val1 >= val2;
 },
 {
-    BuildComparison(OP(JAE), node, info);
+    BuildComparison(node, info);
 })
 
 GENERATE_OPERATION_CMD(EQ, 
 {
-
+    return val1 == val2;
 },
 {
-    BuildComparison(OP(JE), node, info);
+    BuildComparison(node, info);
 })
 
 GENERATE_OPERATION_CMD(NOT_EQ,
 {
-
+    return val1 != val2;
 },
 {
-    BuildComparison(OP(JNE), node, info);
+    BuildComparison(node, info);
 })
 
 GENERATE_OPERATION_CMD(AND,
 {
-    
+    return val1 & val2;
 },
 {
     BuildALUOp(OP(F_AND), 2, node, info);
@@ -314,7 +286,7 @@ GENERATE_OPERATION_CMD(AND,
 
 GENERATE_OPERATION_CMD(OR,
 {
-
+    return val1 | val2;
 },
 {
     BuildALUOp(OP(F_OR), 2, node, info);
@@ -335,10 +307,9 @@ GENERATE_OPERATION_CMD(PRINT,
         return;
     }
 
-    Build(node->left, info);
+    BuildExpr(node->left, info);
 
-    IR_PUSH(IRNodeCreate(OP(F_POP), IROperandRegCreate(IR_REG(XMM0))));
-    IR_PUSH(IRNodeCreate(OP(F_OUT), IROperandRegCreate(IR_REG(XMM0))));    
+    IR_PUSH(IRNodeCreate(OP(F_OUT), IROperandRegCreate(RegStackPop(info))));
 })
 
 GENERATE_OPERATION_CMD(READ,
@@ -348,8 +319,7 @@ GENERATE_OPERATION_CMD(READ,
 {
     assert(info->ir);
 
-    IR_PUSH(IRNodeCreate(OP(F_IN)));
-    IR_PUSH(IRNodeCreate(OP(F_PUSH), IROperandRegCreate(IR_REG(XMM0))));
+    BuildRead(info);
 })
 
 GENERATE_OPERATION_CMD(COMMA,
@@ -398,7 +368,8 @@ GENERATE_OPERATION_CMD(FUNC,
 
     TreeNode* funcNameNode = node->left;
 
-    IR_PUSH_LABEL(NameTableGetName(info->allNamesTable, funcNameNode->value.nameId));
+    IR_PUSH_LABEL(IRGetFuncLabel(info->ir, 
+                                 NameTableGetName(info->allNamesTable, funcNameNode->value.nameId)));
 
     IR_PUSH(IRNodeCreate(OP(PUSH), IROperandRegCreate(IR_REG(RBP))));
     IR_PUSH(IRNodeCreate(OP(MOV),  IROperandRegCreate(IR_REG(RBP)), 
@@ -410,17 +381,25 @@ GENERATE_OPERATION_CMD(FUNC,
 
     NameTableSetLocalTable(info->allNamesTable, funcNameNode->value.nameId, info->localTable);
 
-    info->memShift = 2 * (int)RXX_REG_BYTE_SIZE;
     info->regShift = IR_REG(RBP);
 
-    info->numberOfFuncParams = InitFuncParams(funcNameNode->left, info);
+    size_t paramsCount = CountCommaList(funcNameNode->left);
+    size_t paramPos    = 0;
+    InitFuncParams(funcNameNode->left, paramsCount, &paramPos, info);
 
-    info->memShift = 0;
-    int rspShift = InitFuncLocalVars(funcNameNode->right, info);
+    size_t regParamsCount     = paramsCount < RegParamsCount ? paramsCount : RegParamsCount;
+    info->numberOfStackParams = paramsCount - regParamsCount;
+
+    info->memShift = -(int)(regParamsCount * XMM_REG_BYTE_SIZE);
+    int rspShift   = info->memShift + InitFuncLocalVars(funcNameNode->right, info);
+    rspShift      += InitTailCalls(funcNameNode, info);
 
     IR_PUSH(IRNodeCreate(OP(ADD), IROperandRegCreate(IR_REG(RSP)), 
                                   IROperandImmCreate((long long)rspShift)));
 
+    BuildTailCallEntry(regParamsCount, info);
+    StoreRegParams(regParamsCount, info);
+
     Build(funcNameNode->right, info);
 
     BuildFuncQuit(info);
@@ -431,17 +410,7 @@ GENERATE_OPERATION_CMD(FUNC_CALL,
 
 },
 {
-    assert(node->left->valueType == TreeNodeValueType::NAME);
-
-    // No registers saving because they are used only temporary
-    PushFuncCallArgs(node->left->left, info);
-
-    const char* funcName = NameTableGetName(info->allNamesTable, node->left->value.nameId);
-
-    IR_PUSH(IRNodeCreate(OP(CALL), IROperandLabelCreate(funcName), true));
-
-    // pushing ret value on stack
-    IR_PUSH(IRNodeCreate(OP(F_PUSH), IROperandRegCreate(IR_REG(XMM0))));
+    BuildFuncCall(node, info);
 })
 
 GENERATE_OPERATION_CMD(RETURN,
@@ -451,9 +420,7 @@ GENERATE_OPERATION_CMD(RETURN,
 {
     assert(info->ir);
 
-    Build(node->left, info);
-    
-    BuildFuncQuit(info);
+    BuildReturn(node->left, info);
 })
 
 #undef CALC_CHECK
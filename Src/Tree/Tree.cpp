@@ -2,6 +2,11 @@
 #include <ctype.h>
 #include <string.h>
 #include <math.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 #include "Tree.h"
 #include "Common/StringFuncs.h"
@@ -12,17 +17,19 @@
 
 //---------------------------------------------------------------------------------------
 
-static void TreeDtor     (TreeNode* node);
-
 static TreeErrors TreePrintPrefixFormat(const TreeNode* node, FILE* outStream,
                                         const NameTableType* nameTable);
 
 static TreeNode* TreeReadPrefixFormat(const char* const string, const char** stringEndPtr,
-                                                                    NameTableType* allNamesTable);
+                                                                    Tree* tree);
 
 static const char* TreeReadNodeValue(TreeNodeValue* value, TreeNodeValueType* valueType, 
                                       const char* string, NameTableType* allNamesTable);
 
+static size_t   TreeNodesCount      (const TreeNode* node);
+static uint32_t TreeBinaryFillNodes (const TreeNode* node, TreeBinaryNode* nodes, uint32_t* nodePos);
+static TreeErrors TreeBinaryVerify  (const char* data, const size_t dataSize);
+
 static void TreeGraphicDump(const TreeNode* node, FILE* outDotFile);
 static void DotFileCreateNodes(const TreeNode* node, FILE* outDotFile,
                                 const NameTableType* nameTable);
@@ -49,6 +56,9 @@ TreeErrors TreeCtor(Tree* tree)
 
     tree->root = nullptr;
 
+    if (TreeArenaCtor(&tree->arena) != TreeArenaErrors::NO_ERR)
+        return TreeErrors::MEM_ERR;
+
     TREE_CHECK(tree);
 
     return TreeErrors::NO_ERR;
@@ -60,8 +70,10 @@ void TreeDtor(Tree* tree)
 {
     assert(tree);
 
-    TreeDtor(tree->root);
-    tree->root = nullptr;
+    TreeArenaDtor(tree->arena);
+
+    tree->root  = nullptr;
+    tree->arena = nullptr;
 
     NameTableDtor(tree->allNamesTable);
     tree->allNamesTable = nullptr;
@@ -69,25 +81,13 @@ void TreeDtor(Tree* tree)
 
 //---------------------------------------------------------------------------------------
 
-static void TreeDtor(TreeNode* node)
-{
-    if (node == nullptr)
-        return;
-    
-    assert(node);
-
-    TreeDtor(node->left);
-    TreeDtor(node->right);
-
-    TreeNodeDtor(node);
-}
-
-//---------------------------------------------------------------------------------------
-
-TreeNode* TreeNodeCreate(TreeNodeValue value, TreeNodeValueType valueType,
+TreeNode* TreeNodeCreate(Tree* tree, TreeNodeValue value, TreeNodeValueType valueType,
                          TreeNode* left, TreeNode* right)
 {   
-    TreeNode* node  = (TreeNode*)calloc(1, sizeof(*node));
+    assert(tree);
+    assert(tree->arena);
+
+    TreeNode* node = TreeArenaAlloc(tree->arena);
     assert(node);
 
     node->left      = left;
@@ -104,7 +104,7 @@ void TreeNodeDeepDtor(TreeNode* node)
 {
     assert(node);
 
-    TreeDtor(node);
+    // arena nodes are freed all at once in TreeArenaDtor
 }
 
 void TreeNodeDtor(TreeNode* node)
@@ -112,8 +112,6 @@ void TreeNodeDtor(TreeNode* node)
     node->left         = nullptr;
     node->right        = nullptr;
     node->value.nameId  =      -1;
-
-    free(node);
 }
 
 //---------------------------------------------------------------------------------------
@@ -371,25 +369,25 @@ TreeNodeValue TreeCreateNameVal(size_t nameId)
 
 //---------------------------------------------------------------------------------------
 
-TreeNode* TreeNumNodeCreate(int value)
+TreeNode* TreeNumNodeCreate(Tree* tree, int value)
 {
     TreeNodeValue nodeVal = TreeCreateNumVal(value);
 
-    return TreeNodeCreate(nodeVal, TreeNodeValueType::NUM);
+    return TreeNodeCreate(tree, nodeVal, TreeNodeValueType::NUM);
 }
 
-TreeNode* TreeNameNodeCreate(size_t nameId)
+TreeNode* TreeNameNodeCreate(Tree* tree, size_t nameId)
 {
     TreeNodeValue nodeVal  = TreeCreateNameVal(nameId);
 
-    return TreeNodeCreate(nodeVal, TreeNodeValueType::NAME);
+    return TreeNodeCreate(tree, nodeVal, TreeNodeValueType::NAME);
 }
 
-TreeNode* TreeStringLiteralNodeCreate(size_t literalId)
+TreeNode* TreeStringLiteralNodeCreate(Tree* tree, size_t literalId)
 {
     TreeNodeValue nodeVal  = TreeCreateNameVal(literalId);
 
-    return TreeNodeCreate(nodeVal, TreeNodeValueType::STRING_LITERAL);
+    return TreeNodeCreate(tree, nodeVal, TreeNodeValueType::STRING_LITERAL);
 }
 
 //---------------------------------------------------------------------------------------
@@ -464,7 +462,7 @@ TreeErrors TreeReadPrefixFormat(Tree* tree, FILE* inStream)
     
     NameTableCtor(&tree->allNamesTable);
 
-    tree->root = TreeReadPrefixFormat(inputTree, &inputTreeEndPtr, tree->allNamesTable);
+    tree->root = TreeReadPrefixFormat(inputTree, &inputTreeEndPtr, tree);
 
     free(inputTree);
 
@@ -474,9 +472,10 @@ TreeErrors TreeReadPrefixFormat(Tree* tree, FILE* inStream)
 //---------------------------------------------------------------------------------------
 
 static TreeNode* TreeReadPrefixFormat(const char* const string, const char** stringEndPtr,
-                                                                    NameTableType* allNamesTable)
+                                                                    Tree* tree)
 {
     assert(string);
+    assert(tree);
 
     const char* stringPtr = string;
 
@@ -486,9 +485,9 @@ static TreeNode* TreeReadPrefixFormat(const char* const string, const char** str
     stringPtr++;
     if (symbol != '(') //skipping nils
     {
-        int shift = 0;
-        sscanf(stringPtr, "%*s%n", &shift);
-        stringPtr += shift;
+        stringPtr = SkipSymbolsWhileStatement(stringPtr, isspace);
+        while (*stringPtr != '\0' && !isspace(*stringPtr))
+            stringPtr++;
 
         *stringEndPtr = stringPtr;
         return nullptr;
@@ -497,13 +496,13 @@ static TreeNode* TreeReadPrefixFormat(const char* const string, const char** str
     TreeNodeValue value         = {};
     TreeNodeValueType valueType = {};
 
-    stringPtr = TreeReadNodeValue(&value, &valueType, stringPtr, allNamesTable);
-    TreeNode* node = TreeNodeCreate(value, valueType);
+    stringPtr = TreeReadNodeValue(&value, &valueType, stringPtr, tree->allNamesTable);
+    TreeNode* node = TreeNodeCreate(tree, value, valueType);
     
-    TreeNode* left  = TreeReadPrefixFormat(stringPtr, &stringPtr, allNamesTable);
+    TreeNode* left  = TreeReadPrefixFormat(stringPtr, &stringPtr, tree);
 
     TreeNode* right = nullptr;
-    right = TreeReadPrefixFormat(stringPtr, &stringPtr, allNamesTable);
+    right = TreeReadPrefixFormat(stringPtr, &stringPtr, tree);
 
     stringPtr = SkipSymbolsUntilStopChar(stringPtr, ')');
     ++stringPtr;
@@ -521,19 +520,17 @@ static const char* TreeReadNodeValue(TreeNodeValue* value, TreeNodeValueType* va
     assert(string);
     assert(valueType);
     
-    int readenValue = 0;
-    int shift = 0;
-    int scanResult = sscanf(string, "%d%n\n", &readenValue, &shift);
+    // sscanf calls strlen on the whole rest of the tree, so reading would be quadratic
+    char* numEnd = nullptr;
+    long readenValue = strtol(string, &numEnd, 10);
 
-    if (scanResult != 0)
+    if (numEnd != string)
     {
-        value->num = readenValue;
+        value->num = (int)readenValue;
         *valueType = TreeNodeValueType::NUM;
-        return string + shift;
+        return numEnd;
     }
 
-    shift = 0;
-
     static const size_t      maxInputStringSize  = 1024;
     static char  inputString[maxInputStringSize] =  "";
 
@@ -563,9 +560,17 @@ static const char* TreeReadNodeValue(TreeNodeValue* value, TreeNodeValueType* va
         return stringPtr;
     }
 
-    sscanf(string, "%s%n", inputString, &shift);
+    stringPtr = SkipSymbolsWhileStatement(string, isspace);
+
+    size_t inputStringPos = 0;
+    while (*stringPtr != '\0' && !isspace(*stringPtr))
+    {
+        assert(inputStringPos + 1 < maxInputStringSize);
+
+        inputString[inputStringPos++] = *stringPtr++;
+    }
+    inputString[inputStringPos] = '\0';
 
-    stringPtr = string + shift;
     assert(isspace(*stringPtr));
 
     int operationId = TreeOperationGetId(inputString);
@@ -601,6 +606,263 @@ static const char* TreeReadNodeValue(TreeNodeValue* value, TreeNodeValueType* va
     return stringPtr;
 }
 
+//---------------------------------------------------------------------------------------
+
+// Binary format layout (everything is written with one fwrite):
+// TreeBinaryHeader | TreeBinaryNode[nodesCount] | uint32_t nameOffsets[namesCount] | strings
+// Nodes are stored in prefix order, so children always have bigger ids than parents.
+
+TreeErrors TreePrintBinaryFormat(const Tree* tree, FILE* outStream)
+{
+    assert(tree);
+    assert(tree->allNamesTable);
+    assert(outStream);
+
+    const NameTableType* nameTable = tree->allNamesTable;
+
+    size_t nodesCount  = TreeNodesCount(tree->root);
+    size_t stringsSize = 0;
+    for (size_t i = 0; i < nameTable->size; ++i)
+        stringsSize += strlen(nameTable->data[i].name) + 1;
+
+    size_t nodesShift   = sizeof(TreeBinaryHeader);
+    size_t offsetsShift = nodesShift   + nodesCount       * sizeof(TreeBinaryNode);
+    size_t stringsShift = offsetsShift + nameTable->size  * sizeof(uint32_t);
+    size_t dataSize     = stringsShift + stringsSize;
+
+    char* data = (char*)calloc(dataSize, 1);
+    if (data == nullptr)
+        return TreeErrors::MEM_ERR;
+
+    TreeBinaryHeader* header = (TreeBinaryHeader*)data;
+    memcpy(header->magic, TreeBinaryMagic, sizeof(TreeBinaryMagic));
+    header->version     = TreeBinaryVersion;
+    header->nodesCount  = (uint32_t)nodesCount;
+    header->namesCount  = (uint32_t)nameTable->size;
+    header->stringsSize = (uint32_t)stringsSize;
+
+    uint32_t nodePos = 0;
+    header->rootId   = TreeBinaryFillNodes(tree->root, (TreeBinaryNode*)(data + nodesShift), &nodePos);
+    assert(nodePos == nodesCount);
+
+    uint32_t* nameOffsets = (uint32_t*)(data + offsetsShift);
+    char*     strings     = data + stringsShift;
+    size_t    stringsPos  = 0;
+    for (size_t i = 0; i < nameTable->size; ++i)
+    {
+        size_t nameLength = strlen(nameTable->data[i].name) + 1;
+        
+        nameOffsets[i] = (uint32_t)stringsPos;
+        memcpy(strings + stringsPos, nameTable->data[i].name, nameLength);
+        stringsPos += nameLength;
+    }
+
+    size_t written = fwrite(data, 1, dataSize, outStream);
+    free(data);
+
+    if (written != dataSize)
+        return TreeErrors::MEM_ERR;
+
+    return TreeErrors::NO_ERR;
+}
+
+//---------------------------------------------------------------------------------------
+
+TreeErrors TreeReadBinaryFormat(Tree* tree, FILE* inStream)
+{
+    assert(tree);
+    assert(inStream);
+
+    int fd = fileno(inStream);
+
+    struct stat fileInfo = {};
+    if (fstat(fd, &fileInfo) != 0 || fileInfo.st_size <= 0)
+        return TreeErrors::READING_ERR;
+
+    size_t dataSize = (size_t)fileInfo.st_size;
+    void*  mapped   = mmap(nullptr, dataSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapped == MAP_FAILED)
+        return TreeErrors::READING_ERR;
+
+    const char* data = (const char*)mapped;
+
+    TreeErrors err = TreeBinaryVerify(data, dataSize);
+    if (err != TreeErrors::NO_ERR)
+    {
+        munmap(mapped, dataSize);
+        return err;
+    }
+
+    const TreeBinaryHeader* header = (const TreeBinaryHeader*)data;
+
+    size_t nodesShift   = sizeof(TreeBinaryHeader);
+    size_t offsetsShift = nodesShift   + header->nodesCount * sizeof(TreeBinaryNode);
+    size_t stringsShift = offsetsShift + header->namesCount * sizeof(uint32_t);
+
+    const TreeBinaryNode* binNodes    = (const TreeBinaryNode*)(data + nodesShift);
+    const uint32_t*       nameOffsets = (const uint32_t*)     (data + offsetsShift);
+    const char*           strings     = data + stringsShift;
+
+    NameTableCtor(&tree->allNamesTable);
+    for (uint32_t i = 0; i < header->namesCount; ++i)
+    {
+        Name pushName = {};
+        NameCtor(&pushName, strings + nameOffsets[i], nullptr, 0, IRRegister::NO_REG);
+
+        NameTablePush(tree->allNamesTable, pushName);
+    }
+
+    TreeNode** nodes = (TreeNode**)calloc(header->nodesCount + 1, sizeof(*nodes));
+    assert(nodes);
+
+    // children have bigger ids, so building from the end links them at once
+    for (uint32_t i = header->nodesCount; i > 0; --i)
+    {
+        const TreeBinaryNode* binNode = binNodes + i - 1;
+
+        TreeNodeValue value = {};
+        if (binNode->valueType == (uint32_t)TreeNodeValueType::OPERATION)
+            value = TreeCreateOpVal((TreeOperationId)binNode->value);
+        else if (binNode->valueType == (uint32_t)TreeNodeValueType::NUM)
+            value = TreeCreateNumVal(binNode->value);
+        else
+            value = TreeCreateNameVal((size_t)binNode->value);
+
+        TreeNode* left  = binNode->left  == TreeBinaryNil ? nullptr : nodes[binNode->left];
+        TreeNode* right = binNode->right == TreeBinaryNil ? nullptr : nodes[binNode->right];
+
+        nodes[i - 1] = TreeNodeCreate(tree, value, (TreeNodeValueType)binNode->valueType,
+                                      left, right);
+    }
+
+    tree->root = header->rootId == TreeBinaryNil ? nullptr : nodes[header->rootId];
+
+    free(nodes);
+    munmap(mapped, dataSize);
+
+    return TreeErrors::NO_ERR;
+}
+
+//---------------------------------------------------------------------------------------
+
+bool TreeIsBinaryFormat(FILE* inStream)
+{
+    assert(inStream);
+
+    char magic[sizeof(TreeBinaryMagic)] = {};
+
+    // pread doesn't move stream position, so text reading still works after the check
+    ssize_t readBytes = pread(fileno(inStream), magic, sizeof(magic), 0);
+    if (readBytes != (ssize_t)sizeof(magic))
+        return false;
+
+    return memcmp(magic, TreeBinaryMagic, sizeof(TreeBinaryMagic)) == 0;
+}
+
+TreeErrors TreeRead(Tree* tree, FILE* inStream)
+{
+    assert(tree);
+    assert(inStream);
+
+    if (TreeIsBinaryFormat(inStream))
+        return TreeReadBinaryFormat(tree, inStream);
+
+    return TreeReadPrefixFormat(tree, inStream);
+}
+
+//---------------------------------------------------------------------------------------
+
+static size_t TreeNodesCount(const TreeNode* node)
+{
+    if (node == nullptr)
+        return 0;
+
+    return 1 + TreeNodesCount(node->left) + TreeNodesCount(node->right);
+}
+
+static uint32_t TreeBinaryFillNodes(const TreeNode* node, TreeBinaryNode* nodes, uint32_t* nodePos)
+{
+    assert(nodes);
+    assert(nodePos);
+
+    if (node == nullptr)
+        return TreeBinaryNil;
+
+    uint32_t nodeId = *nodePos;
+    (*nodePos)++;
+
+    TreeBinaryNode* binNode = nodes + nodeId;
+    binNode->valueType = (uint32_t)node->valueType;
+
+    if (node->valueType == TreeNodeValueType::OPERATION)
+        binNode->value = (int32_t)node->value.operation;
+    else if (node->valueType == TreeNodeValueType::NUM)
+        binNode->value = node->value.num;
+    else
+        binNode->value = (int32_t)node->value.nameId;
+
+    binNode->left  = TreeBinaryFillNodes(node->left,  nodes, nodePos);
+    binNode->right = TreeBinaryFillNodes(node->right, nodes, nodePos);
+
+    return nodeId;
+}
+
+static TreeErrors TreeBinaryVerify(const char* data, const size_t dataSize)
+{
+    assert(data);
+
+    if (dataSize < sizeof(TreeBinaryHeader))
+        return TreeErrors::READING_ERR;
+
+    const TreeBinaryHeader* header = (const TreeBinaryHeader*)data;
+
+    if (memcmp(header->magic, TreeBinaryMagic, sizeof(TreeBinaryMagic)) != 0 ||
+        header->version != TreeBinaryVersion)
+        return TreeErrors::READING_ERR;
+
+    size_t nodesShift   = sizeof(TreeBinaryHeader);
+    size_t offsetsShift = nodesShift   + (size_t)header->nodesCount * sizeof(TreeBinaryNode);
+    size_t stringsShift = offsetsShift + (size_t)header->namesCount * sizeof(uint32_t);
+
+    if (stringsShift + header->stringsSize != dataSize)
+        return TreeErrors::READING_ERR;
+
+    if (header->stringsSize > 0 && data[dataSize - 1] != '\0')
+        return TreeErrors::READING_ERR;
+
+    if (header->rootId != TreeBinaryNil && header->rootId >= header->nodesCount)
+        return TreeErrors::NODE_EDGES_ERR;
+
+    const TreeBinaryNode* nodes = (const TreeBinaryNode*)(data + nodesShift);
+    for (uint32_t i = 0; i < header->nodesCount; ++i)
+    {
+        if ((nodes[i].left  != TreeBinaryNil && 
+                (nodes[i].left  <= i || nodes[i].left  >= header->nodesCount)) ||
+            (nodes[i].right != TreeBinaryNil && 
+                (nodes[i].right <= i || nodes[i].right >= header->nodesCount)))
+            return TreeErrors::NODE_EDGES_ERR;
+
+        if (nodes[i].valueType > (uint32_t)TreeNodeValueType::STRING_LITERAL)
+            return TreeErrors::READING_ERR;
+
+        if ((nodes[i].valueType == (uint32_t)TreeNodeValueType::NAME ||
+             nodes[i].valueType == (uint32_t)TreeNodeValueType::STRING_LITERAL) &&
+            (nodes[i].value < 0 || (uint32_t)nodes[i].value >= header->namesCount))
+            return TreeErrors::VARIABLE_NAME_ERR;
+    }
+
+    const uint32_t* nameOffsets = (const uint32_t*)(data + offsetsShift);
+    for (uint32_t i = 0; i < header->namesCount; ++i)
+    {
+        if (nameOffsets[i] >= header->stringsSize)
+            return TreeErrors::VARIABLE_NAME_ERR;
+    }
+
+    return TreeErrors::NO_ERR;
+}
+
+//---------------------------------------------------------------------------------------
+
 void TreeNodeSetEdges(TreeNode* node, TreeNode* left, TreeNode* right)
 {
     assert(node);
@@ -10,7 +10,9 @@
 // Еще вариант хранить в дереве строчки а потом создавать нужную таблицу имен в бекенд с нужными данными
 
 #include <stdio.h>
+#include <stdint.h>
 #include "NameTable/NameTable.h"
+#include "TreeArena.h"
 
 #define GENERATE_OPERATION_CMD(NAME, ...) NAME, 
 
@@ -50,6 +52,8 @@ struct Tree
     TreeNode* root;
 
     NameTableType* allNamesTable;
+
+    TreeArena* arena;   ///< owns all nodes of the tree
 };
 
 enum class TreeErrors
@@ -75,9 +79,11 @@ enum class TreeErrors
 TreeErrors TreeCtor(Tree* tree);
 void TreeDtor(Tree* tree);
 
-TreeNode* TreeNodeCreate(TreeNodeValue value, TreeNodeValueType valueType,
+/// @brief Node is allocated in the arena of the tree and is freed in TreeDtor
+TreeNode* TreeNodeCreate(Tree* tree, TreeNodeValue value, TreeNodeValueType valueType,
                              TreeNode* left  = nullptr, TreeNode* right = nullptr);
 
+/// @brief Unlinks removed node. Memory is owned by the tree arena, so nothing is freed
 void TreeNodeDtor(TreeNode* node);
 void TreeNodeDeepDtor(TreeNode* node);
 
@@ -88,9 +94,9 @@ TreeNodeValue TreeCreateNumVal  (int value);
 TreeNodeValue TreeCreateOpVal   (TreeOperationId operationId);
 TreeNodeValue TreeCreateNameVal (size_t nameId);
 
-TreeNode* TreeNumNodeCreate             (int value);
-TreeNode* TreeNameNodeCreate            (size_t nameId);
-TreeNode* TreeStringLiteralNodeCreate   (size_t literalId);
+TreeNode* TreeNumNodeCreate             (Tree* tree, int value);
+TreeNode* TreeNameNodeCreate            (Tree* tree, size_t nameId);
+TreeNode* TreeStringLiteralNodeCreate   (Tree* tree, size_t literalId);
 
 #define TREE_TEXT_DUMP(tree) TreeTextDump((tree), __FILE__, __func__, __LINE__)
 
@@ -112,6 +118,44 @@ TreeErrors TreePrintPrefixFormat(const Tree* tree, FILE* outStream);
 
 TreeErrors TreeReadPrefixFormat(Tree* tree, FILE* inStream = stdin);
 
+//-------------Binary format-----------
+
+static const char     TreeBinaryMagic[8] = {'A', 'S', 'T', '5', '7', 'B', 'I', 'N'};
+static const uint32_t TreeBinaryVersion  = 1;
+static const uint32_t TreeBinaryNil      = UINT32_MAX;
+
+struct TreeBinaryHeader
+{
+    char     magic[sizeof(TreeBinaryMagic)];
+    uint32_t version;
+
+    uint32_t nodesCount;
+    uint32_t namesCount;
+    uint32_t stringsSize;
+
+    uint32_t rootId;
+    uint32_t reserved;
+};
+
+struct TreeBinaryNode
+{
+    int32_t  value;     /// < num, nameId or operation id depending on valueType
+    uint32_t valueType;
+
+    uint32_t left;      /// < child id in nodes array or TreeBinaryNil
+    uint32_t right;
+};
+
+TreeErrors TreePrintBinaryFormat(const Tree* tree, FILE* outStream);
+
+/// @brief loads tree from the binary format using mmap, inStream has to be a regular file
+TreeErrors TreeReadBinaryFormat(Tree* tree, FILE* inStream);
+
+bool TreeIsBinaryFormat(FILE* inStream);
+
+/// @brief reads tree in binary or prefix text format detecting it by the magic header
+TreeErrors TreeRead(Tree* tree, FILE* inStream = stdin);
+
 //-------------Operations funcs-----------
 
 int  TreeOperationGetId(const char* string);
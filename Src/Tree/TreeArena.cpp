@@ -0,0 +1,106 @@
+#include <assert.h>
+#include <stdlib.h>
+
+#include "TreeArena.h"
+#include "Tree.h"
+
+static TreeArenaErrors TreeArenaAddBlock(TreeArena* arena);
+
+//---------------------------------------------------------------------------------------
+
+TreeArenaErrors TreeArenaCtor(TreeArena** arena)
+{
+    assert(arena);
+
+    *arena = (TreeArena*)calloc(1, sizeof(**arena));
+    if (*arena == nullptr)
+        return TreeArenaErrors::MEM_ERR;
+
+    return TreeArenaErrors::NO_ERR;
+}
+
+void TreeArenaDtor(TreeArena* arena)
+{
+    if (arena == nullptr)
+        return;
+
+    for (size_t i = 0; i < arena->blocksCount; ++i)
+        free(arena->blocks[i]);
+
+    free(arena->blocks);
+
+    free(arena);
+}
+
+//---------------------------------------------------------------------------------------
+
+TreeNode* TreeArenaAlloc(TreeArena* arena)
+{
+    assert(arena);
+
+    size_t posInBlock = arena->nodesCount % TreeArenaBlockSize;
+
+    if (posInBlock == 0 && TreeArenaAddBlock(arena) != TreeArenaErrors::NO_ERR)
+        return nullptr;
+
+    TreeNode* node = arena->blocks[arena->blocksCount - 1] + posInBlock;
+    arena->nodesCount++;
+
+    return node;
+}
+
+static TreeArenaErrors TreeArenaAddBlock(TreeArena* arena)
+{
+    assert(arena);
+
+    if (arena->blocksCount == arena->blocksCapacity)
+    {
+        size_t newCapacity = arena->blocksCapacity == 0 ? 16 : arena->blocksCapacity * 2;
+        
+        TreeNode** newBlocks = (TreeNode**)realloc(arena->blocks, newCapacity * sizeof(*newBlocks));
+        if (newBlocks == nullptr)
+            return TreeArenaErrors::MEM_ERR;
+
+        arena->blocks         = newBlocks;
+        arena->blocksCapacity = newCapacity;
+    }
+
+    TreeNode* block = (TreeNode*)calloc(TreeArenaBlockSize, sizeof(*block));
+    if (block == nullptr)
+        return TreeArenaErrors::MEM_ERR;
+
+    arena->blocks[arena->blocksCount] = block;
+    arena->blocksCount++;
+
+    return TreeArenaErrors::NO_ERR;
+}
+
+//---------------------------------------------------------------------------------------
+
+uint32_t TreeArenaGetNodeId(const TreeArena* arena, const TreeNode* node)
+{
+    assert(arena);
+
+    if (node == nullptr)
+        return TreeArenaNoNode;
+
+    for (size_t i = 0; i < arena->blocksCount; ++i)
+    {
+        const TreeNode* block = arena->blocks[i];
+
+        if (block <= node && node < block + TreeArenaBlockSize)
+            return (uint32_t)(i * TreeArenaBlockSize + (size_t)(node - block));
+    }
+
+    return TreeArenaNoNode;
+}
+
+TreeNode* TreeArenaGetNode(const TreeArena* arena, uint32_t nodeId)
+{
+    assert(arena);
+
+    if (nodeId == TreeArenaNoNode || nodeId >= arena->nodesCount)
+        return nullptr;
+
+    return arena->blocks[nodeId / TreeArenaBlockSize] + nodeId % TreeArenaBlockSize;
+}
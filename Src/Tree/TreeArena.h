@@ -0,0 +1,39 @@
+#ifndef TREE_ARENA_H
+#define TREE_ARENA_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+struct TreeNode;
+
+static const size_t   TreeArenaBlockSize = 4096; /// < nodes in one block
+static const uint32_t TreeArenaNoNode    = UINT32_MAX;
+
+/// @brief Owns all nodes of the tree. Nodes are bump allocated in blocks, 
+/// so pointers to them stay valid and the whole tree is freed without walking it.
+struct TreeArena
+{
+    TreeNode** blocks;
+    size_t     blocksCount;
+    size_t     blocksCapacity;
+
+    size_t     nodesCount;
+};
+
+enum class TreeArenaErrors
+{
+    NO_ERR,
+
+    MEM_ERR,
+};
+
+TreeArenaErrors TreeArenaCtor(TreeArena** arena);
+void            TreeArenaDtor(TreeArena*  arena);
+
+TreeNode* TreeArenaAlloc(TreeArena* arena);
+
+/// @brief 32-bit ids of nodes, can be stored instead of pointers in compact structures
+uint32_t  TreeArenaGetNodeId(const TreeArena* arena, const TreeNode* node);
+TreeNode* TreeArenaGetNode  (const TreeArena* arena, uint32_t nodeId);
+
+#endif
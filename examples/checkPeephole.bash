@@ -0,0 +1,42 @@
+#!/bin/bash
+
+# Compiles examples with -S and fails if asm still has a move right back:
+#   MOVAPS x, y
+#   MOVAPS y, x
+
+compiler=./bin/compile57
+programs="factorial.txt FactorialTimeTest.txt KvadratkaTimeTest.txt"
+
+failed=0
+
+for program in $programs; do
+    if ! $compiler $program bin/check.bin -S > /dev/null 2>&1; then
+        echo "$program: compilation failed"
+        failed=1
+        continue
+    fi
+
+    pairs=$(awk '$1 == "MOVAPS" && prevDest != "" && $2 == prevSrc "," && $3 == prevDest {
+                     print "\t" NR - 1 ": MOVAPS " prevDest ", " prevSrc "; MOVAPS " $2 " " $3
+                 }
+                 {
+                     if ($1 == "MOVAPS") { prevDest = $2; sub(",", "", prevDest); prevSrc = $3 }
+                     else                { prevDest = "" }
+                 }' $program.s)
+
+    if [ -n "$pairs" ]; then
+        echo "$program: redundant move back"
+        echo "$pairs"
+        failed=1
+    fi
+
+    rm -f $program.s
+done
+
+rm -f bin/check.bin
+
+if [ $failed -eq 0 ]; then
+    echo "OK"
+fi
+
+exit $failed
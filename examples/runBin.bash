@@ -9,9 +9,9 @@ fi
 
 ./bin/preprocessor $input_file bin/after_processing.txt
 
-./bin/frontEnd bin/after_processing.txt bin/ParseTree.txt
+./bin/frontEnd bin/after_processing.txt bin/ParseTree.txt -b
 
-./bin/middleEnd bin/ParseTree.txt bin/SimplifiedTree.txt
+./bin/middleEnd bin/ParseTree.txt bin/SimplifiedTree.txt -b
 
 ./bin/backEnd bin/SimplifiedTree.txt bin/Out.bin
 